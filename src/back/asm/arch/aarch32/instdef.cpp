@@ -1,5 +1,6 @@
 #include "back/asm/arch/aarch32/instdef.h"
 
+#include <cstdint>
 #include <cassert>
 
 #include "utils/strprint.h"
@@ -44,6 +45,28 @@ const char *kShiftOp[] = {
   "", "lsl", "lsr", "asr", "ror",
 };
 
+// check if operand is stack pointer or frame pointer
+bool IsFrameReg(const OprPtr &opr) {
+  if (!opr->IsReg() || opr->IsVirtual()) return false;
+  using RegName = AArch32Reg::RegName;
+  auto name = static_cast<AArch32Reg *>(opr.get())->name();
+  return name == RegName::SP || name == RegName::R11;
+}
+
+// check if operand is a valid <imm8m> literal
+bool IsValidImm8m(const OprPtr &opr) {
+  if (!opr->IsImm()) return false;
+  std::uint32_t imm = static_cast<AArch32Imm *>(opr.get())->val();
+  for (int i = 0; i < 16; ++i) {
+    // perform circular shift 2i bits
+    std::uint32_t cur = (i << 1) & 0b11111;
+    cur = (imm << cur) | (imm >> ((-cur) & 0b11111));
+    // check if is valid
+    if (!(cur & ~0xff)) return true;
+  }
+  return false;
+}
+
 std::ostream &operator<<(std::ostream &os, AArch32Reg::RegName name) {
   os << kRegNames[static_cast<int>(name)];
   return os;
@@ -103,6 +126,32 @@ void AArch32Slot::Dump(std::ostream &os) const {
   os << '[' << base_ << ", #" << offset_ << ']';
 }
 
+bool AArch32Inst::IsRematerializable() const {
+  if (shift_op_ != ShiftOp::NOP) return false;
+  switch (opcode_) {
+    case OpCode::MOV: {
+      const auto &opr = oprs()[0].value();
+      return opr->IsImm() || IsFrameReg(opr);
+    }
+    case OpCode::MOVW: case OpCode::MOVT: case OpCode::MVN: {
+      const auto &opr = oprs()[0].value();
+      return opr->IsImm() || opr->IsLabel();
+    }
+    case OpCode::LDR: return oprs()[0].value()->IsLabel();
+    case OpCode::LEA: {
+      const auto &ptr = oprs()[0].value(), &ofs = oprs()[1].value();
+      return (ptr->IsLabel() || ptr->IsSlot()) && ofs->IsImm();
+    }
+    case OpCode::ADD: case OpCode::SUB: {
+      // offset calculation of frame address, which must not require
+      // any other temporary registers after immediate normalization
+      const auto &base = oprs()[0].value(), &ofs = oprs()[1].value();
+      return (base == dest() || IsFrameReg(base)) && IsValidImm8m(ofs);
+    }
+    default: return false;
+  }
+}
+
 void AArch32Inst::Dump(std::ostream &os) const {
   using OpCode = AArch32Inst::OpCode;
   if (opcode_ == OpCode::LABEL) {
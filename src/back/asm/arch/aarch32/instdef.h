@@ -238,6 +238,7 @@ class AArch32Inst : public InstBase {
   bool IsMove() const override { return opcode_ == OpCode::MOV; }
   bool IsLabel() const override { return opcode_ == OpCode::LABEL; }
   bool IsCall() const override { return opcode_ == OpCode::BL; }
+  bool IsRematerializable() const override;
   void Dump(std::ostream &os) const override;
 
   // setters
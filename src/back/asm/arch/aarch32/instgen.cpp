@@ -3,7 +3,7 @@
 #include <cmath>
 
 #include "opt/helper/cast.h"
-#include "opt/helper/blkiter.h"
+#include "opt/helper/cfg.h"
 
 #include "xstl/guard.h"
 
@@ -382,7 +382,7 @@ OprPtr AArch32InstGen::GenerateOn(FunctionSSA &ssa) {
   if (ssa.is_decl()) return label;
   // enter a new function
   auto func = EnterFunction(label, GetLinkType(ssa.link()));
-  ssa.set_metadata(label);
+  SetOpr(ssa, label);
   // generate arguments
   args_.clear();
   for (std::size_t i = 0; i < ssa.args().size(); ++i) {
@@ -401,11 +401,11 @@ OprPtr AArch32InstGen::GenerateOn(FunctionSSA &ssa) {
   }
   // generate label of blocks
   for (const auto &i : ssa) {
-    i.value()->set_metadata(label_fact_.GetLabel());
+    SetOpr(*i.value(), label_fact_.GetLabel());
   }
-  // generate all blocks in BFS order
-  auto entry = SSACast<BlockSSA>(ssa.entry().get());
-  for (const auto &i : BFSTraverse(entry)) GenerateCode(*i);
+  // generate all blocks in layout order
+  CFG cfg(&ssa);
+  for (const auto &i : cfg.layout()) GenerateCode(*cfg.block(i));
   // update optimization level
   if (!opt_level_) opt_level_ = GetSuggestedOptLevel();
   return label;
@@ -448,7 +448,7 @@ OprPtr AArch32InstGen::GenerateOn(AllocaSSA &ssa) {
 
 OprPtr AArch32InstGen::GenerateOn(BlockSSA &ssa) {
   // generate label
-  assert(ssa.metadata().has_value());
+  assert(HasOpr(ssa));
   PushInst(OpCode::LABEL, GetOpr(ssa));
   // generate instructions
   for (const auto &i : ssa.insts()) GenerateCode(i);
@@ -581,3 +581,11 @@ SlotAllocator AArch32InstGen::GetSlotAllocator() {
     return AllocNextSlot(func_label, 4);
   });
 }
+
+MoveGenerator AArch32InstGen::GetMoveGenerator() {
+  return MoveGenerator([this] { return GetVReg(); },
+                       [](const OprPtr &dest, const OprPtr &src) {
+                         return std::make_shared<AArch32Inst>(OpCode::MOV,
+                                                              dest, src);
+                       });
+}
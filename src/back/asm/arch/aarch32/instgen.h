@@ -49,6 +49,8 @@ class AArch32InstGen : public InstGenBase {
   void Reset();
   // get stack slot allocator for register allocation
   SlotAllocator GetSlotAllocator();
+  // get move instruction generator for register allocation
+  MoveGenerator GetMoveGenerator();
 
   // get an architecture register
   const OprPtr &GetReg(AArch32Reg::RegName name) const {
@@ -36,7 +36,7 @@ class InstSchedulingPass : public PassInterface {
         case OpCode::AND: case OpCode::ORR: case OpCode::EOR:
         case OpCode::LSL: case OpCode::LSR: case OpCode::ASR:
         case OpCode::CLZ: case OpCode::SXTB: case OpCode::UXTB: {
-          preds_.insert({i, {}});
+          AddInst(i);
           for (const auto &opr : inst->oprs()) {
             AddPred(i, opr.value());
             UpdateDef(opr.value(), i);
@@ -48,7 +48,7 @@ class InstSchedulingPass : public PassInterface {
         }
         case OpCode::LDR: case OpCode::LDRB: {
           // special handling for load instructions
-          preds_.insert({i, {}});
+          AddInst(i);
           // memory address
           AddPred(i, inst->oprs()[0].value());
           UpdateDef(inst->oprs()[0].value(), i);
@@ -61,7 +61,7 @@ class InstSchedulingPass : public PassInterface {
         }
         case OpCode::STR: case OpCode::STRB: {
           // special handling for store instructions
-          preds_.insert({i, {}});
+          AddInst(i);
           // memory address & value
           for (const auto &opr : inst->oprs()) {
             AddPred(i, opr.value());
@@ -133,6 +133,13 @@ class InstSchedulingPass : public PassInterface {
     last_store_ = nullptr;
     preds_.clear();
     remaining_.clear();
+    orders_.clear();
+  }
+
+  // add a new instruction to dependency graph
+  void AddInst(const InstPtr &inst) {
+    preds_.insert({inst, {}});
+    orders_.insert({inst, orders_.size()});
   }
 
   void AddPred(const InstPtr &inst, const OprPtr &val) {
@@ -242,6 +249,13 @@ class InstSchedulingPass : public PassInterface {
     return it->second;
   }
 
+  // get original order of the specific instruction
+  std::size_t GetOrder(const InstPtr &inst) const {
+    auto it = orders_.find(inst);
+    assert(it != orders_.end());
+    return it->second;
+  }
+
   // perform list schedule
   InstSet ListSchedule() {
     constexpr std::size_t kMaxCycle = 13;
@@ -261,10 +275,14 @@ class InstSchedulingPass : public PassInterface {
       }
     }
     // initialize worklist
+    // instructions with the same remaining cycle are picked in their
+    // original order, so that the result does not depend on addresses
     std::vector<InstQueue> worklist;
     worklist.resize(kMaxCycle,
                     InstQueue([this](const InstPtr &l, const InstPtr &r) {
-                      return GetRemaining(l) < GetRemaining(r);
+                      auto rem_l = GetRemaining(l), rem_r = GetRemaining(r);
+                      if (rem_l != rem_r) return rem_l < rem_r;
+                      return GetOrder(l) > GetOrder(r);
                     }));
     std::size_t inst_count = 0;
     for (const auto &[i, c] : count) {
@@ -313,6 +331,7 @@ class InstSchedulingPass : public PassInterface {
   InstPtr last_store_;
   InstMap<std::unordered_set<InstPtr>> preds_;
   InstMap<std::size_t> remaining_;
+  InstMap<std::size_t> orders_;
 };
 
 }  // namespace mimic::back::asmgen::aarch32
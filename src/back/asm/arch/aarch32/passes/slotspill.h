@@ -1,10 +1,13 @@
 #ifndef MIMIC_BACK_ASM_ARCH_AARCH32_PASSES_SLOTSPILL_H_
 #define MIMIC_BACK_ASM_ARCH_AARCH32_PASSES_SLOTSPILL_H_
 
+#include <utility>
 #include <cstdint>
+#include <cstddef>
 #include <cassert>
 
 #include "back/asm/mir/pass.h"
+#include "back/asm/mir/passes/regalloc.h"
 #include "back/asm/arch/aarch32/instdef.h"
 #include "back/asm/arch/aarch32/instgen.h"
 
@@ -14,19 +17,34 @@ namespace mimic::back::asmgen::aarch32 {
   this pass will:
   1.  apply the allocation results of virtual registers
   2.  add loads/stores for spilled virtual registers
+  3.  rematerialize spilled constants and addresses at their uses
 */
 class SlotSpillingPass : public PassInterface {
  public:
   SlotSpillingPass(AArch32InstGen &gen) : gen_(gen) {}
 
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    InitRematDefs(insts);
     for (auto it = insts.begin(); it != insts.end(); ++it) {
       auto inst = *it;
       // handle with source operands
       if (inst->IsMove() && inst->oprs()[0].value()->IsVirtual()) {
         auto &opr = inst->oprs()[0];
         const auto &alloc_to = GetAllocTo(opr.value());
-        if (alloc_to->IsSlot()) {
+        if (IsRemat(opr.value())) {
+          // recompute value to dest and remove current move
+          auto dest = inst->dest(), slot = OprPtr();
+          if (dest->IsVirtual()) dest = GetAllocTo(dest);
+          if (dest->IsSlot()) {
+            slot = dest;
+            dest = gen_.GetReg(RegName::R12);
+          }
+          InsertRemat(insts, it, opr.value(), dest);
+          it = --insts.erase(it);
+          inst = *it;
+          if (slot) InsertStore(insts, it, slot, dest);
+        }
+        else if (alloc_to->IsSlot()) {
           // insert load to dest and remove current move
           InsertLoad(insts, it, alloc_to, inst->dest());
           it = --insts.erase(it);
@@ -38,6 +56,11 @@ class SlotSpillingPass : public PassInterface {
         }
       }
       else if (!inst->IsMove()) {
+        // there are only two temporary registers for spilled operands
+        if (GetSpilledCount(inst) > 2) {
+          it = SplitMls(insts, it);
+          inst = *it;
+        }
         auto reg_mask = GetRegMask(inst);
         for (auto &&i : inst->oprs()) {
           if (!i.value()->IsVirtual()) continue;
@@ -47,7 +70,12 @@ class SlotSpillingPass : public PassInterface {
           }
           else {
             auto dest = SelectTempReg(reg_mask);
-            InsertLoad(insts, it, alloc_to, dest);
+            if (IsRemat(i.value())) {
+              InsertRemat(insts, it, i.value(), dest);
+            }
+            else {
+              InsertLoad(insts, it, alloc_to, dest);
+            }
             i.set_value(dest);
           }
         }
@@ -83,6 +111,31 @@ class SlotSpillingPass : public PassInterface {
     return mask;
   }
 
+  std::size_t GetSpilledCount(const InstPtr &inst) {
+    std::size_t count = 0;
+    for (const auto &i : inst->oprs()) {
+      const auto &opr = i.value();
+      if (opr->IsVirtual() && GetAllocTo(opr)->IsSlot()) ++count;
+    }
+    return count;
+  }
+
+  // split 'mls d, a, b, c' into 'mul r12, a, b' and 'sub d, c, r12'
+  // returns the position of 'mul'
+  InstPtrList::iterator SplitMls(InstPtrList &insts,
+                                 InstPtrList::iterator pos) {
+    auto mls = static_cast<AArch32Inst *>(pos->get());
+    assert(mls->opcode() == OpCode::MLS);
+    const auto &oprs = mls->oprs();
+    auto r12 = gen_.GetReg(RegName::R12);
+    auto mul = std::make_shared<AArch32Inst>(
+        OpCode::MUL, r12, oprs[0].value(), oprs[1].value());
+    auto sub = std::make_shared<AArch32Inst>(OpCode::SUB, mls->dest(),
+                                             oprs[2].value(), r12);
+    *pos = std::move(sub);
+    return insts.insert(pos, std::move(mul));
+  }
+
   OprPtr SelectTempReg(std::uint32_t &reg_mask) {
     OprPtr temp;
     // try to use 'r12' first
@@ -98,6 +151,45 @@ class SlotSpillingPass : public PassInterface {
     return temp;
   }
 
+  // find out all spilled virtual registers that can be rematerialized,
+  // and remove their definitions
+  void InitRematDefs(InstPtrList &insts) {
+    remat_defs_ = GetRematDefs(insts);
+    for (auto it = remat_defs_.begin(); it != remat_defs_.end();) {
+      auto vreg = static_cast<const VirtRegOperand *>(it->first);
+      if (vreg->alloc_to()->IsSlot()) {
+        ++it;
+      }
+      else {
+        it = remat_defs_.erase(it);
+      }
+    }
+    insts.remove_if([this](const InstPtr &inst) {
+      const auto &dest = inst->dest();
+      return dest && remat_defs_.count(dest.get());
+    });
+  }
+
+  bool IsRemat(const OprPtr &vreg) {
+    return remat_defs_.count(vreg.get());
+  }
+
+  // insert definitions of a rematerializable virtual register before
+  // the specific position, and replace the virtual register with 'dest'
+  void InsertRemat(InstPtrList &insts, InstPtrList::iterator &pos,
+                   const OprPtr &vreg, const OprPtr &dest) {
+    assert(dest->IsReg() && !dest->IsVirtual());
+    for (const auto &def : remat_defs_[vreg.get()]) {
+      auto inst = std::make_shared<AArch32Inst>(
+          *static_cast<AArch32Inst *>(def.get()));
+      inst->set_dest(dest);
+      for (auto &&i : inst->oprs()) {
+        if (i.value() == vreg) i.set_value(dest);
+      }
+      pos = ++insts.insert(pos, inst);
+    }
+  }
+
   // insert a load instruction before the specific position
   void InsertLoad(InstPtrList &insts, InstPtrList::iterator &pos,
                   const OprPtr &slot, const OprPtr &dest) {
@@ -154,6 +246,8 @@ class SlotSpillingPass : public PassInterface {
   }
 
   AArch32InstGen &gen_;
+  // definitions of spilled virtual registers that can be rematerialized
+  RematDefs remat_defs_;
 };
 
 }  // namespace mimic::back::asmgen::aarch32
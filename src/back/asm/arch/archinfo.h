@@ -12,6 +12,16 @@
 
 namespace mimic::back::asmgen {
 
+// type of register allocator
+enum class RegAllocType {
+  // the default allocator of optimization level
+  Default,
+  LinearScan,
+  Binpacking,
+  GraphColoring,
+  IteratedCoalescing,
+};
+
 // architecture information
 // base class of all architecture information
 class ArchInfoBase {
@@ -23,7 +33,8 @@ class ArchInfoBase {
   // return instruction generator of current architecture
   virtual InstGenBase &GetInstGen() = 0;
   // return a list of required passes
-  virtual PassPtrList GetPassList(std::size_t opt_level) = 0;
+  virtual PassPtrList GetPassList(std::size_t opt_level,
+                                  RegAllocType reg_alloc) = 0;
 };
 
 // pointer to architecture information
@@ -2,14 +2,16 @@
 #define MIMIC_BACK_ASM_ARCH_INSTGEN_H_
 
 #include <ostream>
-#include <unordered_map>
+#include <list>
 #include <vector>
+#include <algorithm>
 #include <utility>
 #include <memory>
 #include <cstdint>
 #include <cassert>
 
 #include "mid/ssa.h"
+#include "mid/valuemap.h"
 #include "back/asm/mir/mir.h"
 #include "back/asm/mir/pass.h"
 
@@ -53,6 +55,11 @@ class InstGenBase {
     for (auto &&[label, info] : funcs_) pass->RunOn(label, info.insts);
   }
 
+  // set operand of SSA value if it has not been set
+  void TrySetOpr(const mid::Value &ssa, const OprPtr &opr) {
+    oprs_.TrySet(ssa, opr);
+  }
+
   // setters
   void set_parent(CodeGen *parent) { parent_ = parent; }
 
@@ -68,8 +75,9 @@ class InstGenBase {
     InstPtrList insts;
   };
 
-  // map of instruction sequence
-  using InstSeqMap = std::unordered_map<OprPtr, InstSeqInfo>;
+  // list of instruction sequences, in order of generation
+  // so that the output does not depend on addresses of labels
+  using InstSeqMap = std::list<std::pair<OprPtr, InstSeqInfo>>;
 
   // generate the specific SSA value
   void GenerateCode(mid::Value &ssa) {
@@ -83,15 +91,23 @@ class InstGenBase {
 
   // get operator pointer from SSA value
   const OprPtr &GetOpr(mid::Value &ssa) {
-    auto val = std::any_cast<OprPtr>(&ssa.metadata());
+    auto val = oprs_.Find(ssa);
     if (!val) {
       ssa.GenerateCode(*parent_);
-      val = std::any_cast<OprPtr>(&ssa.metadata());
+      val = oprs_.Find(ssa);
       assert(val);
     }
     return *val;
   }
 
+  // set operand of SSA value
+  void SetOpr(const mid::Value &ssa, const OprPtr &opr) {
+    oprs_.Set(ssa, opr);
+  }
+
+  // return true if operand of SSA value has been set
+  bool HasOpr(const mid::Value &ssa) const { return oprs_.Has(ssa); }
+
   // get operator pointer from SSA IR
   const OprPtr &GetOpr(const mid::SSAPtr &ssa) {
     return GetOpr(*ssa);
@@ -123,9 +139,10 @@ class InstGenBase {
  private:
   xstl::Guard EnterInstSeq(InstSeqMap &seqs, const OprPtr &label,
                            LinkageTypes link) {
-    auto [it, succ] = seqs.insert({label, {link}});
-    assert(succ);
-    static_cast<void>(succ);
+    assert(std::find_if(seqs.begin(), seqs.end(), [&label](auto &&seq) {
+             return seq.first == label;
+           }) == seqs.end());
+    auto it = seqs.insert(seqs.end(), {label, {link}});
     auto last_label = cur_label_;
     auto last_seq = cur_seq_;
     cur_label_ = &it->first;
@@ -137,6 +154,8 @@ class InstGenBase {
   }
 
   CodeGen *parent_;
+  // operands of SSA values
+  mid::ValueMap<OprPtr> oprs_;
   InstSeqMap funcs_, mems_;
   const OprPtr *cur_label_;
   InstSeqInfo *cur_seq_;
@@ -9,7 +9,9 @@
 #include "back/asm/mir/passes/movelim.h"
 #include "back/asm/arch/riscv32/passes/liveness.h"
 #include "back/asm/mir/passes/linearscan.h"
+#include "back/asm/mir/passes/binpacking.h"
 #include "back/asm/mir/passes/coloring.h"
+#include "back/asm/mir/passes/coalescing.h"
 #include "back/asm/arch/riscv32/passes/leaelim.h"
 #include "back/asm/arch/riscv32/passes/slotspill.h"
 #include "back/asm/arch/riscv32/passes/funcdeco.h"
@@ -41,7 +43,8 @@ class RISCV32ArchInfo : public ArchInfoBase {
     return inst_gen_;
   }
 
-  PassPtrList GetPassList(std::size_t opt_level) override {
+  PassPtrList GetPassList(std::size_t opt_level,
+                          RegAllocType ra_type) override {
     PassPtrList list;
     list.push_back(MakePass<BranchCombiningPass>(inst_gen_));
     list.push_back(MakePass<BranchEliminationPass>());
@@ -51,7 +54,7 @@ class RISCV32ArchInfo : public ArchInfoBase {
       list.push_back(MakePass<MovePropagationPass>());
       list.push_back(MakePass<MoveEliminatePass>());
     }
-    InitRegAlloc(opt_level, list);
+    InitRegAlloc(opt_level, ra_type, list);
     if (opt_level) {
       list.push_back(MakePass<LeaCombiningPass>(inst_gen_));
     }
@@ -108,21 +111,48 @@ class RISCV32ArchInfo : public ArchInfoBase {
     }
   }
 
-  void InitRegAlloc(std::size_t opt_level, PassPtrList &list) {
+  void InitRegAlloc(std::size_t opt_level, RegAllocType ra_type,
+                    PassPtrList &list) {
     using LIType = LivenessAnalysisPass::LivenessInfoType;
-    bool use_gc = opt_level >= 2;
+    if (ra_type == RegAllocType::Default) {
+      // select allocator by optimization level
+      if (opt_level >= 2) {
+        ra_type = RegAllocType::GraphColoring;
+      }
+      else if (opt_level) {
+        ra_type = RegAllocType::Binpacking;
+      }
+      else {
+        ra_type = RegAllocType::LinearScan;
+      }
+    }
     // create liveness analyzer
-    auto li_type = use_gc ? LIType::InterferenceGraph
-                          : LIType::LiveIntervals;
+    auto li_type = LIType::InterferenceGraph;
+    if (ra_type == RegAllocType::LinearScan) {
+      li_type = LIType::LiveIntervals;
+    }
+    else if (ra_type == RegAllocType::Binpacking) {
+      li_type = LIType::LiveRanges;
+    }
     auto la = MakePass<LivenessAnalysisPass>(li_type, IsTempReg, temp_regs_,
                                              temp_regs_with_ra_, regs_);
     // create register allocator
     RegAllocPtr reg_alloc;
-    if (use_gc) {
+    if (ra_type == RegAllocType::GraphColoring) {
       const auto &fig = la->func_if_graphs();
       auto gcra = MakePass<GraphColoringRegAllocPass>(fig);
       reg_alloc = std::move(gcra);
     }
+    else if (ra_type == RegAllocType::IteratedCoalescing) {
+      const auto &fig = la->func_if_graphs();
+      auto irc = MakePass<IteratedCoalescingRegAllocPass>(fig);
+      reg_alloc = std::move(irc);
+    }
+    else if (ra_type == RegAllocType::Binpacking) {
+      const auto &flr = la->func_live_ranges();
+      auto bpra = MakePass<BinpackingRegAllocPass>(flr);
+      reg_alloc = std::move(bpra);
+    }
     else {
       const auto &fli = la->func_live_intervals();
       auto lsra = MakePass<LinearScanRegAllocPass>(fli);
@@ -135,6 +165,7 @@ class RISCV32ArchInfo : public ArchInfoBase {
     reg_alloc->set_func_temp_reg_list(&la->func_temp_regs());
     reg_alloc->set_func_reg_list(&la->func_regs());
     reg_alloc->set_allocator(inst_gen_.GetSlotAllocator());
+    reg_alloc->set_move_gen(inst_gen_.GetMoveGenerator());
     reg_alloc->set_temp_checker(IsTempReg);
     // add to pass list
     list.push_back(std::move(la));
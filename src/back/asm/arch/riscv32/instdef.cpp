@@ -66,6 +66,21 @@ void DumpMemOpr(std::ostream &os, const OprPtr &opr) {
   }
 }
 
+// check if operand is stack pointer or frame pointer
+bool IsFrameReg(const OprPtr &opr) {
+  if (!opr->IsReg() || opr->IsVirtual()) return false;
+  using RegName = RISCV32Reg::RegName;
+  auto name = static_cast<RISCV32Reg *>(opr.get())->name();
+  return name == RegName::SP || name == RegName::FP;
+}
+
+// check if operand is an immediate that fits 'addi' after negation
+bool IsValidOfs(const OprPtr &opr) {
+  if (!opr->IsImm()) return false;
+  auto val = static_cast<RISCV32Imm *>(opr.get())->val();
+  return val > -2048 && val < 2048;
+}
+
 }  // namespace
 
 void RISCV32Reg::Dump(std::ostream &os) const {
@@ -90,6 +105,27 @@ void RISCV32Slot::Dump(std::ostream &os) const {
   os << offset_ << '(' << base_ << ')';
 }
 
+bool RISCV32Inst::IsRematerializable() const {
+  switch (opcode_) {
+    case OpCode::LI: case OpCode::MV: {
+      const auto &opr = oprs()[0].value();
+      return opr->IsImm() || IsFrameReg(opr);
+    }
+    case OpCode::LA: return true;
+    case OpCode::LEA: {
+      const auto &ptr = oprs()[0].value(), &ofs = oprs()[1].value();
+      return (ptr->IsLabel() || ptr->IsSlot()) && ofs->IsImm();
+    }
+    case OpCode::ADD: case OpCode::SUB: case OpCode::ADDI: {
+      // offset calculation of frame address, which must not require
+      // any other temporary registers after immediate normalization
+      const auto &base = oprs()[0].value(), &ofs = oprs()[1].value();
+      return (base == dest() || IsFrameReg(base)) && IsValidOfs(ofs);
+    }
+    default: return false;
+  }
+}
+
 void RISCV32Inst::Dump(std::ostream &os) const {
   using OpCode = RISCV32Inst::OpCode;
   if (opcode_ == OpCode::LABEL) {
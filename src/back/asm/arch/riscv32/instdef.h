@@ -215,6 +215,7 @@ class RISCV32Inst : public InstBase {
   bool IsMove() const override { return opcode_ == OpCode::MV; }
   bool IsLabel() const override { return opcode_ == OpCode::LABEL; }
   bool IsCall() const override { return opcode_ == OpCode::CALL; }
+  bool IsRematerializable() const override;
   void Dump(std::ostream &os) const override;
 
   // setters
@@ -3,7 +3,7 @@
 #include <cmath>
 
 #include "opt/helper/cast.h"
-#include "opt/helper/blkiter.h"
+#include "opt/helper/cfg.h"
 
 using namespace mimic::define;
 using namespace mimic::mid;
@@ -354,7 +354,7 @@ OprPtr RISCV32InstGen::GenerateOn(FunctionSSA &ssa) {
   if (ssa.is_decl()) return label;
   // enter a new function
   auto func = EnterFunction(label, GetLinkType(ssa.link()));
-  ssa.set_metadata(label);
+  SetOpr(ssa, label);
   // generate arguments
   args_.clear();
   for (std::size_t i = 0; i < ssa.args().size(); ++i) {
@@ -373,11 +373,11 @@ OprPtr RISCV32InstGen::GenerateOn(FunctionSSA &ssa) {
   }
   // generate label of blocks
   for (const auto &i : ssa) {
-    i.value()->set_metadata(label_fact_.GetLabel());
+    SetOpr(*i.value(), label_fact_.GetLabel());
   }
-  // generate all blocks in DFS order
-  auto entry = SSACast<BlockSSA>(ssa.entry().get());
-  for (const auto &i : DFSTraverse(entry)) GenerateCode(*i);
+  // generate all blocks in layout order
+  CFG cfg(&ssa);
+  for (const auto &i : cfg.layout()) GenerateCode(*cfg.block(i));
   return label;
 }
 
@@ -418,7 +418,7 @@ OprPtr RISCV32InstGen::GenerateOn(AllocaSSA &ssa) {
 
 OprPtr RISCV32InstGen::GenerateOn(BlockSSA &ssa) {
   // generate label
-  assert(ssa.metadata().has_value());
+  assert(HasOpr(ssa));
   PushInst(OpCode::LABEL, GetOpr(ssa));
   // generate instructions
   for (const auto &i : ssa.insts()) GenerateCode(i);
@@ -550,3 +550,11 @@ SlotAllocator RISCV32InstGen::GetSlotAllocator() {
     return AllocNextSlot(func_label, 4);
   });
 }
+
+MoveGenerator RISCV32InstGen::GetMoveGenerator() {
+  return MoveGenerator([this] { return GetVReg(); },
+                       [](const OprPtr &dest, const OprPtr &src) {
+                         return std::make_shared<RISCV32Inst>(OpCode::MV,
+                                                              dest, src);
+                       });
+}
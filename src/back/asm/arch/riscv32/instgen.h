@@ -47,6 +47,8 @@ class RISCV32InstGen : public InstGenBase {
   void Reset();
   // get stack slot allocator for register allocation
   SlotAllocator GetSlotAllocator();
+  // get move instruction generator for register allocation
+  MoveGenerator GetMoveGenerator();
 
   // get an architecture register
   const OprPtr &GetReg(RISCV32Reg::RegName name) const {
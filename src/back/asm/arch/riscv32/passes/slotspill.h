@@ -5,6 +5,7 @@
 #include <cassert>
 
 #include "back/asm/mir/pass.h"
+#include "back/asm/mir/passes/regalloc.h"
 #include "back/asm/arch/riscv32/instdef.h"
 #include "back/asm/arch/riscv32/instgen.h"
 
@@ -14,19 +15,34 @@ namespace mimic::back::asmgen::riscv32 {
   this pass will:
   1.  apply the allocation results of virtual registers
   2.  add loads/stores for spilled virtual registers
+  3.  rematerialize spilled constants and addresses at their uses
 */
 class SlotSpillingPass : public PassInterface {
  public:
   SlotSpillingPass(RISCV32InstGen &gen) : gen_(gen) {}
 
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    InitRematDefs(insts);
     for (auto it = insts.begin(); it != insts.end(); ++it) {
       auto inst = *it;
       // handle with source operands
       if (inst->IsMove() && inst->oprs()[0].value()->IsVirtual()) {
         auto &opr = inst->oprs()[0];
         const auto &alloc_to = GetAllocTo(opr.value());
-        if (alloc_to->IsSlot()) {
+        if (IsRemat(opr.value())) {
+          // recompute value to dest and remove current move
+          auto dest = inst->dest(), slot = OprPtr();
+          if (dest->IsVirtual()) dest = GetAllocTo(dest);
+          if (dest->IsSlot()) {
+            slot = dest;
+            dest = gen_.GetReg(RegName::T0);
+          }
+          InsertRemat(insts, it, opr.value(), dest);
+          it = --insts.erase(it);
+          inst = *it;
+          if (slot) InsertStore(insts, it, slot, dest);
+        }
+        else if (alloc_to->IsSlot()) {
           // insert load to dest and remove current move
           InsertLoad(insts, it, alloc_to, inst->dest());
           it = --insts.erase(it);
@@ -47,7 +63,12 @@ class SlotSpillingPass : public PassInterface {
           }
           else {
             auto dest = SelectTempReg(reg_mask);
-            InsertLoad(insts, it, alloc_to, dest);
+            if (IsRemat(i.value())) {
+              InsertRemat(insts, it, i.value(), dest);
+            }
+            else {
+              InsertLoad(insts, it, alloc_to, dest);
+            }
             i.set_value(dest);
           }
         }
@@ -97,6 +118,45 @@ class SlotSpillingPass : public PassInterface {
     return temp;
   }
 
+  // find out all spilled virtual registers that can be rematerialized,
+  // and remove their definitions
+  void InitRematDefs(InstPtrList &insts) {
+    remat_defs_ = GetRematDefs(insts);
+    for (auto it = remat_defs_.begin(); it != remat_defs_.end();) {
+      auto vreg = static_cast<const VirtRegOperand *>(it->first);
+      if (vreg->alloc_to()->IsSlot()) {
+        ++it;
+      }
+      else {
+        it = remat_defs_.erase(it);
+      }
+    }
+    insts.remove_if([this](const InstPtr &inst) {
+      const auto &dest = inst->dest();
+      return dest && remat_defs_.count(dest.get());
+    });
+  }
+
+  bool IsRemat(const OprPtr &vreg) {
+    return remat_defs_.count(vreg.get());
+  }
+
+  // insert definitions of a rematerializable virtual register before
+  // the specific position, and replace the virtual register with 'dest'
+  void InsertRemat(InstPtrList &insts, InstPtrList::iterator &pos,
+                   const OprPtr &vreg, const OprPtr &dest) {
+    assert(dest->IsReg() && !dest->IsVirtual());
+    for (const auto &def : remat_defs_[vreg.get()]) {
+      auto inst = std::make_shared<RISCV32Inst>(
+          *static_cast<RISCV32Inst *>(def.get()));
+      inst->set_dest(dest);
+      for (auto &&i : inst->oprs()) {
+        if (i.value() == vreg) i.set_value(dest);
+      }
+      pos = ++insts.insert(pos, inst);
+    }
+  }
+
   // insert a load instruction before the specific position
   void InsertLoad(InstPtrList &insts, InstPtrList::iterator &pos,
                   const OprPtr &slot, const OprPtr &dest) {
@@ -153,6 +213,8 @@ class SlotSpillingPass : public PassInterface {
   }
 
   RISCV32InstGen &gen_;
+  // definitions of spilled virtual registers that can be rematerialized
+  RematDefs remat_defs_;
 };
 
 }  // namespace mimic::back::asmgen::riscv32
@@ -1,12 +1,25 @@
 #include "back/asm/generator.h"
 
+#include <string>
+#include <typeinfo>
+#include <cstdlib>
+#include <cxxabi.h>
+
 using namespace mimic::mid;
 using namespace mimic::back::asmgen;
+using namespace mimic::utils;
 
 namespace {
 
-void SetOpr(Value &ssa, const OprPtr &opr) {
-  if (!ssa.metadata().has_value()) ssa.set_metadata(opr);
+// get name of the specific pass, without namespace qualifiers
+std::string GetPassName(const PassInterface &pass) {
+  auto mangled = typeid(pass).name();
+  int status;
+  auto demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+  std::string name = status ? mangled : demangled;
+  std::free(demangled);
+  auto pos = name.rfind("::");
+  return pos == std::string::npos ? name : name.substr(pos + 2);
 }
 
 }  // namespace
@@ -99,15 +112,26 @@ void AsmCodeGen::GenerateOn(UndefSSA &ssa) {
   SetOpr(ssa, arch_info_->GetInstGen().GenerateOn(ssa));
 }
 
-void AsmCodeGen::Dump(std::ostream &os) const {
+void AsmCodeGen::RunPasses() {
   auto &inst_gen = arch_info_->GetInstGen();
-  // run passes
-  auto passes = arch_info_->GetPassList(opt_level_);
+  auto passes = arch_info_->GetPassList(opt_level_, reg_alloc_);
   for (const auto &pass : passes) {
-    inst_gen.RunPass(pass);
+    if (time_report_) {
+      Timer timer;
+      timer.Start();
+      inst_gen.RunPass(pass);
+      timer.Stop();
+      time_report_->AddTime("machine passes", GetPassName(*pass),
+                            timer.elapsed());
+    }
+    else {
+      inst_gen.RunPass(pass);
+    }
   }
-  // dump instructions
-  inst_gen.Dump(os);
+}
+
+void AsmCodeGen::Dump(std::ostream &os) const {
+  arch_info_->GetInstGen().Dump(os);
 }
 
 bool AsmCodeGen::SetTargetArch(std::string_view arch_name) {
@@ -124,3 +148,25 @@ bool AsmCodeGen::SetTargetArch(std::string_view arch_name) {
 void AsmCodeGen::ShowAvaliableArchs(std::ostream &os) {
   ArchManager::ShowArchs(os);
 }
+
+bool AsmCodeGen::SetRegAlloc(std::string_view name) {
+  if (name.empty()) {
+    reg_alloc_ = RegAllocType::Default;
+  }
+  else if (name == "linear-scan") {
+    reg_alloc_ = RegAllocType::LinearScan;
+  }
+  else if (name == "binpacking") {
+    reg_alloc_ = RegAllocType::Binpacking;
+  }
+  else if (name == "coloring") {
+    reg_alloc_ = RegAllocType::GraphColoring;
+  }
+  else if (name == "irc") {
+    reg_alloc_ = RegAllocType::IteratedCoalescing;
+  }
+  else {
+    return false;
+  }
+  return true;
+}
@@ -6,13 +6,16 @@
 
 #include "back/codegen.h"
 #include "back/asm/arch/archinfo.h"
+#include "utils/timereport.h"
 
 namespace mimic::back::asmgen {
 
 // code generator for multi-architecture assembly
 class AsmCodeGen : public CodeGenInterface {
  public:
-  AsmCodeGen() : opt_level_(0) {}
+  AsmCodeGen()
+      : opt_level_(0), reg_alloc_(RegAllocType::Default),
+        time_report_(nullptr) {}
 
   void GenerateOn(mid::LoadSSA &ssa) override;
   void GenerateOn(mid::StoreSSA &ssa) override;
@@ -37,6 +40,7 @@ class AsmCodeGen : public CodeGenInterface {
   void GenerateOn(mid::SelectSSA &ssa) override;
   void GenerateOn(mid::UndefSSA &ssa) override;
 
+  void RunPasses() override;
   void Dump(std::ostream &os) const override;
 
   // set target architecture of assembly generator
@@ -44,15 +48,32 @@ class AsmCodeGen : public CodeGenInterface {
   bool SetTargetArch(std::string_view arch_name);
   // display all avaliable architectures
   void ShowAvaliableArchs(std::ostream &os);
+  // set register allocator by name ('linear-scan', 'coloring', 'irc'),
+  // empty name for the default allocator
+  // returns false if name is invalid
+  bool SetRegAlloc(std::string_view name);
 
   // setters
   void set_opt_level(std::size_t opt_level) { opt_level_ = opt_level; }
+  // set time report for recording time of passes, 'nullptr' to disable
+  void set_time_report(utils::TimeReport *time_report) {
+    time_report_ = time_report;
+  }
 
  private:
+  // set operand of SSA value if it has not been set
+  void SetOpr(mid::Value &ssa, const OprPtr &opr) {
+    arch_info_->GetInstGen().TrySetOpr(ssa, opr);
+  }
+
   // info of target architecture
   ArchInfoPtr arch_info_;
   // optimization level
   std::size_t opt_level_;
+  // type of register allocator
+  RegAllocType reg_alloc_;
+  // time report of passes
+  utils::TimeReport *time_report_;
 };
 
 }  // namespace mimic::back::asm
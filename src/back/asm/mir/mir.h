@@ -102,6 +102,10 @@ class InstBase {
   virtual bool IsLabel() const = 0;
   // check if is a call instruction
   virtual bool IsCall() const = 0;
+  // check if is an instruction that only computes a constant or an
+  // address from immediates, labels, stack slots, frame registers and
+  // its own destination, so that it can be recomputed anywhere
+  virtual bool IsRematerializable() const = 0;
   // dump instruction to output stream
   virtual void Dump(std::ostream &os) const = 0;
 
@@ -0,0 +1,446 @@
+#ifndef MIMIC_BACK_ASM_MIR_PASSES_BINPACKING_H_
+#define MIMIC_BACK_ASM_MIR_PASSES_BINPACKING_H_
+
+#include <map>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cstddef>
+#include <cassert>
+
+#include "back/asm/mir/passes/regalloc.h"
+
+namespace mimic::back::asmgen {
+
+/*
+  second-chance binpacking register allocator
+  reference: O. Traub, G. Holloway, M. D. Smith,
+             Quality and Speed in Linear-scan Register Allocation
+
+  registers are treated as bins, live ranges with lifetime holes are
+  packed into bins in order of their start positions, and ranges that
+  can not be packed are spilled to stack slots. after that, spilled
+  values get a second chance in each basic block they appear: if there
+  is a free register, a block-local virtual register will be created,
+  which is reloaded before its first use if the value is live-in, and
+  stored after its last definition if the value is live-out.
+*/
+class BinpackingRegAllocPass : public RegAllocatorBase {
+ public:
+  BinpackingRegAllocPass(const FuncLiveRanges &func_live_ranges)
+      : func_live_ranges_(func_live_ranges) {}
+
+  void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    auto it = func_live_ranges_.find(func_label);
+    assert(it != func_live_ranges_.end());
+    const auto &lr = it->second;
+    Reset(func_label, lr);
+    // perform allocation
+    PackRanges(lr);
+    SplitSpilledRanges(lr);
+    // apply to virtual registers
+    ApplyAllocation(func_label, lr, insts);
+  }
+
+ private:
+  // bin id of spilled values
+  static constexpr std::size_t kSpilled =
+      std::numeric_limits<std::size_t>::max();
+  // invalid position
+  static constexpr std::size_t kNoPos =
+      std::numeric_limits<std::size_t>::max();
+
+  // segments of live range
+  using Segments = std::vector<std::pair<std::size_t, std::size_t>>;
+
+  // register or stack slot that holds live ranges
+  struct Bin {
+    OprPtr opr;
+    bool is_temp;
+    // occupied segments, start position -> (end position, owner)
+    // segments are disjoint, except that the destination of a move may
+    // start at the end of the source
+    std::map<std::size_t, std::pair<std::size_t, std::size_t>> segs;
+  };
+
+  // block-local part of spilled value
+  struct Piece {
+    // index of block and id of spilled value
+    std::size_t block, id;
+    // live segment of piece, and position of the last definition
+    Segments segs;
+    std::size_t last_def;
+    bool can_alloc_temp, need_reload, need_store;
+    // cost of loads/stores that can be saved by this piece
+    double benefit;
+    // allocated bin
+    std::size_t bin;
+  };
+
+  // reset for next run
+  void Reset(const OprPtr &func_label, const LiveRanges &lr) {
+    bins_.clear();
+    for (const auto &i : GetTempRegList(func_label)) {
+      bins_.push_back({i, true, {}});
+    }
+    for (const auto &i : GetRegList(func_label)) {
+      bins_.push_back({i, false, {}});
+    }
+    reg_bins_.clear();
+    for (std::size_t i = 0; i < bins_.size(); ++i) {
+      reg_bins_.insert({bins_[i].opr.get(), i});
+    }
+    slot_bins_.clear();
+    vreg_ids_.clear();
+    for (std::size_t id = 0; id < lr.vregs.size(); ++id) {
+      vreg_ids_.insert({lr.vregs[id].get(), id});
+    }
+    allocs_.assign(lr.vregs.size(), kSpilled);
+    pieces_.clear();
+  }
+
+  // check if the specific segments can be put into bin
+  static bool IsFit(const Bin &bin, const Segments &segs) {
+    for (const auto &[start, end] : segs) {
+      auto it = bin.segs.upper_bound(end);
+      if (it != bin.segs.begin() && std::prev(it)->second.first >= start) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // get owners of segments in bin that overlap the specific segments
+  static std::vector<std::size_t> GetOverlaps(const Bin &bin,
+                                              const Segments &segs) {
+    std::vector<std::size_t> owners;
+    for (const auto &[start, end] : segs) {
+      auto it = bin.segs.upper_bound(start);
+      while (it != bin.segs.begin() && std::prev(it)->second.first >= start) {
+        --it;
+      }
+      for (; it != bin.segs.end() && it->first <= end; ++it) {
+        owners.push_back(it->second.second);
+      }
+    }
+    std::sort(owners.begin(), owners.end());
+    owners.erase(std::unique(owners.begin(), owners.end()), owners.end());
+    return owners;
+  }
+
+  // put segments into bin
+  static void AddToBin(Bin &bin, const Segments &segs, std::size_t owner) {
+    for (const auto &[start, end] : segs) {
+      bin.segs.insert({start, {end, owner}});
+    }
+  }
+
+  // remove segments from bin
+  static void RemoveFromBin(Bin &bin, const Segments &segs) {
+    for (const auto &seg : segs) bin.segs.erase(seg.first);
+  }
+
+  // find the first register bin that can hold the specific segments
+  std::size_t FindBin(const Segments &segs, bool can_alloc_temp) const {
+    for (std::size_t i = 0; i < bins_.size(); ++i) {
+      if ((can_alloc_temp || !bins_[i].is_temp) && IsFit(bins_[i], segs)) {
+        return i;
+      }
+    }
+    return kSpilled;
+  }
+
+  // get index of the block that contains the specific position
+  static std::size_t GetBlockIndex(const LiveRanges &lr, std::size_t pos) {
+    auto it = std::upper_bound(lr.blocks.begin(), lr.blocks.end(), pos,
+                               [](std::size_t pos, const auto &block) {
+                                 return pos < block.start_pos;
+                               });
+    assert(it != lr.blocks.begin());
+    return std::prev(it) - lr.blocks.begin();
+  }
+
+  // get the bin of the register that is copied to/from the specific
+  // value by the move at the start/end of its live range, in which case
+  // the move will be redundant if the value is put into that bin
+  std::size_t GetHintBin(const LiveRanges &lr, std::size_t id) {
+    const auto &range = lr.ranges[id];
+    const auto &vreg = lr.vregs[id];
+    auto start = range.segs.front().first;
+    auto end = range.segs.back().second;
+    // check the move at start position
+    const auto &first = lr.insts[start];
+    if (first->IsMove() && first->dest() == vreg) {
+      const auto &src = first->oprs()[0].value();
+      if (!src->IsVirtual()) {
+        auto it = reg_bins_.find(src.get());
+        if (it != reg_bins_.end()) return it->second;
+      }
+      else if (auto src_id = vreg_ids_[src.get()];
+               allocs_[src_id] != kSpilled) {
+        // source must be dead after the move
+        const auto &block = lr.blocks[GetBlockIndex(lr, start)];
+        if (start + 1 < block.end_pos || !block.live_out.Get(src_id)) {
+          return allocs_[src_id];
+        }
+      }
+    }
+    // check the move at end position
+    const auto &last = lr.insts[end];
+    if (last->IsMove() && last->oprs()[0].value() == vreg &&
+        !last->dest()->IsVirtual()) {
+      auto it = reg_bins_.find(last->dest().get());
+      if (it != reg_bins_.end()) return it->second;
+    }
+    return kSpilled;
+  }
+
+  // try to put the specific value into its hint bin
+  bool TryHintBin(const LiveRanges &lr, std::size_t id) {
+    const auto &range = lr.ranges[id];
+    auto bin = GetHintBin(lr, id);
+    if (bin == kSpilled || (!range.can_alloc_temp && bins_[bin].is_temp)) {
+      return false;
+    }
+    // ignore segment of the source that ends at the start position
+    auto &segs = bins_[bin].segs;
+    auto start = range.segs.front().first;
+    auto it = segs.upper_bound(start);
+    std::pair<std::size_t, std::pair<std::size_t, std::size_t>> src_seg;
+    bool has_src_seg = false;
+    if (it != segs.begin() && std::prev(it)->first < start &&
+        std::prev(it)->second.first == start) {
+      src_seg = *std::prev(it);
+      has_src_seg = true;
+      segs.erase(std::prev(it));
+    }
+    bool is_fit = IsFit(bins_[bin], range.segs);
+    if (has_src_seg) segs.insert(src_seg);
+    if (!is_fit) return false;
+    AddToBin(bins_[bin], range.segs, id);
+    allocs_[id] = bin;
+    return true;
+  }
+
+  // pack all live ranges into register bins in order of start positions
+  // when there is no free bin, values with lower spill weights will be
+  // evicted, and they can be put into other bins if possible
+  void PackRanges(const LiveRanges &lr) {
+    // get spill weights, which are spill costs divided by range sizes
+    std::vector<double> weights;
+    for (const auto &range : lr.ranges) {
+      std::size_t size = 0;
+      for (const auto &[start, end] : range.segs) size += end - start + 1;
+      weights.push_back(range.spill_cost / size);
+    }
+    // perform allocation
+    std::vector<std::size_t> ids(lr.ranges.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    std::stable_sort(ids.begin(), ids.end(),
+                     [&lr](std::size_t l, std::size_t r) {
+                       return lr.ranges[l].segs.front().first <
+                              lr.ranges[r].segs.front().first;
+                     });
+    for (const auto &id : ids) {
+      if (TryHintBin(lr, id)) continue;
+      const auto &range = lr.ranges[id];
+      auto bin = FindBin(range.segs, range.can_alloc_temp);
+      std::vector<std::size_t> evicted;
+      if (bin == kSpilled) {
+        // find the bin with the lowest weight of overlapped values
+        double min_weight = weights[id];
+        for (std::size_t i = 0; i < bins_.size(); ++i) {
+          if (!range.can_alloc_temp && bins_[i].is_temp) continue;
+          auto owners = GetOverlaps(bins_[i], range.segs);
+          double weight = 0;
+          for (const auto &o : owners) {
+            weight = std::max(weight, weights[o]);
+          }
+          if (weight < min_weight) {
+            min_weight = weight;
+            bin = i;
+            evicted = std::move(owners);
+          }
+        }
+        // evict overlapped values
+        for (const auto &o : evicted) {
+          RemoveFromBin(bins_[bin], lr.ranges[o].segs);
+          allocs_[o] = kSpilled;
+        }
+      }
+      if (bin == kSpilled) continue;
+      AddToBin(bins_[bin], range.segs, id);
+      allocs_[id] = bin;
+      // try to put evicted values into other bins
+      for (const auto &o : evicted) {
+        const auto &r = lr.ranges[o];
+        allocs_[o] = FindBin(r.segs, r.can_alloc_temp);
+        if (allocs_[o] != kSpilled) AddToBin(bins_[allocs_[o]], r.segs, o);
+      }
+    }
+  }
+
+  // give spilled values a second chance in each block
+  void SplitSpilledRanges(const LiveRanges &lr) {
+    // number of occurrences, first/last positions and positions of the
+    // last definitions of spilled values in current block
+    std::vector<std::size_t> count(lr.vregs.size()), first(count.size());
+    std::vector<std::size_t> last(count.size()), logged;
+    std::vector<std::size_t> last_def(count.size(), kNoPos);
+    auto log_pos = [&](const OprPtr &opr, std::size_t pos, bool is_def) {
+      auto id = vreg_ids_[opr.get()];
+      if (allocs_[id] != kSpilled) return;
+      if (!count[id]++) {
+        first[id] = pos;
+        logged.push_back(id);
+      }
+      last[id] = pos;
+      if (is_def) last_def[id] = pos;
+    };
+    // create pieces
+    for (std::size_t b = 0; b < lr.blocks.size(); ++b) {
+      const auto &block = lr.blocks[b];
+      for (auto pos = block.start_pos; pos < block.end_pos; ++pos) {
+        const auto &inst = lr.insts[pos];
+        for (const auto &opr : inst->oprs()) {
+          if (opr.value()->IsVirtual()) log_pos(opr.value(), pos, false);
+        }
+        const auto &dest = inst->dest();
+        if (dest && dest->IsVirtual()) log_pos(dest, pos, true);
+      }
+      for (const auto &id : logged) {
+        // reload before the first use if value is live-in,
+        // and store after the last definition if value is live-out
+        bool need_reload = block.live_in.Get(id);
+        bool need_store = last_def[id] != kNoPos && block.live_out.Get(id);
+        // check if piece can reduce the number of loads/stores
+        // definitions of rematerializable values are left unchanged,
+        // so that they can be recomputed instead of being stored
+        std::size_t overhead = need_reload + need_store;
+        bool is_remat_def = lr.ranges[id].can_remat &&
+                            last_def[id] != kNoPos;
+        if (count[id] > overhead && !is_remat_def) {
+          auto start = first[id], end = last[id];
+          pieces_.push_back({b, id, {{start, end}}, last_def[id],
+                             !lr.IsTempClobbered(start, end, need_reload),
+                             need_reload, need_store,
+                             (count[id] - overhead) * block.cost,
+                             kSpilled});
+        }
+        count[id] = 0;
+        last_def[id] = kNoPos;
+      }
+      logged.clear();
+    }
+    // allocate registers for pieces in descending order of benefit
+    std::vector<std::size_t> order(pieces_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [this](std::size_t l, std::size_t r) {
+                       return pieces_[l].benefit > pieces_[r].benefit;
+                     });
+    for (const auto &i : order) {
+      auto &piece = pieces_[i];
+      piece.bin = FindBin(piece.segs, piece.can_alloc_temp);
+      if (piece.bin != kSpilled) {
+        AddToBin(bins_[piece.bin], piece.segs, piece.id);
+      }
+    }
+  }
+
+  // allocate a stack slot for the specific spilled value
+  const OprPtr &AllocateSlot(const OprPtr &func_label,
+                             const Segments &segs, std::size_t id) {
+    for (auto &&bin : slot_bins_) {
+      if (IsFit(bin, segs)) {
+        AddToBin(bin, segs, id);
+        return bin.opr;
+      }
+    }
+    slot_bins_.push_back({allocator().AllocateSlot(func_label), false, {}});
+    AddToBin(slot_bins_.back(), segs, id);
+    return slot_bins_.back().opr;
+  }
+
+  // apply allocation results, rewrite instructions of pieces
+  void ApplyAllocation(const OprPtr &func_label, const LiveRanges &lr,
+                       InstPtrList &insts) {
+    // get iterators of all positions
+    std::vector<InstPtrList::iterator> pos_its;
+    pos_its.reserve(lr.insts.size());
+    for (auto it = insts.begin(); it != insts.end(); ++it) {
+      if (pos_its.size() < lr.insts.size() &&
+          it->get() == lr.insts[pos_its.size()]) {
+        pos_its.push_back(it);
+      }
+    }
+    assert(pos_its.size() == lr.insts.size());
+    // allocate registers/slots for all values
+    for (std::size_t id = 0; id < lr.vregs.size(); ++id) {
+      if (allocs_[id] != kSpilled) {
+        AllocateVRegTo(lr.vregs[id], bins_[allocs_[id]].opr);
+      }
+      else {
+        const auto &segs = lr.ranges[id].segs;
+        AllocateVRegTo(lr.vregs[id], AllocateSlot(func_label, segs, id));
+      }
+    }
+    // handle pieces, which are in order of blocks
+    std::unordered_map<const OperandBase *, OprPtr> piece_vregs;
+    for (auto it = pieces_.begin(); it != pieces_.end();) {
+      const auto &block = lr.blocks[it->block];
+      piece_vregs.clear();
+      for (; it != pieces_.end() && &lr.blocks[it->block] == &block; ++it) {
+        if (it->bin == kSpilled) continue;
+        // create virtual register for piece
+        const auto &vreg = lr.vregs[it->id];
+        auto piece = move_gen().GetVReg();
+        AllocateVRegTo(piece, bins_[it->bin].opr);
+        piece_vregs.insert({vreg.get(), piece});
+        // insert reload/store
+        if (it->need_reload) {
+          insts.insert(pos_its[it->segs.front().first],
+                       move_gen().GetMove(piece, vreg));
+        }
+        if (it->need_store) {
+          insts.insert(std::next(pos_its[it->last_def]),
+                       move_gen().GetMove(vreg, piece));
+        }
+      }
+      if (piece_vregs.empty()) continue;
+      // replace spilled values with pieces
+      for (auto pos = block.start_pos; pos < block.end_pos; ++pos) {
+        const auto &inst = *pos_its[pos];
+        for (auto &&opr : inst->oprs()) {
+          auto pv = piece_vregs.find(opr.value().get());
+          if (pv != piece_vregs.end()) opr.set_value(pv->second);
+        }
+        if (inst->dest()) {
+          auto pv = piece_vregs.find(inst->dest().get());
+          if (pv != piece_vregs.end()) inst->set_dest(pv->second);
+        }
+      }
+    }
+  }
+
+  // reference of live ranges
+  const FuncLiveRanges &func_live_ranges_;
+  // dense ids of all virtual registers
+  std::unordered_map<const OperandBase *, std::size_t> vreg_ids_;
+  // register bins and stack slot bins
+  std::vector<Bin> bins_, slot_bins_;
+  // indices of register bins
+  std::unordered_map<const OperandBase *, std::size_t> reg_bins_;
+  // allocated bins of all values
+  std::vector<std::size_t> allocs_;
+  // pieces of spilled values
+  std::vector<Piece> pieces_;
+};
+
+}  // namespace mimic::back::asmgen
+
+#endif  // MIMIC_BACK_ASM_MIR_PASSES_BINPACKING_H_
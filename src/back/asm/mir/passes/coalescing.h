@@ -0,0 +1,549 @@
+#ifndef MIMIC_BACK_ASM_MIR_PASSES_COALESCING_H_
+#define MIMIC_BACK_ASM_MIR_PASSES_COALESCING_H_
+
+#include <algorithm>
+#include <vector>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+
+#include "back/asm/mir/passes/regalloc.h"
+
+namespace mimic::back::asmgen {
+
+/*
+  iterated register coalescing allocator
+  reference: L. George, A. W. Appel. Iterated Register Coalescing
+
+  move pairs in 'suggest_same' of interference graph are coalesced
+  conservatively by Briggs' and George's tests, nodes to be spilled
+  are chosen by spill costs weighted by loop depth. spilled nodes are
+  removed from graph directly, since the slot spilling pass will load
+  and store them with reserved registers.
+*/
+class IteratedCoalescingRegAllocPass : public RegAllocatorBase {
+ public:
+  IteratedCoalescingRegAllocPass(const FuncIfGraphs &func_if_graphs)
+      : func_if_graphs_(func_if_graphs) {}
+
+  void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    InitColors(func_label);
+    Build(func_label);
+    MakeWorklist();
+    // simplify, coalesce, freeze and spill until all worklists are empty
+    for (;;) {
+      if (!simplify_list_.empty()) {
+        Simplify();
+      }
+      else if (!move_list_.empty()) {
+        Coalesce();
+      }
+      else if (!freeze_list_.empty()) {
+        Freeze();
+      }
+      else if (!spill_list_.empty()) {
+        SelectSpill();
+      }
+      else {
+        break;
+      }
+    }
+    AssignColors();
+    ApplyColors(func_label);
+  }
+
+ private:
+  // state of nodes
+  enum class NodeState {
+    // spilled before allocation
+    Removed,
+    // nodes that have not been put into any worklist
+    Initial,
+    // low-degree non-move-related nodes
+    Simplify,
+    // low-degree move-related nodes
+    Freeze,
+    // high-degree nodes
+    Spill,
+    // nodes that have been coalesced to another node
+    Coalesced,
+    // nodes removed from graph and pushed into stack
+    Selected,
+    // nodes successfully colored
+    Colored,
+    // nodes that can not be colored
+    Spilled,
+  };
+
+  // state of moves
+  enum class MoveState {
+    // moves enabled for possible coalescing
+    Worklist,
+    // moves not yet ready for coalescing
+    Active,
+    // moves that have been coalesced
+    Coalesced,
+    // moves whose source and destination interfere
+    Constrained,
+    // moves that will no longer be considered for coalescing
+    Frozen,
+  };
+
+  // set of indices, with constant time insertion and removal
+  class IndexSet {
+   public:
+    void Reset(std::size_t size) {
+      items_.clear();
+      pos_.assign(size, kNone);
+    }
+
+    void Insert(std::size_t i) {
+      assert(pos_[i] == kNone);
+      pos_[i] = items_.size();
+      items_.push_back(i);
+    }
+
+    void Remove(std::size_t i) {
+      auto pos = pos_[i];
+      assert(pos != kNone);
+      items_[pos] = items_.back();
+      pos_[items_[pos]] = pos;
+      items_.pop_back();
+      pos_[i] = kNone;
+    }
+
+    std::size_t Pop() {
+      auto i = items_.back();
+      Remove(i);
+      return i;
+    }
+
+    // getters
+    bool empty() const { return items_.empty(); }
+    const std::vector<std::size_t> &items() const { return items_; }
+
+   private:
+    static constexpr std::size_t kNone = static_cast<std::size_t>(-1);
+
+    std::vector<std::size_t> items_, pos_;
+  };
+
+  // color of nodes that are not colored
+  static constexpr std::size_t kNoColor = static_cast<std::size_t>(-1);
+
+  // get interference graph of the specific function
+  const IfGraph &GetIfGraph(const OprPtr &func_label) {
+    auto it = func_if_graphs_.find(func_label);
+    assert(it != func_if_graphs_.end());
+    return it->second;
+  }
+
+  // check if the specific virtual register is spilled
+  bool IsVRegSpilled(const OprPtr &vreg) {
+    auto ptr = static_cast<VirtRegOperand *>(vreg.get());
+    return ptr->alloc_to() && ptr->alloc_to()->IsSlot();
+  }
+
+  // initialize all colors of the specific function
+  void InitColors(const OprPtr &func_label) {
+    colors_.clear();
+    temp_colors_.clear();
+    reg_colors_.clear();
+    auto get_color_id = [this](const OprPtr &color) {
+      auto it = std::find(colors_.begin(), colors_.end(), color);
+      if (it != colors_.end()) return it - colors_.begin();
+      colors_.push_back(color);
+      return colors_.end() - colors_.begin() - 1;
+    };
+    for (const auto &i : GetTempRegList(func_label)) {
+      temp_colors_.push_back(get_color_id(i));
+    }
+    for (const auto &i : GetRegList(func_label)) {
+      reg_colors_.push_back(get_color_id(i));
+    }
+  }
+
+  // build internal status from interference graph
+  void Build(const OprPtr &func_label) {
+    // edges may be added when coalescing, so make a copy
+    graph_ = GetIfGraph(func_label);
+    auto size = graph_.size();
+    states_.assign(size, NodeState::Removed);
+    degrees_.assign(size, 0);
+    aliases_.resize(size);
+    can_alloc_temps_.resize(size);
+    spill_costs_.resize(size);
+    node_moves_.assign(size, {});
+    node_colors_.assign(size, kNoColor);
+    marks_.assign(size, 0);
+    mark_ = 0;
+    moves_.clear();
+    move_states_.clear();
+    select_stack_.clear();
+    // initialize nodes, spilled nodes are removed
+    for (std::size_t n = 0; n < size; ++n) {
+      const auto &info = graph_.node(n);
+      aliases_[n] = n;
+      can_alloc_temps_[n] = info.can_alloc_temp;
+      spill_costs_[n] = info.spill_cost;
+      if (!IsVRegSpilled(info.vreg)) states_[n] = NodeState::Initial;
+    }
+    // initialize degrees and moves
+    for (std::size_t n = 0; n < size; ++n) {
+      if (states_[n] == NodeState::Removed) continue;
+      const auto &info = graph_.node(n);
+      for (const auto &t : info.neighbours) {
+        if (states_[t] != NodeState::Removed) ++degrees_[n];
+      }
+      for (const auto &t : info.suggest_same) {
+        if (t < n || states_[t] == NodeState::Removed) continue;
+        node_moves_[n].push_back(moves_.size());
+        node_moves_[t].push_back(moves_.size());
+        moves_.push_back({n, t});
+        move_states_.push_back(MoveState::Worklist);
+      }
+    }
+    move_list_.Reset(moves_.size());
+    active_moves_.Reset(moves_.size());
+    for (std::size_t m = 0; m < moves_.size(); ++m) move_list_.Insert(m);
+  }
+
+  // put all nodes into the corresponding worklist
+  void MakeWorklist() {
+    simplify_list_.Reset(graph_.size());
+    freeze_list_.Reset(graph_.size());
+    spill_list_.Reset(graph_.size());
+    for (std::size_t n = 0; n < graph_.size(); ++n) {
+      if (states_[n] == NodeState::Removed) continue;
+      if (degrees_[n] >= GetColorCount(n)) {
+        SetState(n, NodeState::Spill);
+      }
+      else if (IsMoveRelated(n)) {
+        SetState(n, NodeState::Freeze);
+      }
+      else {
+        SetState(n, NodeState::Simplify);
+      }
+    }
+  }
+
+  // get the number of colors that can be used by the specific node
+  std::size_t GetColorCount(std::size_t n) const {
+    return reg_colors_.size() +
+           (can_alloc_temps_[n] ? temp_colors_.size() : 0);
+  }
+
+  // move node to the worklist of the specific state
+  void SetState(std::size_t n, NodeState state) {
+    if (auto list = GetWorklist(states_[n])) list->Remove(n);
+    states_[n] = state;
+    if (auto list = GetWorklist(state)) list->Insert(n);
+  }
+
+  // get worklist of the specific state, returns null if there is none
+  IndexSet *GetWorklist(NodeState state) {
+    switch (state) {
+      case NodeState::Simplify: return &simplify_list_;
+      case NodeState::Freeze: return &freeze_list_;
+      case NodeState::Spill: return &spill_list_;
+      default: return nullptr;
+    }
+  }
+
+  // call 'func' with all nodes adjacent to the specific node in the
+  // current graph, that is, nodes that are not selected or coalesced
+  template <typename Func>
+  void ForEachAdjacent(std::size_t n, Func func) {
+    for (const auto &t : graph_.node(n).neighbours) {
+      auto state = states_[t];
+      if (state == NodeState::Removed || state == NodeState::Selected ||
+          state == NodeState::Coalesced) {
+        continue;
+      }
+      func(t);
+    }
+  }
+
+  // check if the specific node is related to any available moves
+  bool IsMoveRelated(std::size_t n) const {
+    for (const auto &m : node_moves_[n]) {
+      auto state = move_states_[m];
+      if (state == MoveState::Worklist || state == MoveState::Active) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // get the representative node of the specific node
+  std::size_t GetAlias(std::size_t n) {
+    while (states_[n] == NodeState::Coalesced) n = aliases_[n];
+    return n;
+  }
+
+  // remove a low-degree node from graph
+  void Simplify() {
+    auto n = simplify_list_.Pop();
+    states_[n] = NodeState::Selected;
+    select_stack_.push_back(n);
+    ForEachAdjacent(n, [this](std::size_t t) { DecrementDegree(t); });
+  }
+
+  // decrement degree of the specific node
+  void DecrementDegree(std::size_t n) {
+    auto degree = degrees_[n]--;
+    if (degree != GetColorCount(n) || states_[n] != NodeState::Spill) {
+      return;
+    }
+    // node becomes low-degree, moves of itself and its neighbours
+    // may be able to coalesce now
+    EnableMoves(n);
+    ForEachAdjacent(n, [this](std::size_t t) { EnableMoves(t); });
+    SetState(n, IsMoveRelated(n) ? NodeState::Freeze : NodeState::Simplify);
+  }
+
+  // move all active moves of the specific node to worklist
+  void EnableMoves(std::size_t n) {
+    for (const auto &m : node_moves_[n]) {
+      if (move_states_[m] != MoveState::Active) continue;
+      active_moves_.Remove(m);
+      move_states_[m] = MoveState::Worklist;
+      move_list_.Insert(m);
+    }
+  }
+
+  // move node to simplify worklist if it's no longer move related
+  void AddWorklist(std::size_t n) {
+    if (states_[n] == NodeState::Freeze && !IsMoveRelated(n) &&
+        degrees_[n] < GetColorCount(n)) {
+      SetState(n, NodeState::Simplify);
+    }
+  }
+
+  // try to coalesce a move
+  void Coalesce() {
+    auto m = move_list_.Pop();
+    auto u = GetAlias(moves_[m].first), v = GetAlias(moves_[m].second);
+    if (u == v) {
+      move_states_[m] = MoveState::Coalesced;
+      AddWorklist(u);
+    }
+    else if (graph_.IsAdjacent(u, v)) {
+      move_states_[m] = MoveState::Constrained;
+      AddWorklist(u);
+      AddWorklist(v);
+    }
+    else if (CanCoalesce(u, v)) {
+      move_states_[m] = MoveState::Coalesced;
+      Combine(u, v);
+      AddWorklist(u);
+    }
+    else {
+      move_states_[m] = MoveState::Active;
+      active_moves_.Insert(m);
+    }
+  }
+
+  // check if two nodes can be coalesced conservatively
+  bool CanCoalesce(std::size_t u, std::size_t v) {
+    auto colors = can_alloc_temps_[v] ? GetColorCount(u)
+                                      : reg_colors_.size();
+    // George's test: all neighbours of 'v' are either low-degree or
+    // adjacent to 'u', only when the combined node has the same
+    // colors as 'u'
+    if (colors == GetColorCount(u)) {
+      bool ok = true;
+      ForEachAdjacent(v, [this, u, &ok](std::size_t t) {
+        if (degrees_[t] >= GetColorCount(t) && !graph_.IsAdjacent(t, u)) {
+          ok = false;
+        }
+      });
+      if (ok) return true;
+    }
+    // Briggs' test: combined node has fewer high-degree neighbours
+    // than colors
+    ++mark_;
+    std::size_t count = 0;
+    auto count_node = [this, &count](std::size_t t) {
+      if (marks_[t] == mark_) return;
+      marks_[t] = mark_;
+      if (degrees_[t] >= GetColorCount(t)) ++count;
+    };
+    ForEachAdjacent(u, count_node);
+    ForEachAdjacent(v, count_node);
+    return count < colors;
+  }
+
+  // combine node 'v' into node 'u'
+  void Combine(std::size_t u, std::size_t v) {
+    SetState(v, NodeState::Coalesced);
+    aliases_[v] = u;
+    auto &moves = node_moves_[u];
+    moves.insert(moves.end(), node_moves_[v].begin(), node_moves_[v].end());
+    can_alloc_temps_[u] = can_alloc_temps_[u] && can_alloc_temps_[v];
+    spill_costs_[u] += spill_costs_[v];
+    EnableMoves(v);
+    // move edges of 'v' to 'u'
+    ForEachAdjacent(v, [this, u](std::size_t t) {
+      if (graph_.AddEdge(t, u)) {
+        ++degrees_[u];
+      }
+      else {
+        DecrementDegree(t);
+      }
+    });
+    if (degrees_[u] >= GetColorCount(u) &&
+        states_[u] == NodeState::Freeze) {
+      SetState(u, NodeState::Spill);
+    }
+  }
+
+  // give up coalescing a low-degree move-related node
+  void Freeze() {
+    auto n = freeze_list_.items().back();
+    SetState(n, NodeState::Simplify);
+    FreezeMoves(n);
+  }
+
+  // freeze all moves of the specific node
+  void FreezeMoves(std::size_t u) {
+    for (const auto &m : node_moves_[u]) {
+      auto state = move_states_[m];
+      if (state == MoveState::Active) {
+        active_moves_.Remove(m);
+      }
+      else if (state == MoveState::Worklist) {
+        move_list_.Remove(m);
+      }
+      else {
+        continue;
+      }
+      move_states_[m] = MoveState::Frozen;
+      // get the other node of move
+      auto v = GetAlias(moves_[m].first);
+      if (v == GetAlias(u)) v = GetAlias(moves_[m].second);
+      AddWorklist(v);
+    }
+  }
+
+  // choose a high-degree node that is cheapest to spill
+  // and remove it from graph optimistically
+  void SelectSpill() {
+    const auto &items = spill_list_.items();
+    auto n = *std::min_element(
+        items.begin(), items.end(), [this](std::size_t l, std::size_t r) {
+          auto lc = spill_costs_[l] * degrees_[r];
+          auto rc = spill_costs_[r] * degrees_[l];
+          return lc < rc || (lc == rc && l < r);
+        });
+    SetState(n, NodeState::Simplify);
+    FreezeMoves(n);
+  }
+
+  // check if the specific color can be used by the specific node
+  bool IsColorAvaliable(std::size_t n, std::size_t color,
+                        const std::vector<bool> &used_colors) const {
+    if (used_colors[color]) return false;
+    return can_alloc_temps_[n] || !IsTempReg(colors_[color]);
+  }
+
+  // get color of the specific node, returns 'kNoColor' if failed
+  std::size_t GetNodeColor(std::size_t n,
+                           const std::vector<bool> &used_colors) {
+    // try to use colors of move related nodes
+    for (const auto &m : node_moves_[n]) {
+      auto t = GetAlias(moves_[m].first);
+      if (t == n) t = GetAlias(moves_[m].second);
+      if (states_[t] != NodeState::Colored) continue;
+      auto color = node_colors_[t];
+      if (IsColorAvaliable(n, color, used_colors)) return color;
+    }
+    // try to use temporary registers
+    if (can_alloc_temps_[n]) {
+      for (const auto &i : temp_colors_) {
+        if (!used_colors[i]) return i;
+      }
+    }
+    // try to use avaliable registers
+    for (const auto &i : reg_colors_) {
+      if (!used_colors[i]) return i;
+    }
+    return kNoColor;
+  }
+
+  // assign colors to all nodes in stack
+  void AssignColors() {
+    std::vector<bool> used_colors;
+    while (!select_stack_.empty()) {
+      auto n = select_stack_.back();
+      select_stack_.pop_back();
+      // get colors of all neighbours
+      used_colors.assign(colors_.size(), false);
+      for (const auto &t : graph_.node(n).neighbours) {
+        auto alias = GetAlias(t);
+        if (states_[alias] == NodeState::Colored) {
+          used_colors[node_colors_[alias]] = true;
+        }
+      }
+      // try to colorize
+      auto color = GetNodeColor(n, used_colors);
+      if (color == kNoColor) {
+        states_[n] = NodeState::Spilled;
+      }
+      else {
+        states_[n] = NodeState::Colored;
+        node_colors_[n] = color;
+      }
+    }
+  }
+
+  // allocate all virtual registers to registers or stack slots
+  void ApplyColors(const OprPtr &func_label) {
+    // coalesced nodes share the same stack slot
+    std::vector<OprPtr> slots(graph_.size());
+    for (std::size_t n = 0; n < graph_.size(); ++n) {
+      if (states_[n] == NodeState::Removed) continue;
+      auto alias = GetAlias(n);
+      const auto &vreg = graph_.node(n).vreg;
+      if (states_[alias] == NodeState::Colored) {
+        AllocateVRegTo(vreg, colors_[node_colors_[alias]]);
+      }
+      else {
+        assert(states_[alias] == NodeState::Spilled);
+        auto &slot = slots[alias];
+        if (!slot) slot = allocator().AllocateSlot(func_label);
+        AllocateVRegTo(vreg, slot);
+      }
+    }
+  }
+
+  // reference of interference graph
+  const FuncIfGraphs &func_if_graphs_;
+  // interference graph of current function
+  IfGraph graph_;
+  // all colors, and indices of colors in register lists
+  std::vector<OprPtr> colors_;
+  std::vector<std::size_t> temp_colors_, reg_colors_;
+  // information of all nodes
+  std::vector<NodeState> states_;
+  std::vector<std::size_t> degrees_, aliases_, node_colors_;
+  std::vector<bool> can_alloc_temps_;
+  std::vector<double> spill_costs_;
+  // indices of moves related to all nodes
+  std::vector<std::vector<std::size_t>> node_moves_;
+  // marks for counting nodes without duplication
+  std::vector<std::size_t> marks_;
+  std::size_t mark_;
+  // all moves (pairs of nodes) and their states
+  std::vector<std::pair<std::size_t, std::size_t>> moves_;
+  std::vector<MoveState> move_states_;
+  // worklists of nodes and moves
+  IndexSet simplify_list_, freeze_list_, spill_list_;
+  IndexSet move_list_, active_moves_;
+  // stack of nodes that removed from graph
+  std::vector<std::size_t> select_stack_;
+};
+
+}  // namespace mimic::back::asmgen
+
+#endif  // MIMIC_BACK_ASM_MIR_PASSES_COALESCING_H_
@@ -3,14 +3,11 @@
 
 #include <algorithm>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 #include <ostream>
 #include <cassert>
 #include <cstddef>
 
 #include "back/asm/mir/passes/regalloc.h"
-#include "utils/hashing.h"
 
 namespace mimic::back::asmgen {
 
@@ -21,40 +18,57 @@ namespace mimic::back::asmgen {
 class GraphColoringRegAllocPass : public RegAllocatorBase {
  public:
   GraphColoringRegAllocPass(const FuncIfGraphs &func_if_graphs)
-      : func_if_graphs_(func_if_graphs) {}
+      : func_if_graphs_(func_if_graphs), graph_(nullptr) {}
 
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
     InitRegListRef(func_label);
     // perform allocation
     RunAllocator(func_label);
     // apply colored nodes
-    for (const auto &[vreg, reg] : colored_nodes_) {
-      AllocateVRegTo(vreg, reg);
+    for (std::size_t node = 0; node < graph_->size(); ++node) {
+      if (node_colors_[node] == kNoColor) continue;
+      AllocateVRegTo(graph_->node(node).vreg, colors_[node_colors_[node]]);
     }
   }
 
  private:
-  struct NodeInfo {
-    OprPtr node;
-    std::size_t degree;
-  };
+  // color of uncolored nodes
+  static constexpr std::size_t kNoColor = static_cast<std::size_t>(-1);
 
   // initialize register list references
   void InitRegListRef(const OprPtr &func_label) {
     avaliable_temps_ = &GetTempRegList(func_label);
     avaliable_regs_ = &GetRegList(func_label);
+    // assign indices to all colors
+    colors_.clear();
+    temp_colors_.clear();
+    reg_colors_.clear();
+    for (const auto &i : *avaliable_temps_) {
+      temp_colors_.push_back(GetColorId(i));
+    }
+    for (const auto &i : *avaliable_regs_) {
+      reg_colors_.push_back(GetColorId(i));
+    }
+  }
+
+  // get index of the specific color
+  std::size_t GetColorId(const OprPtr &color) {
+    auto it = std::find(colors_.begin(), colors_.end(), color);
+    if (it != colors_.end()) return it - colors_.begin();
+    colors_.push_back(color);
+    return colors_.size() - 1;
   }
 
   // check if the specific node is spilled
-  bool IsNodeSpilled(const OprPtr &node) {
-    assert(node->IsVirtual());
-    auto vreg = static_cast<VirtRegOperand *>(node.get());
+  bool IsNodeSpilled(std::size_t node) {
+    auto vreg = static_cast<VirtRegOperand *>(graph_->node(node).vreg.get());
     return vreg->alloc_to() && vreg->alloc_to()->IsSlot();
   }
 
   // spill node to stack
-  void SpillNode(const OprPtr &func_label, const OprPtr &node) {
-    AllocateVRegTo(node, allocator().AllocateSlot(func_label));
+  void SpillNode(const OprPtr &func_label, std::size_t node) {
+    AllocateVRegTo(graph_->node(node).vreg,
+                   allocator().AllocateSlot(func_label));
   }
 
   // get interference graph of the specific function
@@ -64,29 +78,28 @@ class GraphColoringRegAllocPass : public RegAllocatorBase {
     return it->second;
   }
 
-  void PutMinDegToBack(std::vector<NodeInfo *> &nodes) {
+  void PutMinDegToBack(std::vector<std::size_t> &nodes) {
     if (nodes.size() <= 1) return;
     auto it = std::min_element(nodes.begin(), nodes.end(),
-                               [](const NodeInfo *n1, const NodeInfo *n2) {
-                                 return n1->degree < n2->degree;
+                               [this](std::size_t n1, std::size_t n2) {
+                                 return degrees_[n1] < degrees_[n2];
                                });
     std::swap(nodes.back(), *it);
   }
 
-  void RebuildNodeStack(const OprPtr &func_label) {
-    std::unordered_map<OprPtr, NodeInfo> all_nodes;
-    std::vector<NodeInfo *> candidate;
-    const auto &graph = GetIfGraph(func_label);
+  void RebuildNodeStack() {
+    std::vector<std::size_t> candidate;
     // initialize all candidate nodes
-    for (const auto &[node, info] : graph) {
+    degrees_.assign(graph_->size(), 0);
+    std::vector<bool> is_candidate(graph_->size());
+    for (std::size_t node = 0; node < graph_->size(); ++node) {
       if (!IsNodeSpilled(node)) {
         // add all unspilled nodes to candidate node list
-        std::size_t degree = 0;
-        for (const auto &n : info.neighbours) {
-          if (!IsNodeSpilled(n)) ++degree;
+        for (const auto &n : graph_->node(node).neighbours) {
+          if (!IsNodeSpilled(n)) ++degrees_[node];
         }
-        auto it = all_nodes.insert({node, {node, degree}}).first;
-        candidate.push_back(&it->second);
+        is_candidate[node] = true;
+        candidate.push_back(node);
       }
     }
     PutMinDegToBack(candidate);
@@ -94,19 +107,15 @@ class GraphColoringRegAllocPass : public RegAllocatorBase {
     nodes_.clear();
     while (!candidate.empty()) {
       // push the node with the minimum degree into stack
-      auto ni = candidate.back();
-      nodes_.push_back(ni->node);
+      auto node = candidate.back();
+      nodes_.push_back(node);
       // remove node from graph
       candidate.pop_back();
-      ni->degree = 0;
+      is_candidate[node] = false;
+      degrees_[node] = 0;
       // update degree of all its neighbours
-      auto it = graph.find(ni->node);
-      assert(it != graph.end());
-      for (const auto &n : it->second.neighbours) {
-        auto an_it = all_nodes.find(n);
-        if (an_it != all_nodes.end()) {
-          --an_it->second.degree;
-        }
+      for (const auto &n : graph_->node(node).neighbours) {
+        if (is_candidate[n]) --degrees_[n];
       }
       // update candidate node list
       PutMinDegToBack(candidate);
@@ -114,37 +123,36 @@ class GraphColoringRegAllocPass : public RegAllocatorBase {
   }
 
   // set color of the specific node
-  void SetNodeColor(const OprPtr &node, const OprPtr &color,
-                    std::unordered_set<OprPtr> &used_color) {
-    colored_nodes_[node] = color;
-    used_color.insert(color);
+  void SetNodeColor(std::size_t node, std::size_t color,
+                    std::vector<bool> &used_color) {
+    node_colors_[node] = color;
+    used_color[color] = true;
   }
 
   // colorize the specific node
-  bool ColorizeNode(const OprPtr &node, const IfGraphNodeInfo &info,
-                    std::unordered_set<OprPtr> &used_color) {
+  bool ColorizeNode(std::size_t node, std::vector<bool> &used_color) {
+    const auto &info = graph_->node(node);
     // try to use the hint colors
     for (const auto &n : info.suggest_same) {
-      auto it = colored_nodes_.find(n);
-      const auto &color = it->second;
-      if (it != colored_nodes_.end() && !used_color.count(color)) {
-        if (IsTempReg(color) && !info.can_alloc_temp) continue;
+      auto color = node_colors_[n];
+      if (color != kNoColor && !used_color[color]) {
+        if (IsTempReg(colors_[color]) && !info.can_alloc_temp) continue;
         SetNodeColor(node, color, used_color);
         return true;
       }
     }
     // try to colorize with temporary registers
     if (info.can_alloc_temp) {
-      for (const auto &i : *avaliable_temps_) {
-        if (!used_color.count(i)) {
+      for (const auto &i : temp_colors_) {
+        if (!used_color[i]) {
           SetNodeColor(node, i, used_color);
           return true;
         }
       }
     }
     // colorize with avaliable registers
-    for (const auto &i : *avaliable_regs_) {
-      if (!used_color.count(i)) {
+    for (const auto &i : reg_colors_) {
+      if (!used_color[i]) {
         SetNodeColor(node, i, used_color);
         return true;
       }
@@ -154,15 +162,10 @@ class GraphColoringRegAllocPass : public RegAllocatorBase {
 
   // choose an uncolored node from stack and spill it
   void ChooseAndSpill(const OprPtr &func_label) {
-    const auto &graph = GetIfGraph(func_label);
-    auto get_degree = [&graph](const OprPtr &node) {
-      auto it = graph.find(node);
-      assert(it != graph.end());
-      return it->second.neighbours.size();
-    };
-    auto compare = [&get_degree](const OprPtr &l, const OprPtr &r) {
-      return l->use_count() * get_degree(r) <
-             r->use_count() * get_degree(l);
+    auto compare = [this](std::size_t l, std::size_t r) {
+      const auto &ln = graph_->node(l), &rn = graph_->node(r);
+      return ln.vreg->use_count() * rn.neighbours.size() <
+             rn.vreg->use_count() * ln.neighbours.size();
     };
     auto it = std::min_element(nodes_.begin(), nodes_.end(), compare);
     SpillNode(func_label, *it);
@@ -170,22 +173,15 @@ class GraphColoringRegAllocPass : public RegAllocatorBase {
 
   // colorize all nodes in stack
   bool Colorize(const OprPtr &func_label) {
-    const auto &graph = GetIfGraph(func_label);
+    std::vector<bool> used_color(colors_.size());
     while (!nodes_.empty()) {
-      // get node info from original graph
-      auto it = graph.find(nodes_.back());
-      assert(it != graph.end());
-      const auto &info = it->second;
       // get color of all it's neighbours
-      std::unordered_set<OprPtr> used_color;
-      for (const auto &n : info.neighbours) {
-        auto cn_it = colored_nodes_.find(n);
-        if (cn_it != colored_nodes_.end()) {
-          used_color.insert(cn_it->second);
-        }
+      used_color.assign(colors_.size(), false);
+      for (const auto &n : graph_->node(nodes_.back()).neighbours) {
+        if (node_colors_[n] != kNoColor) used_color[node_colors_[n]] = true;
       }
       // try to colorize
-      if (!ColorizeNode(nodes_.back(), info, used_color)) {
+      if (!ColorizeNode(nodes_.back(), used_color)) {
         // can not be colorized, spill to stack and exit
         ChooseAndSpill(func_label);
         return false;
@@ -198,11 +194,12 @@ class GraphColoringRegAllocPass : public RegAllocatorBase {
 
   // perform register allocation
   void RunAllocator(const OprPtr &func_label) {
+    graph_ = &GetIfGraph(func_label);
     bool stop = false;
     while (!stop) {
-      colored_nodes_.clear();
+      node_colors_.assign(graph_->size(), kNoColor);
       // rebuild node stack
-      RebuildNodeStack(func_label);
+      RebuildNodeStack();
       // try to colorize
       stop = Colorize(func_label);
     }
@@ -210,25 +207,21 @@ class GraphColoringRegAllocPass : public RegAllocatorBase {
 
   // dump interference graph
   void DumpGraph(std::ostream &os, const OprPtr &func_label) {
-    std::unordered_set<std::pair<OprPtr, OprPtr>> visited_edge;
-    os << "graph if_graph {" << std::endl;
-    for (const auto &[node, info] : GetIfGraph(func_label)) {
-      auto node_ptr = static_cast<VirtRegOperand *>(node.get());
-      os << "  n" << node_ptr->id();
+    const auto &graph = GetIfGraph(func_label);
+    auto dump_node = [&os, &graph](std::size_t node) {
+      auto ptr = static_cast<VirtRegOperand *>(graph.node(node).vreg.get());
+      os << "  n" << ptr->id();
       os << " [label = \"";
-      node_ptr->alloc_to()->Dump(os);
+      ptr->alloc_to()->Dump(os);
       os << "\"]" << std::endl;
-      for (const auto &n : info.neighbours) {
-        if (visited_edge.insert({node, n}).second) {
-          visited_edge.insert({n, node});
-          auto n_ptr = static_cast<VirtRegOperand *>(n.get());
-          os << "  n" << n_ptr->id();
-          os << " [label = \"";
-          n_ptr->alloc_to()->Dump(os);
-          os << "\"]" << std::endl;
-          os << "  n" << node_ptr->id() << " -- n";
-          os << n_ptr->id() << std::endl;
-        }
+      return ptr->id();
+    };
+    os << "graph if_graph {" << std::endl;
+    for (std::size_t node = 0; node < graph.size(); ++node) {
+      auto id = dump_node(node);
+      for (const auto &n : graph.node(node).neighbours) {
+        if (n < node) continue;
+        os << "  n" << id << " -- n" << dump_node(n) << std::endl;
       }
     }
     os << "}" << std::endl;
@@ -236,12 +229,19 @@ class GraphColoringRegAllocPass : public RegAllocatorBase {
 
   // reference of interference graph
   const FuncIfGraphs &func_if_graphs_;
+  // interference graph of current function
+  const IfGraph *graph_;
   // reference of register lists
   const RegList *avaliable_temps_, *avaliable_regs_;
+  // all colors, and indices of colors in register lists
+  std::vector<OprPtr> colors_;
+  std::vector<std::size_t> temp_colors_, reg_colors_;
+  // degree of all nodes when rebuilding node stack
+  std::vector<std::size_t> degrees_;
   // stack of nodes that need to be colored
-  std::vector<OprPtr> nodes_;
-  // all colored nodes (node -> reg)
-  std::unordered_map<OprPtr, OprPtr> colored_nodes_;
+  std::vector<std::size_t> nodes_;
+  // color indices of all nodes
+  std::vector<std::size_t> node_colors_;
 };
 
 }  // namespace mimic::back::asmgen
@@ -146,6 +146,17 @@ class LinearScanRegAllocPass : public RegAllocatorBase {
                        const OprPtr &opr, const OprPtr &func_label) {
     // get last element of active
     auto spill = --active.end();
+    // prefer spilling rematerializable intervals that end later
+    for (auto it = spill;; --it) {
+      if (it->first->end_pos <= i->end_pos) break;
+      const auto &alloc_to = vregs_[it->second];
+      if (it->first->can_remat && alloc_to->IsReg() &&
+          (i->can_alloc_temp || !IsTempReg(alloc_to))) {
+        spill = it;
+        break;
+      }
+      if (it == active.begin()) break;
+    }
     // check if can allocate register to var
     if (spill->first->end_pos > i->end_pos) {
       // allocate register/slot of spilled value to i
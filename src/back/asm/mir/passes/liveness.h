@@ -0,0 +1,614 @@
+#ifndef MIMIC_BACK_ASM_MIR_PASSES_LIVENESS_H_
+#define MIMIC_BACK_ASM_MIR_PASSES_LIVENESS_H_
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cstddef>
+#include <cassert>
+
+#include "back/asm/mir/pass.h"
+#include "back/asm/mir/passes/regalloc.h"
+#include "utils/bitvec.h"
+
+namespace mimic::back::asmgen {
+
+/*
+  architecture-independent liveness analysis on MIR
+  this pass will:
+  1.  calculate the CFG of input function
+  2.  analysis liveness information of all virtual registers in function
+
+  virtual registers are numbered densely in each function, and all sets
+  of dataflow analysis are bit vectors. architecture-dependent passes
+  should tell the kind of control flow instructions.
+*/
+class LivenessAnalysisBase : public PassInterface {
+ public:
+  // liveness information type
+  enum class LivenessInfoType {
+    LiveIntervals, LiveRanges, InterferenceGraph,
+  };
+
+  // 'temp_regs_with_ra' is the temporary register list including
+  // return address register, which is used by functions with calls
+  LivenessAnalysisBase(LivenessInfoType info_type,
+                       TempRegChecker temp_checker,
+                       const RegList &temp_regs,
+                       const RegList &temp_regs_with_ra,
+                       const RegList &regs)
+      : info_type_(info_type), temp_checker_(temp_checker),
+        temp_regs_(temp_regs), temp_regs_with_ra_(temp_regs_with_ra),
+        regs_(regs) {}
+
+  void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    Reset();
+    BuildCFG(insts);
+    InitDefUseInfo();
+    InitRematInfo(insts);
+    RunLivenessAnalysis();
+    // generate avaliable registers
+    GenerateAvaliableRegs(func_label, insts);
+    // generate liveness info
+    if (info_type_ == LivenessInfoType::LiveIntervals) {
+      GenerateLiveIntervals(func_label);
+    }
+    else if (info_type_ == LivenessInfoType::LiveRanges) {
+      GenerateLiveRanges(func_label);
+    }
+    else {
+      assert(info_type_ == LivenessInfoType::InterferenceGraph);
+      GenerateInterferenceGraph(func_label);
+    }
+  }
+
+  // getters
+  const FuncRegList &func_temp_regs() const { return func_temp_regs_; }
+  const FuncRegList &func_regs() const { return func_regs_; }
+  const FuncLiveIntervals &func_live_intervals() const {
+    return func_live_intervals_;
+  }
+  const FuncLiveRanges &func_live_ranges() const {
+    return func_live_ranges_;
+  }
+  const FuncIfGraphs &func_if_graphs() const { return func_if_graphs_; }
+
+ protected:
+  // kind of instructions that may affect control flow
+  enum class InstKind {
+    // other instructions
+    Normal,
+    // label definition
+    Label,
+    // conditional branch, falls through if condition is not satisfied
+    Branch,
+    // unconditional jump
+    Jump,
+    // instructions that never fall through, other than jumps
+    Return,
+  };
+
+  // get kind of the specific instruction, and its label
+  // (the defined label of 'Label', or the target of 'Branch'/'Jump')
+  virtual InstKind GetInstKind(const InstBase &inst,
+                               const OperandBase *&label) const = 0;
+
+ private:
+  using BlockId = std::size_t;
+
+  // weight of each level of loop in spill cost, and the maximum depth
+  static constexpr double kLoopWeight = 10;
+  static constexpr std::size_t kMaxLoopDepth = 8;
+  // weight of uses of rematerializable values in spill cost
+  static constexpr double kRematWeight = 0.5;
+
+  // position of live intervals that have not been logged
+  static constexpr std::size_t kNoPos =
+      std::numeric_limits<std::size_t>::max();
+
+  // representation of basic block
+  struct BasicBlock {
+    // instructions in current basic block
+    std::vector<InstBase *> insts;
+    // successors
+    std::vector<BlockId> succs;
+    // all defined (killed) virtual registers
+    utils::BitVec var_kill;
+    // all upward-exposed virtual registers
+    utils::BitVec ue_var;
+    // for liveness analysis
+    utils::BitVec live_in, live_out;
+  };
+
+  // reset internal status
+  void Reset() {
+    labels_.clear();
+    bbs_.clear();
+    vreg_ids_.clear();
+    vregs_.clear();
+  }
+
+  // create a new basic block
+  BlockId NewBlock() {
+    bbs_.emplace_back();
+    return bbs_.size() - 1;
+  }
+
+  // get block id of label, or assign a new id for the specific label
+  BlockId GetBlockId(const OperandBase *label) {
+    auto it = labels_.find(label);
+    if (it != labels_.end()) return it->second;
+    auto id = NewBlock();
+    labels_.insert({label, id});
+    return id;
+  }
+
+  // add an edge to CFG
+  void LinkBlocks(BlockId from, BlockId to) {
+    bbs_[from].succs.push_back(to);
+  }
+
+  // get dense id of the specific virtual register
+  std::size_t GetVRegId(const OprPtr &vreg) {
+    assert(vreg->IsVirtual());
+    auto ret = vreg_ids_.insert({vreg.get(), vregs_.size()});
+    if (ret.second) vregs_.push_back(vreg);
+    return ret.first->second;
+  }
+
+  // build up CFG by traversing instruction list
+  // also number all virtual registers
+  void BuildCFG(const InstPtrList &insts) {
+    auto cur_bid = NewBlock();
+    order_.assign({cur_bid});
+    // kind of previous instruction
+    auto last_kind = InstKind::Normal;
+    // traverse all instructions
+    for (auto it = insts.begin(); it != insts.end(); ++it) {
+      const OperandBase *label = nullptr;
+      auto kind = GetInstKind(**it, label);
+      if (kind == InstKind::Label) {
+        // switch to new basic block
+        auto next_bid = GetBlockId(label);
+        if (last_kind != InstKind::Jump && last_kind != InstKind::Return) {
+          LinkBlocks(cur_bid, next_bid);
+        }
+        cur_bid = next_bid;
+        order_.push_back(cur_bid);
+      }
+      else {
+        // add instruction to current block
+        bbs_[cur_bid].insts.push_back(it->get());
+        for (const auto &opr : (*it)->oprs()) {
+          if (opr.value()->IsVirtual()) GetVRegId(opr.value());
+        }
+        const auto &dest = (*it)->dest();
+        if (dest && dest->IsVirtual()) GetVRegId(dest);
+        // check for branch instructions
+        if (kind == InstKind::Branch) {
+          LinkBlocks(cur_bid, GetBlockId(label));
+          // check if next instruction is jump/label
+          auto next = std::next(it);
+          const OperandBase *next_label;
+          auto next_kind = next != insts.end()
+                               ? GetInstKind(**next, next_label)
+                               : InstKind::Label;
+          if (next_kind != InstKind::Jump && next_kind != InstKind::Label) {
+            // split basic block
+            auto next_bid = NewBlock();
+            LinkBlocks(cur_bid, next_bid);
+            cur_bid = next_bid;
+            order_.push_back(cur_bid);
+          }
+        }
+        else if (kind == InstKind::Jump) {
+          LinkBlocks(cur_bid, GetBlockId(label));
+        }
+      }
+      last_kind = kind;
+    }
+  }
+
+  // initialize def/use information for all basic blocks
+  void InitDefUseInfo() {
+    auto width = vregs_.size();
+    for (auto &&bb : bbs_) {
+      bb.var_kill.Resize(width);
+      bb.ue_var.Resize(width);
+      bb.live_out.Resize(width);
+      for (const auto &inst : bb.insts) {
+        // initialize use info
+        for (const auto &opr : inst->oprs()) {
+          const auto &v = opr.value();
+          if (!v->IsVirtual()) continue;
+          auto id = vreg_ids_[v.get()];
+          if (!bb.var_kill.Get(id)) bb.ue_var.Set(id);
+        }
+        // initialize def info
+        if (inst->dest() && inst->dest()->IsVirtual()) {
+          bb.var_kill.Set(vreg_ids_[inst->dest().get()]);
+        }
+      }
+      bb.live_in = bb.ue_var;
+    }
+  }
+
+  // mark all virtual registers that can be rematerialized
+  void InitRematInfo(const InstPtrList &insts) {
+    remat_vregs_ = utils::BitVec(vregs_.size());
+    for (const auto &it : GetRematDefs(insts)) {
+      remat_vregs_.Set(vreg_ids_[it.first]);
+    }
+  }
+
+  // get the block id sequence in post order on CFG, which is a
+  // good order for backward dataflow analysis
+  // blocks that unreachable from entry are placed at the end
+  // back edges found in depth-first search will be stored in
+  // 'back_edges' if it is not null
+  std::vector<BlockId> GetPostOrder(
+      std::vector<std::pair<BlockId, BlockId>> *back_edges = nullptr) {
+    std::vector<BlockId> po;
+    // 0 for unvisited, 1 for visiting, 2 for visited
+    std::vector<char> state(bbs_.size());
+    // stack of blocks and indices of the next successor to be visited
+    std::vector<std::pair<BlockId, std::size_t>> blocks;
+    for (const auto &root : order_) {
+      if (state[root]) continue;
+      state[root] = 1;
+      blocks.push_back({root, 0});
+      while (!blocks.empty()) {
+        auto &[bid, index] = blocks.back();
+        const auto &succs = bbs_[bid].succs;
+        if (index < succs.size()) {
+          auto succ = succs[index++];
+          if (!state[succ]) {
+            state[succ] = 1;
+            blocks.push_back({succ, 0});
+          }
+          else if (state[succ] == 1 && back_edges) {
+            back_edges->push_back({bid, succ});
+          }
+        }
+        else {
+          state[bid] = 2;
+          po.push_back(bid);
+          blocks.pop_back();
+        }
+      }
+    }
+    return po;
+  }
+
+  // get loop depth of all basic blocks
+  // loops are natural loops of back edges, which are merged if they
+  // have the same header
+  std::vector<std::size_t> GetLoopDepths() {
+    std::vector<std::pair<BlockId, BlockId>> back_edges;
+    GetPostOrder(&back_edges);
+    // get predecessors of all blocks
+    std::vector<std::vector<BlockId>> preds(bbs_.size());
+    for (BlockId bid = 0; bid < bbs_.size(); ++bid) {
+      for (const auto &succ : bbs_[bid].succs) preds[succ].push_back(bid);
+    }
+    // group back edges by header
+    std::sort(back_edges.begin(), back_edges.end(),
+              [](const auto &l, const auto &r) {
+                return l.second < r.second;
+              });
+    // mark blocks of all loops
+    std::vector<std::size_t> depths(bbs_.size());
+    std::vector<BlockId> marked(bbs_.size(), bbs_.size()), blocks;
+    for (auto it = back_edges.begin(); it != back_edges.end();) {
+      auto header = it->second;
+      marked[header] = header;
+      ++depths[header];
+      // walk backward from tails of back edges until reaching header
+      for (; it != back_edges.end() && it->second == header; ++it) {
+        blocks.push_back(it->first);
+      }
+      while (!blocks.empty()) {
+        auto bid = blocks.back();
+        blocks.pop_back();
+        if (marked[bid] == header) continue;
+        marked[bid] = header;
+        ++depths[bid];
+        for (const auto &pred : preds[bid]) blocks.push_back(pred);
+      }
+    }
+    return depths;
+  }
+
+  // get cost of each definition/use in block of the specific loop depth
+  static double GetBlockCost(std::size_t depth) {
+    double cost = 1;
+    for (std::size_t i = 0; i < depth && i < kMaxLoopDepth; ++i) {
+      cost *= kLoopWeight;
+    }
+    return cost;
+  }
+
+  // get spill cost of a definition/use of the specific virtual register
+  // rematerialized values are never stored, and recomputing them is
+  // usually cheaper than reloading
+  double GetSpillCost(std::size_t id, double cost, bool is_def) const {
+    if (!remat_vregs_.Get(id)) return cost;
+    return is_def ? 0 : cost * kRematWeight;
+  }
+
+  // run liveness analysis on current CFG
+  void RunLivenessAnalysis() {
+    auto po = GetPostOrder();
+    utils::BitVec live_out(vregs_.size());
+    // perform analysis
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      // traverse basic blocks in post order
+      for (const auto &bid : po) {
+        auto &bb = bbs_[bid];
+        // LiveOut(bb) = union_{m in succs} LiveIn(m)
+        // LiveIn(m) = UEVar(m) union (LiveOut(m) inter bar(VarKill(m)))
+        live_out.Clear();
+        for (const auto &succ : bb.succs) live_out |= bbs_[succ].live_in;
+        if (live_out == bb.live_out) continue;
+        std::swap(live_out, bb.live_out);
+        bb.live_in = bb.var_kill;
+        bb.live_in.Flip();
+        bb.live_in &= bb.live_out;
+        bb.live_in |= bb.ue_var;
+        changed = true;
+      }
+    }
+  }
+
+  // generate avaliable registers
+  void GenerateAvaliableRegs(const OprPtr &func_label,
+                             const InstPtrList &insts) {
+    // check if there is function call in current function
+    bool has_call = false;
+    for (const auto &i : insts) {
+      if (i->IsCall()) {
+        has_call = true;
+        break;
+      }
+    }
+    // initialize register list reference of current function
+    func_temp_regs_[func_label] = has_call ? &temp_regs_with_ra_
+                                           : &temp_regs_;
+    func_regs_[func_label] = &regs_;
+  }
+
+  void LogLiveInterval(std::size_t id, std::size_t pos,
+                       std::size_t last_temp_pos) {
+    auto &li = intervals_[id];
+    if (li.end_pos != kNoPos) {
+      // update end position
+      li.end_pos = pos;
+      // check if there are usings of temporary register in interval
+      if (last_temp_pos > li.start_pos) li.can_alloc_temp = false;
+    }
+    else {
+      // add new live interval info
+      li = {pos, pos, true, remat_vregs_.Get(id)};
+      logged_ids_.push_back(id);
+    }
+  }
+
+  // generate live intervals for linear scan register allocator
+  void GenerateLiveIntervals(const OprPtr &func_label) {
+    intervals_.assign(vregs_.size(), {kNoPos, kNoPos, true, false});
+    logged_ids_.clear();
+    std::size_t pos = 0, last_temp_pos = 0;
+    for (const auto &bid : order_) {
+      const auto &bb = bbs_[bid];
+      // traverse all instructions
+      for (const auto &i : bb.insts) {
+        for (const auto &opr : i->oprs()) {
+          if (!opr.value()->IsVirtual()) continue;
+          auto id = vreg_ids_[opr.value().get()];
+          LogLiveInterval(id, pos, last_temp_pos);
+        }
+        const auto &dest = i->dest();
+        if (dest && dest->IsVirtual()) {
+          LogLiveInterval(vreg_ids_[dest.get()], pos, last_temp_pos);
+        }
+        // update 'last_temp_pos'
+        if ((dest && temp_checker_(dest)) ||
+            (i->IsMove() && temp_checker_(i->oprs()[0].value())) ||
+            i->IsCall()) {
+          last_temp_pos = pos;
+        }
+        ++pos;
+      }
+      // log virtual registers in 'live out' set
+      bb.live_out.ForEach([&](std::size_t id) {
+        LogLiveInterval(id, pos, last_temp_pos);
+      });
+    }
+    // store intervals in the order of their first appearance
+    auto &live_intervals = func_live_intervals_[func_label];
+    for (const auto &id : logged_ids_) {
+      live_intervals.insert({vregs_[id], intervals_[id]});
+    }
+  }
+
+  // generate live ranges for binpacking register allocator
+  // each block contributes at most one segment to a live range
+  void GenerateLiveRanges(const OprPtr &func_label) {
+    auto &lr = func_live_ranges_[func_label];
+    lr = LiveRanges();
+    lr.vregs = vregs_;
+    lr.ranges.assign(vregs_.size(), {{}, true, false, 0});
+    remat_vregs_.ForEach([&lr](std::size_t id) {
+      lr.ranges[id].can_remat = true;
+    });
+    auto depths = GetLoopDepths();
+    // first/last positions of virtual registers in current block
+    std::vector<std::size_t> first(vregs_.size(), kNoPos);
+    std::vector<std::size_t> last(vregs_.size()), logged;
+    auto log_pos = [&](std::size_t id, std::size_t pos) {
+      if (first[id] == kNoPos) {
+        first[id] = pos;
+        logged.push_back(id);
+      }
+      last[id] = pos;
+    };
+    std::size_t pos = 0;
+    for (const auto &bid : order_) {
+      const auto &bb = bbs_[bid];
+      if (bb.insts.empty()) continue;
+      auto start_pos = pos;
+      auto cost = GetBlockCost(depths[bid]);
+      bb.live_in.ForEach([&](std::size_t id) { log_pos(id, start_pos); });
+      // traverse all instructions
+      for (const auto &i : bb.insts) {
+        lr.insts.push_back(i);
+        // log operands and destination
+        for (const auto &opr : i->oprs()) {
+          if (!opr.value()->IsVirtual()) continue;
+          auto id = vreg_ids_[opr.value().get()];
+          lr.ranges[id].spill_cost += GetSpillCost(id, cost, false);
+          log_pos(id, pos);
+        }
+        const auto &dest = i->dest();
+        if (dest && dest->IsVirtual()) {
+          auto id = vreg_ids_[dest.get()];
+          lr.ranges[id].spill_cost += GetSpillCost(id, cost, true);
+          log_pos(id, pos);
+        }
+        // check if temporary registers are clobbered
+        if ((dest && temp_checker_(dest)) ||
+            (i->IsMove() && temp_checker_(i->oprs()[0].value())) ||
+            i->IsCall()) {
+          lr.temp_clobbers.push_back(pos);
+        }
+        ++pos;
+      }
+      bb.live_out.ForEach([&](std::size_t id) { log_pos(id, pos - 1); });
+      // add segments of current block
+      for (const auto &id : logged) {
+        auto &range = lr.ranges[id];
+        if (lr.IsTempClobbered(first[id], last[id], bb.live_in.Get(id))) {
+          range.can_alloc_temp = false;
+        }
+        auto &segs = range.segs;
+        if (!segs.empty() && segs.back().second + 1 == first[id]) {
+          segs.back().second = last[id];
+        }
+        else {
+          segs.push_back({first[id], last[id]});
+        }
+        first[id] = kNoPos;
+      }
+      logged.clear();
+      lr.blocks.push_back({start_pos, pos, cost, bb.live_in, bb.live_out});
+    }
+  }
+
+  // generate interference graph for graph coloring register allocator
+  void GenerateInterferenceGraph(const OprPtr &func_label) {
+    auto &if_graph = func_if_graphs_[func_label];
+    if_graph = IfGraph();
+    // add nodes in ascending order of virtual register ids
+    std::vector<std::size_t> ids(vregs_.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    std::sort(ids.begin(), ids.end(), [this](std::size_t l, std::size_t r) {
+      return NodeCompare()(vregs_[l], vregs_[r]);
+    });
+    std::vector<std::size_t> nodes(vregs_.size());
+    for (const auto &id : ids) nodes[id] = if_graph.AddNode(vregs_[id]);
+    utils::BitVec can_not_alloc_temp(vregs_.size());
+    // spill costs of all virtual registers
+    auto depths = GetLoopDepths();
+    std::vector<double> spill_costs(vregs_.size());
+    // traverse all blocks
+    for (const auto &bid : order_) {
+      const auto &bb = bbs_[bid];
+      auto live_now = bb.live_out;
+      // each definition and use costs more in deeper loop
+      auto cost = GetBlockCost(depths[bid]);
+      // traverse all instructions in reverse order
+      for (auto it = bb.insts.rbegin(); it != bb.insts.rend(); ++it) {
+        const auto &i = *it;
+        // update 'can_not_alloc_temp'
+        if ((i->dest() && temp_checker_(i->dest())) || i->IsCall()) {
+          can_not_alloc_temp |= live_now;
+        }
+        // check for destination register
+        if (i->dest() && i->dest()->IsVirtual()) {
+          auto dest = vreg_ids_[i->dest().get()];
+          spill_costs[dest] += GetSpillCost(dest, cost, true);
+          // add edges
+          live_now.ForEach([&](std::size_t id) {
+            if_graph.AddEdge(nodes[id], nodes[dest]);
+          });
+          // remove from set
+          live_now.Clear(dest);
+        }
+        // add operands to set
+        for (const auto &opr : i->oprs()) {
+          if (!opr.value()->IsVirtual()) continue;
+          auto id = vreg_ids_[opr.value().get()];
+          spill_costs[id] += GetSpillCost(id, cost, false);
+          live_now.Set(id);
+        }
+        // update 'suggest_same'
+        if (i->IsMove()) {
+          const auto &dest = i->dest(), &src = i->oprs()[0].value();
+          if (dest->IsVirtual() && temp_checker_(src)) {
+            can_not_alloc_temp.Set(vreg_ids_[dest.get()]);
+          }
+          else if (dest->IsVirtual() && src->IsVirtual()) {
+            if_graph.AddSuggestSame(nodes[vreg_ids_[dest.get()]],
+                                    nodes[vreg_ids_[src.get()]]);
+          }
+        }
+      }
+    }
+    // apply 'can_alloc_temp' flag and spill cost of all nodes in graph
+    for (std::size_t id = 0; id < vregs_.size(); ++id) {
+      if_graph.set_can_alloc_temp(nodes[id], !can_not_alloc_temp.Get(id));
+      if_graph.set_spill_cost(nodes[id], spill_costs[id]);
+    }
+  }
+
+  // map of labels to basic block id
+  std::unordered_map<const OperandBase *, BlockId> labels_;
+  // all basic blocks, id of entry block is zero
+  std::vector<BasicBlock> bbs_;
+  // original order of all basic blocks
+  std::vector<BlockId> order_;
+  // live intervals of all virtual registers, and ids of virtual
+  // registers in order of their first appearance
+  std::vector<LiveInterval> intervals_;
+  std::vector<std::size_t> logged_ids_;
+  // dense ids of all virtual registers
+  std::unordered_map<const OperandBase *, std::size_t> vreg_ids_;
+  // virtual registers of all ids
+  std::vector<OprPtr> vregs_;
+  // virtual registers that can be rematerialized
+  utils::BitVec remat_vregs_;
+  // liveness info type
+  LivenessInfoType info_type_;
+  // temporary register checker
+  TempRegChecker temp_checker_;
+  // architecture register list
+  const RegList &temp_regs_, &temp_regs_with_ra_, &regs_;
+  // avaliable registers of all functions
+  FuncRegList func_temp_regs_, func_regs_;
+  // live intervals of all functions
+  FuncLiveIntervals func_live_intervals_;
+  // live ranges of all functions
+  FuncLiveRanges func_live_ranges_;
+  // interference graph of all functions
+  FuncIfGraphs func_if_graphs_;
+};
+
+}  // namespace mimic::back::asmgen
+
+#endif  // MIMIC_BACK_ASM_MIR_PASSES_LIVENESS_H_
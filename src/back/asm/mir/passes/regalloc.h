@@ -1,25 +1,69 @@
 #ifndef MIMIC_BACK_ASM_MIR_PASSES_REGALLOC_H_
 #define MIMIC_BACK_ASM_MIR_PASSES_REGALLOC_H_
 
-#include <map>
-#include <set>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include <algorithm>
 #include <functional>
 #include <memory>
+#include <utility>
 #include <cassert>
+#include <cstddef>
 
 #include "back/asm/mir/pass.h"
 #include "back/asm/mir/virtreg.h"
+#include "utils/bitvec.h"
 
 namespace mimic::back::asmgen {
 
+// definitions of rematerializable virtual registers
+using RematDefs =
+    std::unordered_map<const OperandBase *, std::vector<InstPtr>>;
+
+// get all virtual registers that can be rematerialized at their uses
+// instead of being spilled, and their definitions
+// all definitions of such virtual register must be adjacent
+// rematerializable instructions, like 'movw' and 'movt'
+inline RematDefs GetRematDefs(const InstPtrList &insts) {
+  RematDefs remat_defs;
+  std::unordered_set<const OperandBase *> non_remat;
+  const InstBase *last = nullptr;
+  for (const auto &i : insts) {
+    const auto &dest = i->dest();
+    if (dest && dest->IsVirtual() && !non_remat.count(dest.get())) {
+      auto it = remat_defs.find(dest.get());
+      bool is_remat = i->IsRematerializable();
+      if (it == remat_defs.end()) {
+        // the first definition must not use the virtual register
+        for (const auto &opr : i->oprs()) {
+          if (opr.value() == dest) is_remat = false;
+        }
+      }
+      else if (it->second.back().get() != last) {
+        is_remat = false;
+      }
+      // update definitions
+      if (is_remat) {
+        remat_defs[dest.get()].push_back(i);
+      }
+      else {
+        if (it != remat_defs.end()) remat_defs.erase(it);
+        non_remat.insert(dest.get());
+      }
+    }
+    last = i.get();
+  }
+  return remat_defs;
+}
+
 // live interval information
 struct LiveInterval {
   std::size_t start_pos;
   std::size_t end_pos;
   bool can_alloc_temp;
+  // value can be rematerialized instead of being spilled
+  bool can_remat;
 };
 
 // live intervals in function
@@ -28,6 +72,55 @@ using LiveIntervals = std::unordered_map<OprPtr, LiveInterval>;
 // live intervals of all functions
 using FuncLiveIntervals = std::unordered_map<OprPtr, LiveIntervals>;
 
+// live ranges information of a function
+//
+// instructions are numbered by their positions in the function, and
+// live range of each virtual register consists of disjoint segments,
+// gaps between segments are lifetime holes
+struct LiveRanges {
+  // information of basic block
+  struct Block {
+    // position of the first instruction and the end of block
+    std::size_t start_pos, end_pos;
+    // cost of each definition/use in block, weighted by loop depth
+    double cost;
+    // virtual registers (dense ids) that are live at entry/exit
+    utils::BitVec live_in, live_out;
+  };
+
+  // live range of virtual register
+  struct Range {
+    // live segments in ascending order, both ends are inclusive
+    std::vector<std::pair<std::size_t, std::size_t>> segs;
+    bool can_alloc_temp, can_remat;
+    // cost of spilling, weighted by loop depth
+    double spill_cost;
+  };
+
+  // check if there are instructions that clobber temporary registers
+  // when a value is live in [start, end], 'live_before' indicates that
+  // the value is live before the instruction at 'start'
+  bool IsTempClobbered(std::size_t start, std::size_t end,
+                       bool live_before) const {
+    auto it = std::lower_bound(temp_clobbers.begin(), temp_clobbers.end(),
+                               live_before ? start : start + 1);
+    return it != temp_clobbers.end() && *it <= end;
+  }
+
+  // all instructions, in order of positions
+  std::vector<InstBase *> insts;
+  // all non-empty basic blocks, in order of positions
+  std::vector<Block> blocks;
+  // all virtual registers and their live ranges, indexed by dense ids
+  std::vector<OprPtr> vregs;
+  std::vector<Range> ranges;
+  // positions of instructions that clobber temporary registers
+  std::vector<std::size_t> temp_clobbers;
+};
+
+// live ranges of all functions
+using FuncLiveRanges = std::unordered_map<OprPtr, LiveRanges>;
+
 // comparator for graph nodes (virtual registers)
 struct NodeCompare {
   bool operator()(const OprPtr &n1, const OprPtr &n2) const {
@@ -37,15 +130,90 @@ struct NodeCompare {
   }
 };
 
-// information of graph's node
-struct IfGraphNodeInfo {
-  std::set<OprPtr, NodeCompare> neighbours;
-  std::set<OprPtr, NodeCompare> suggest_same;
-  bool can_alloc_temp;
-};
-
 // interference graph of a function
-using IfGraph = std::map<OprPtr, IfGraphNodeInfo, NodeCompare>;
+//
+// nodes are identified by dense indices, interference between nodes is
+// stored in a lower triangular bit matrix for constant time queries,
+// and in adjacency lists for iterating over neighbours
+class IfGraph {
+ public:
+  // information of graph's node
+  struct NodeInfo {
+    // virtual register of node
+    OprPtr vreg;
+    // interfering nodes, in the order of edges being added
+    std::vector<std::size_t> neighbours;
+    // nodes that are suggested to be the same register, in ascending order
+    std::vector<std::size_t> suggest_same;
+    bool can_alloc_temp;
+    // cost of spilling, weighted by loop depth
+    double spill_cost;
+  };
+
+  IfGraph() {}
+
+  // add a new node of the specific virtual register, returns its index
+  std::size_t AddNode(const OprPtr &vreg) {
+    assert(vreg->IsVirtual());
+    // row of the new node in bit matrix
+    matrix_.Resize(matrix_.width() + nodes_.size());
+    nodes_.push_back({vreg, {}, {}, true, 0});
+    return nodes_.size() - 1;
+  }
+
+  // add an interference edge between two nodes
+  // returns false if edge already exists
+  bool AddEdge(std::size_t n1, std::size_t n2) {
+    if (n1 == n2) return false;
+    auto pos = GetMatrixPos(n1, n2);
+    if (matrix_.Get(pos)) return false;
+    matrix_.Set(pos);
+    nodes_[n1].neighbours.push_back(n2);
+    nodes_[n2].neighbours.push_back(n1);
+    return true;
+  }
+
+  // suggest that two nodes should be allocated to the same register
+  void AddSuggestSame(std::size_t n1, std::size_t n2) {
+    if (n1 == n2) return;
+    InsertSorted(nodes_[n1].suggest_same, n2);
+    InsertSorted(nodes_[n2].suggest_same, n1);
+  }
+
+  // check if there is an interference edge between two nodes
+  bool IsAdjacent(std::size_t n1, std::size_t n2) const {
+    return n1 != n2 && matrix_.Get(GetMatrixPos(n1, n2));
+  }
+
+  // setters
+  void set_can_alloc_temp(std::size_t n, bool can_alloc_temp) {
+    nodes_[n].can_alloc_temp = can_alloc_temp;
+  }
+  void set_spill_cost(std::size_t n, double spill_cost) {
+    nodes_[n].spill_cost = spill_cost;
+  }
+
+  // getters
+  std::size_t size() const { return nodes_.size(); }
+  const NodeInfo &node(std::size_t n) const { return nodes_[n]; }
+  const std::vector<NodeInfo> &nodes() const { return nodes_; }
+
+ private:
+  // position of edge (n1, n2) in bit matrix
+  static std::size_t GetMatrixPos(std::size_t n1, std::size_t n2) {
+    if (n1 < n2) std::swap(n1, n2);
+    return n1 * (n1 - 1) / 2 + n2;
+  }
+
+  // insert value into sorted vector if it does not exist
+  static void InsertSorted(std::vector<std::size_t> &vec, std::size_t v) {
+    auto it = std::lower_bound(vec.begin(), vec.end(), v);
+    if (it == vec.end() || *it != v) vec.insert(it, v);
+  }
+
+  std::vector<NodeInfo> nodes_;
+  utils::BitVec matrix_;
+};
 
 // interference graph of all functions
 using FuncIfGraphs = std::unordered_map<OprPtr, IfGraph>;
@@ -75,6 +243,28 @@ class SlotAllocator {
   std::function<OprPtr(const OprPtr &)> alloc_slot_;
 };
 
+// move instruction generator, for allocators that split live ranges
+class MoveGenerator {
+ public:
+  MoveGenerator() {}
+  MoveGenerator(std::function<OprPtr()> gen_vreg,
+                std::function<InstPtr(const OprPtr &, const OprPtr &)>
+                    gen_move)
+      : gen_vreg_(gen_vreg), gen_move_(gen_move) {}
+
+  // get a new virtual register
+  OprPtr GetVReg() const { return gen_vreg_(); }
+
+  // generate a new move instruction
+  InstPtr GetMove(const OprPtr &dest, const OprPtr &src) const {
+    return gen_move_(dest, src);
+  }
+
+ private:
+  std::function<OprPtr()> gen_vreg_;
+  std::function<InstPtr(const OprPtr &, const OprPtr &)> gen_move_;
+};
+
 // base class of all register allocators
 //
 // register allocator should scan all virtual registers
@@ -95,6 +285,8 @@ class RegAllocatorBase : public PassInterface {
   }
   // specify stack slot allocator
   void set_allocator(SlotAllocator allocator) { allocator_ = allocator; }
+  // specify move instruction generator
+  void set_move_gen(MoveGenerator move_gen) { move_gen_ = move_gen; }
   // specify temporary register checker
   void set_temp_checker(TempRegChecker temp_checker) {
     temp_checker_ = temp_checker;
@@ -127,10 +319,12 @@ class RegAllocatorBase : public PassInterface {
 
   // getters
   const SlotAllocator &allocator() const { return allocator_; }
+  const MoveGenerator &move_gen() const { return move_gen_; }
 
  private:
   const FuncRegList *func_temp_reg_list_, *func_reg_list_;
   SlotAllocator allocator_;
+  MoveGenerator move_gen_;
   TempRegChecker temp_checker_;
 };
 
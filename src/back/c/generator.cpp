@@ -61,26 +61,22 @@ inline std::string_view GetLinkType(LinkageTypes link) {
 }  // namespace
 
 const std::string &CCodeGen::GetVal(const SSAPtr &ssa) {
-  auto val = std::any_cast<std::string>(&ssa->metadata());
+  auto val = vals_.Find(*ssa);
   if (!val) {
     ssa->GenerateCode(*this);
-    val = std::any_cast<std::string>(&ssa->metadata());
+    val = vals_.Find(*ssa);
     assert(val);
   }
   return *val;
 }
 
 const std::string &CCodeGen::GetLabel(const mid::SSAPtr &ssa) {
-  auto val = std::any_cast<std::string>(&ssa->metadata());
-  if (!val) {
-    ssa->set_metadata(GetNewVar(kLabelPrefix));
-    val = std::any_cast<std::string>(&ssa->metadata());
-  }
-  return *val;
+  if (auto val = vals_.Find(*ssa)) return *val;
+  return vals_.Set(*ssa, GetNewVar(kLabelPrefix));
 }
 
 void CCodeGen::SetVal(Value &ssa, const std::string &val) {
-  ssa.set_metadata(val);
+  vals_.Set(ssa, val);
 }
 
 std::string CCodeGen::GetNewVar(const char *prefix) {
@@ -172,6 +168,7 @@ void CCodeGen::Reset() {
   code_.clear();
   in_global_var_ = false;
   arr_depth_ = 0;
+  vals_.Clear();
 }
 
 void CCodeGen::GenerateOn(LoadSSA &ssa) {
@@ -375,8 +372,8 @@ void CCodeGen::GenerateOn(AllocaSSA &ssa) {
 void CCodeGen::GenerateOn(BlockSSA &ssa) {
   // generate label
   std::string label;
-  if (ssa.metadata().has_value()) {
-    label = *std::any_cast<std::string>(&ssa.metadata());
+  if (auto val = vals_.Find(ssa)) {
+    label = *val;
   }
   else {
     label = GetNewVar(kLabelPrefix);
@@ -385,7 +382,7 @@ void CCodeGen::GenerateOn(BlockSSA &ssa) {
   code_ << label << ": (void)0;" << std::endl;
   // generate instructions
   for (const auto &i : ssa.insts()) {
-    assert(!i->metadata().has_value());
+    assert(!vals_.Has(*i));
     i->GenerateCode(*this);
   }
 }
@@ -8,6 +8,7 @@
 #include <cstddef>
 
 #include "back/codegen.h"
+#include "mid/valuemap.h"
 #include "define/type.h"
 
 namespace mimic::back::c {
@@ -46,11 +47,11 @@ class CCodeGen : public CodeGenInterface {
  private:
   using TypeInfo = std::pair<define::TypePtr, std::string>;
 
-  // get value from metadata
+  // get generated value of SSA value
   const std::string &GetVal(const mid::SSAPtr &ssa);
-  // get label from metadata
+  // get label of SSA value
   const std::string &GetLabel(const mid::SSAPtr &ssa);
-  // store value/label to metadata
+  // store value/label of SSA value
   void SetVal(mid::Value &ssa, const std::string &val);
   // get a new temporary variable
   std::string GetNewVar(const char *prefix);
@@ -66,6 +67,8 @@ class CCodeGen : public CodeGenInterface {
   // generate the definition of array type
   const std::string &DefineArray(const define::TypePtr &type);
 
+  // generated values/labels of SSA values
+  mid::ValueMap<std::string> vals_;
   // temporary variable/type counter
   std::size_t counter_;
   // structures/arrays that have already been defined
@@ -36,6 +36,8 @@ class CodeGenInterface {
   virtual void GenerateOn(mid::SelectSSA &ssa) = 0;
   virtual void GenerateOn(mid::UndefSSA &ssa) = 0;
 
+  // run passes on the generated code, must be called before dumping
+  virtual void RunPasses() {}
   // dump code in current generator
   virtual void Dump(std::ostream &os) const = 0;
 };
@@ -13,6 +13,7 @@
 #include "define/type.h"
 #include "mid/usedef.h"
 #include "front/logger.h"
+#include "front/symbol.h"
 
 // forward declarations for visitor pattern
 namespace mimic::mid {
@@ -87,7 +88,7 @@ class VarDeclAST : public BaseAST {
 // variable/constant definition
 class VarDefAST : public BaseAST {
  public:
-  VarDefAST(const std::string &id, ASTPtrList arr_lens, ASTPtr init)
+  VarDefAST(front::Symbol id, ASTPtrList arr_lens, ASTPtr init)
       : id_(id), arr_lens_(std::move(arr_lens)), init_(std::move(init)) {}
 
   bool IsLiteral() const override { return false; }
@@ -102,12 +103,12 @@ class VarDefAST : public BaseAST {
   void set_init(ASTPtr init) { init_ = std::move(init); }
 
   // getters
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
   const ASTPtrList &arr_lens() const { return arr_lens_; }
   const ASTPtr &init() const { return init_; }
 
  private:
-  std::string id_;
+  front::Symbol id_;
   ASTPtrList arr_lens_;
   ASTPtr init_;
 };
@@ -147,7 +148,7 @@ class InitListAST : public BaseAST {
 // function declaration
 class FuncDeclAST : public BaseAST {
  public:
-  FuncDeclAST(ASTPtr type, const std::string &id, ASTPtrList params)
+  FuncDeclAST(ASTPtr type, front::Symbol id, ASTPtrList params)
       : type_(std::move(type)), id_(id), params_(std::move(params)) {}
 
   bool IsLiteral() const override { return false; }
@@ -160,12 +161,12 @@ class FuncDeclAST : public BaseAST {
 
   // getters
   const ASTPtr &type() const { return type_; }
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
   const ASTPtrList &params() const { return params_; }
 
  private:
   ASTPtr type_;
-  std::string id_;
+  front::Symbol id_;
   ASTPtrList params_;
 };
 
@@ -196,7 +197,7 @@ class FuncDefAST : public BaseAST {
 //       but it's first element can be 'nullptr' (e.g. int arg[])
 class FuncParamAST : public BaseAST {
  public:
-  FuncParamAST(ASTPtr type, const std::string &id, ASTPtrList arr_lens)
+  FuncParamAST(ASTPtr type, front::Symbol id, ASTPtrList arr_lens)
       : type_(std::move(type)), id_(id), arr_lens_(std::move(arr_lens)) {}
 
   bool IsLiteral() const override { return false; }
@@ -209,19 +210,19 @@ class FuncParamAST : public BaseAST {
 
   // getters
   const ASTPtr &type() const { return type_; }
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
   const ASTPtrList &arr_lens() const { return arr_lens_; }
 
  private:
   ASTPtr type_;
-  std::string id_;
+  front::Symbol id_;
   ASTPtrList arr_lens_;
 };
 
 // structure definition
 class StructDefAST : public BaseAST {
  public:
-  StructDefAST(const std::string &id, ASTPtrList elems)
+  StructDefAST(front::Symbol id, ASTPtrList elems)
       : id_(id), elems_(std::move(elems)) {}
 
   bool IsLiteral() const override { return false; }
@@ -233,11 +234,11 @@ class StructDefAST : public BaseAST {
   mid::SSAPtr GenerateIR(mid::IRBuilder &irb) override;
 
   // getters
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
   const ASTPtrList &elems() const { return elems_; }
 
  private:
-  std::string id_;
+  front::Symbol id_;
   ASTPtrList elems_;
 };
 
@@ -245,7 +246,7 @@ class StructDefAST : public BaseAST {
 // NOTE: property 'id' can be empty
 class EnumDefAST : public BaseAST {
  public:
-  EnumDefAST(const std::string &id, ASTPtrList elems)
+  EnumDefAST(front::Symbol id, ASTPtrList elems)
       : id_(id), elems_(std::move(elems)) {}
 
   bool IsLiteral() const override { return false; }
@@ -257,18 +258,18 @@ class EnumDefAST : public BaseAST {
   mid::SSAPtr GenerateIR(mid::IRBuilder &irb) override;
 
   // getters
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
   const ASTPtrList &elems() const { return elems_; }
 
  private:
-  std::string id_;
+  front::Symbol id_;
   ASTPtrList elems_;
 };
 
 // type alias
 class TypeAliasAST : public BaseAST {
  public:
-  TypeAliasAST(ASTPtr type, const std::string &id)
+  TypeAliasAST(ASTPtr type, front::Symbol id)
       : type_(std::move(type)), id_(id) {}
 
   bool IsLiteral() const override { return false; }
@@ -281,11 +282,11 @@ class TypeAliasAST : public BaseAST {
 
   // getters
   const ASTPtr &type() const { return type_; }
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
 
  private:
   ASTPtr type_;
-  std::string id_;
+  front::Symbol id_;
 };
 
 // element of structure
@@ -314,7 +315,7 @@ class StructElemAST : public BaseAST {
 // element definition of structure
 class StructElemDefAST : public BaseAST {
  public:
-  StructElemDefAST(const std::string &id, ASTPtrList arr_lens)
+  StructElemDefAST(front::Symbol id, ASTPtrList arr_lens)
       : id_(id), arr_lens_(std::move(arr_lens)) {}
 
   bool IsLiteral() const override { return false; }
@@ -326,18 +327,18 @@ class StructElemDefAST : public BaseAST {
   mid::SSAPtr GenerateIR(mid::IRBuilder &irb) override;
 
   // getters
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
   const ASTPtrList &arr_lens() const { return arr_lens_; }
 
  private:
-  std::string id_;
+  front::Symbol id_;
   ASTPtrList arr_lens_;
 };
 
 // element of enumeration
 class EnumElemAST : public BaseAST {
  public:
-  EnumElemAST(const std::string &id, ASTPtr expr)
+  EnumElemAST(front::Symbol id, ASTPtr expr)
       : id_(id), expr_(std::move(expr)) {}
 
   bool IsLiteral() const override { return false; }
@@ -352,11 +353,11 @@ class EnumElemAST : public BaseAST {
   void set_expr(ASTPtr expr) { expr_ = std::move(expr); }
 
   // getters
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
   const ASTPtr &expr() const { return expr_; }
 
  private:
-  std::string id_;
+  front::Symbol id_;
   ASTPtr expr_;
 };
 
@@ -632,7 +633,7 @@ class FuncCallAST : public BaseAST {
 //       between '->' (arrow type) and '.' (dot type)
 class AccessAST : public BaseAST {
  public:
-  AccessAST(bool is_arrow, ASTPtr expr, const std::string &id)
+  AccessAST(bool is_arrow, ASTPtr expr, front::Symbol id)
       : is_arrow_(is_arrow), expr_(std::move(expr)), id_(id) {}
 
   bool IsLiteral() const override { return false; }
@@ -646,12 +647,12 @@ class AccessAST : public BaseAST {
   // getters
   bool is_arrow() const { return is_arrow_; }
   const ASTPtr &expr() const { return expr_; }
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
 
  private:
   bool is_arrow_;
   ASTPtr expr_;
-  std::string id_;
+  front::Symbol id_;
 };
 
 // integer number literal
@@ -717,7 +718,7 @@ class StringAST : public BaseAST {
 // identifier
 class IdAST : public BaseAST {
  public:
-  IdAST(const std::string &id) : id_(id) {}
+  IdAST(front::Symbol id) : id_(id) {}
 
   bool IsLiteral() const override { return false; }
   bool IsInitList() const override { return false; }
@@ -728,10 +729,10 @@ class IdAST : public BaseAST {
   mid::SSAPtr GenerateIR(mid::IRBuilder &irb) override;
 
   // getters
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
 
  private:
-  std::string id_;
+  front::Symbol id_;
 };
 
 // primitive type
@@ -759,7 +760,7 @@ class PrimTypeAST : public BaseAST {
 // structure type
 class StructTypeAST : public BaseAST {
  public:
-  StructTypeAST(const std::string &id) : id_(id) {}
+  StructTypeAST(front::Symbol id) : id_(id) {}
 
   bool IsLiteral() const override { return false; }
   bool IsInitList() const override { return false; }
@@ -770,16 +771,16 @@ class StructTypeAST : public BaseAST {
   mid::SSAPtr GenerateIR(mid::IRBuilder &irb) override;
 
   // getters
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
 
  private:
-  std::string id_;
+  front::Symbol id_;
 };
 
 // enumeration type
 class EnumTypeAST : public BaseAST {
  public:
-  EnumTypeAST(const std::string &id) : id_(id) {}
+  EnumTypeAST(front::Symbol id) : id_(id) {}
 
   bool IsLiteral() const override { return false; }
   bool IsInitList() const override { return false; }
@@ -790,10 +791,10 @@ class EnumTypeAST : public BaseAST {
   mid::SSAPtr GenerateIR(mid::IRBuilder &irb) override;
 
   // getters
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
 
  private:
-  std::string id_;
+  front::Symbol id_;
 };
 
 // constant type
@@ -843,7 +844,7 @@ class PointerTypeAST : public BaseAST {
 // user defined type (type aliases)
 class UserTypeAST : public BaseAST {
  public:
-  UserTypeAST(const std::string &id) : id_(id) {}
+  UserTypeAST(front::Symbol id) : id_(id) {}
 
   bool IsLiteral() const override { return false; }
   bool IsInitList() const override { return false; }
@@ -854,10 +855,10 @@ class UserTypeAST : public BaseAST {
   mid::SSAPtr GenerateIR(mid::IRBuilder &irb) override;
 
   // getters
-  const std::string &id() const { return id_; }
+  front::Symbol id() const { return id_; }
 
  private:
-  std::string id_;
+  front::Symbol id_;
 };
 
 }  // namespace mimic::define
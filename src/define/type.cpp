@@ -3,18 +3,217 @@
 #include <sstream>
 #include <utility>
 #include <stack>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
 #include <cassert>
 
 #include "xstl/guard.h"
 
 using namespace mimic::define;
+using namespace mimic::utils;
+
+namespace mimic::define {
+
+// context for interning types
+// NOTE: thread safe
+class TypeContext {
+ public:
+  static TypeContext &GetInstance() {
+    static TypeContext context;
+    return context;
+  }
+
+  // get a primitive type
+  const TypePtr &GetPrim(PrimType::Type type, bool is_right) const {
+    return prims_[static_cast<int>(type)][is_right];
+  }
+
+  // get a pointer type
+  TypePtr GetPointer(const TypePtr &base, bool is_right) {
+    PointerKey key = {base.get(), is_right};
+    if (auto type = Find(pointers_, key)) return type;
+    auto trivial = base->GetTrivialType();
+    auto type = std::make_shared<PointerType>(base, is_right);
+    type->trivial_ = !is_right && trivial == base
+                         ? type : GetPointer(trivial, false);
+    return Insert(pointers_, key, std::move(type));
+  }
+
+  // get a constant type
+  TypePtr GetConst(const TypePtr &base) {
+    const BaseType *key = base.get();
+    if (auto type = Find(consts_, key)) return type;
+    auto type = std::make_shared<ConstType>(base);
+    return Insert(consts_, key, std::move(type));
+  }
+
+  // get an array type
+  TypePtr GetArray(const TypePtr &base, std::size_t len, bool is_right) {
+    ArrayKey key = {base.get(), len, is_right};
+    if (auto type = Find(arrays_, key)) return type;
+    auto trivial = base->GetTrivialType();
+    auto type = std::make_shared<ArrayType>(base, len, is_right);
+    type->trivial_ = !is_right && trivial == base
+                         ? type : GetArray(trivial, len, false);
+    return Insert(arrays_, key, std::move(type));
+  }
+
+  // get a function type
+  TypePtr GetFunc(const TypePtrList &args, const TypePtr &ret,
+                  bool is_right) {
+    FuncKey key = {{}, ret.get(), is_right};
+    for (const auto &i : args) key.args.push_back(i.get());
+    if (auto type = Find(funcs_, key)) return type;
+    // get trivial types of arguments and return type
+    TypePtrList trivial_args;
+    bool is_trivial = !is_right;
+    for (const auto &i : args) {
+      trivial_args.push_back(i->GetTrivialType());
+      if (trivial_args.back() != i) is_trivial = false;
+    }
+    auto trivial_ret = ret->GetTrivialType();
+    if (trivial_ret != ret) is_trivial = false;
+    auto type = std::make_shared<FuncType>(args, ret, is_right);
+    type->trivial_ = is_trivial ? type
+                                : GetFunc(trivial_args, trivial_ret, false);
+    return Insert(funcs_, key, std::move(type));
+  }
+
+  // create a new structure type
+  std::shared_ptr<StructType> NewStruct(TypePairList elems,
+                                        const std::string &id) {
+    auto body = std::make_shared<StructType::Body>();
+    body->id = id;
+    auto type = std::make_shared<StructType>(std::move(body), false);
+    type->body()->variants[0] = type;
+    type->set_elems(std::move(elems));
+    return type;
+  }
+
+  // get left/right value variant of structure type
+  TypePtr GetStructVariant(const StructType::BodyPtr &body,
+                           bool is_right) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &variant = body->variants[is_right];
+    if (auto type = variant.lock()) return type;
+    auto type = std::make_shared<StructType>(body, is_right);
+    variant = type;
+    return type;
+  }
+
+  // get trivial variant of structure type
+  TypePtr GetStructTrivial(const StructType::BodyPtr &body) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (auto type = body->trivial.lock()) return type;
+    // publish an empty structure first, so that recursive references
+    // to the current structure can be resolved
+    auto tbody = std::make_shared<StructType::Body>();
+    tbody->id = body->id;
+    auto type = std::make_shared<StructType>(tbody, false);
+    tbody->variants[0] = type;
+    tbody->trivial = type;
+    body->trivial = type;
+    lock.unlock();
+    // convert elements
+    TypePairList elems;
+    for (const auto &[name, ty] : body->elems) {
+      elems.push_back({name, ty->GetTrivialType()});
+    }
+    type->set_elems(std::move(elems));
+    return type;
+  }
+
+ private:
+  struct PointerKey {
+    const BaseType *base;
+    bool is_right;
+    bool operator==(const PointerKey &rhs) const {
+      return base == rhs.base && is_right == rhs.is_right;
+    }
+  };
+
+  struct ArrayKey {
+    const BaseType *base;
+    std::size_t len;
+    bool is_right;
+    bool operator==(const ArrayKey &rhs) const {
+      return base == rhs.base && len == rhs.len && is_right == rhs.is_right;
+    }
+  };
+
+  struct FuncKey {
+    std::vector<const BaseType *> args;
+    const BaseType *ret;
+    bool is_right;
+    bool operator==(const FuncKey &rhs) const {
+      return args == rhs.args && ret == rhs.ret && is_right == rhs.is_right;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const PointerKey &key) const {
+      return HashCombine(key.base, key.is_right);
+    }
+    std::size_t operator()(const ArrayKey &key) const {
+      return HashCombine(key.base, key.len, key.is_right);
+    }
+    std::size_t operator()(const FuncKey &key) const {
+      return HashCombine(HashCombineRange(key.args.begin(), key.args.end()),
+                         key.ret, key.is_right);
+    }
+    std::size_t operator()(const BaseType *key) const {
+      return std::hash<const BaseType *>()(key);
+    }
+  };
+
+  template <typename Key>
+  using TypeMap = std::unordered_map<Key, TypePtr, KeyHash>;
+
+  TypeContext() {
+    for (int i = 0; i <= static_cast<int>(PrimType::Type::UInt32); ++i) {
+      auto type = static_cast<PrimType::Type>(i);
+      auto left = std::make_shared<PrimType>(type, false);
+      auto right = std::make_shared<PrimType>(type, true);
+      left->trivial_ = left;
+      right->trivial_ = left;
+      prims_[i][0] = std::move(left);
+      prims_[i][1] = std::move(right);
+    }
+  }
+
+  // find type in the specific table, returns 'nullptr' if not found
+  template <typename Key>
+  TypePtr Find(const TypeMap<Key> &table, const Key &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = table.find(key);
+    return it != table.end() ? it->second : nullptr;
+  }
+
+  // insert type into the specific table, returns the interned type
+  template <typename Key>
+  TypePtr Insert(TypeMap<Key> &table, const Key &key, TypePtr type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return table.insert({key, std::move(type)}).first->second;
+  }
+
+  std::mutex mutex_;
+  TypePtr prims_[static_cast<int>(PrimType::Type::UInt32) + 1][2];
+  TypeMap<PointerKey> pointers_;
+  TypeMap<const BaseType *> consts_;
+  TypeMap<ArrayKey> arrays_;
+  TypeMap<FuncKey> funcs_;
+};
+
+}  // namespace mimic::define
 
 namespace {
 
 // used in 'StructType::IsIdentical' to prevent infinite loop
-std::stack<std::pair<const void *, const void *>> ident_types;
-// used in 'StructType::GetTrivialType' to prevent infinite loop
-std::stack<std::pair<const void *, TypePtr>> trivial_types;
+thread_local std::stack<std::pair<const void *, const void *>> ident_types;
+
+// get the type context
+inline TypeContext &Context() { return TypeContext::GetInstance(); }
 
 }  // namespace
 
@@ -22,6 +221,33 @@ std::stack<std::pair<const void *, TypePtr>> trivial_types;
 // default to 32-bit
 std::size_t BaseType::ptr_size_ = 4;
 
+TypePtr mimic::define::MakePrimType(PrimType::Type type, bool is_right) {
+  return Context().GetPrim(type, is_right);
+}
+
+TypePtr mimic::define::MakePointer(const TypePtr &type, bool is_right) {
+  return Context().GetPointer(type, is_right);
+}
+
+TypePtr mimic::define::MakeConst(const TypePtr &type) {
+  return Context().GetConst(type);
+}
+
+TypePtr mimic::define::MakeArray(const TypePtr &base, std::size_t len,
+                                 bool is_right) {
+  return Context().GetArray(base, len, is_right);
+}
+
+TypePtr mimic::define::MakeFunc(const TypePtrList &args, const TypePtr &ret,
+                                bool is_right) {
+  return Context().GetFunc(args, ret, is_right);
+}
+
+std::shared_ptr<StructType> mimic::define::MakeStruct(
+    TypePairList elems, const std::string &id) {
+  return Context().NewStruct(std::move(elems), id);
+}
+
 bool PrimType::CanAccept(const TypePtr &type) const {
   if (is_right_ || IsVoid()) return false;
   return type->IsInteger();
@@ -61,19 +287,7 @@ std::string PrimType::GetTypeId() const {
 }
 
 TypePtr PrimType::GetValueType(bool is_right) const {
-  return std::make_shared<PrimType>(type_, is_right);
-}
-
-void StructType::CalcSize() {
-  std::size_t sum = 0, max_base_size = 1;
-  for (const auto &[_, t] : elems_) {
-    sum += t->GetSize();
-    // update 'max_base_size'
-    auto base_size = t->GetAlignSize();
-    if (base_size > max_base_size) max_base_size = base_size;
-  }
-  size_ = (((sum - 1) / max_base_size) + 1) * max_base_size;
-  base_size_ = max_base_size;
+  return MakePrimType(type_, is_right);
 }
 
 bool StructType::CanAccept(const TypePtr &type) const {
@@ -81,6 +295,7 @@ bool StructType::CanAccept(const TypePtr &type) const {
 }
 
 bool StructType::IsIdentical(const TypePtr &type) const {
+  if (type.get() == this) return true;
   // check if is in recursion
   if (!ident_types.empty()) {
     const auto &[t1, t2] = ident_types.top();
@@ -94,63 +309,71 @@ bool StructType::IsIdentical(const TypePtr &type) const {
   auto pop = xstl::Guard([] { ident_types.pop(); });
   // check if is identical
   if (!type->IsStruct()) return false;
-  if (elems_.size() != type->GetLength()) return false;
-  for (std::size_t i = 0; i < elems_.size(); ++i) {
-    if (!elems_[i].second->IsIdentical(type->GetElem(i))) return false;
+  const auto &elems = body_->elems;
+  if (elems.size() != type->GetLength()) return false;
+  for (std::size_t i = 0; i < elems.size(); ++i) {
+    if (!elems[i].second->IsIdentical(type->GetElem(i))) return false;
   }
   return true;
 }
 
 TypePtr StructType::GetElem(const std::string &name) const {
-  for (const auto &[n, t] : elems_) if (name == n) return t;
+  for (const auto &[n, t] : body_->elems) if (name == n) return t;
   return nullptr;
 }
 
 std::optional<std::size_t> StructType::GetElemIndex(
     const std::string &name) const {
-  for (std::size_t i = 0; i < elems_.size(); ++i) {
-    if (elems_[i].first == name) return i;
+  const auto &elems = body_->elems;
+  for (std::size_t i = 0; i < elems.size(); ++i) {
+    if (elems[i].first == name) return i;
   }
   return {};
 }
 
 TypePtr StructType::GetValueType(bool is_right) const {
-  return std::make_shared<StructType>(elems_, id_, is_right);
+  return Context().GetStructVariant(body_, is_right);
 }
 
 TypePtr StructType::GetTrivialType() const {
-  // check if is in recursion
-  if (!trivial_types.empty() && trivial_types.top().first == this) {
-    return trivial_types.top().second;
+  return Context().GetStructTrivial(body_);
+}
+
+void StructType::set_elems(TypePairList elems) {
+  body_->elems = std::move(elems);
+  // update size
+  std::size_t sum = 0, max_base_size = 1;
+  for (const auto &[_, t] : body_->elems) {
+    sum += t->GetSize();
+    // update 'max_base_size'
+    auto base_size = t->GetAlignSize();
+    if (base_size > max_base_size) max_base_size = base_size;
   }
-  // initialize as an empty struct type
-  TypePairList elems;
-  auto type = std::make_shared<StructType>(elems, id_, false);
-  trivial_types.push({this, type});
-  // convert elements
-  for (const auto &i : elems_) {
-    elems.push_back({i.first, i.second->GetTrivialType()});
+  body_->size = (((sum - 1) / max_base_size) + 1) * max_base_size;
+  body_->base_size = max_base_size;
+  // update trivial variant
+  auto trivial = std::static_pointer_cast<StructType>(body_->trivial.lock());
+  if (trivial && trivial->body_ != body_) {
+    TypePairList trivial_elems;
+    for (const auto &[name, type] : body_->elems) {
+      trivial_elems.push_back({name, type->GetTrivialType()});
+    }
+    trivial->set_elems(std::move(trivial_elems));
   }
-  // update type
-  type->set_elems(std::move(elems));
-  trivial_types.pop();
-  return type;
 }
 
 TypePtr ConstType::GetElem(std::size_t index) const {
-  auto type = type_->GetElem(index);
-  return std::make_shared<ConstType>(std::move(type));
+  return MakeConst(type_->GetElem(index));
 }
 
 TypePtr ConstType::GetElem(const std::string &name) const {
   auto type = type_->GetElem(name);
   if (!type) return nullptr;
-  return std::make_shared<ConstType>(std::move(type));
+  return MakeConst(type);
 }
 
 TypePtr ConstType::GetValueType(bool is_right) const {
-  auto type = type_->GetValueType(is_right);
-  return std::make_shared<ConstType>(std::move(type));
+  return MakeConst(type_->GetValueType(is_right));
 }
 
 bool FuncType::CanAccept(const TypePtr &type) const {
@@ -163,6 +386,7 @@ bool FuncType::CanCastTo(const TypePtr &type) const {
 
 bool FuncType::IsIdentical(const TypePtr &type) const {
   if (!type->IsFunction()) return false;
+  if (trivial_ == type->GetTrivialType()) return true;
   auto ret = type->GetReturnType(args_);
   return ret ? ret_->IsIdentical(ret) : false;
 }
@@ -199,14 +423,7 @@ std::string FuncType::GetTypeId() const {
 }
 
 TypePtr FuncType::GetValueType(bool is_right) const {
-  return std::make_shared<FuncType>(args_, ret_, is_right);
-}
-
-TypePtr FuncType::GetTrivialType() const {
-  TypePtrList args;
-  for (const auto &i : args_) args.push_back(i->GetTrivialType());
-  return std::make_shared<FuncType>(std::move(args),
-                                    ret_->GetTrivialType(), false);
+  return MakeFunc(args_, ret_, is_right);
 }
 
 bool ArrayType::CanAccept(const TypePtr &type) const {
@@ -219,7 +436,9 @@ bool ArrayType::CanCastTo(const TypePtr &type) const {
 }
 
 bool ArrayType::IsIdentical(const TypePtr &type) const {
-  return type->IsArray() && base_->IsIdentical(type->GetDerefedType()) &&
+  if (!type->IsArray()) return false;
+  if (trivial_ == type->GetTrivialType()) return true;
+  return base_->IsIdentical(type->GetDerefedType()) &&
          len_ == type->GetLength();
 }
 
@@ -231,11 +450,7 @@ std::string ArrayType::GetTypeId() const {
 }
 
 TypePtr ArrayType::GetValueType(bool is_right) const {
-  return std::make_shared<ArrayType>(base_, len_, is_right);
-}
-
-TypePtr ArrayType::GetTrivialType() const {
-  return std::make_shared<ArrayType>(base_->GetTrivialType(), len_, false);
+  return MakeArray(base_, len_, is_right);
 }
 
 bool PointerType::CanAccept(const TypePtr &type) const {
@@ -254,7 +469,9 @@ bool PointerType::CanCastTo(const TypePtr &type) const {
 }
 
 bool PointerType::IsIdentical(const TypePtr &type) const {
-  return type->IsPointer() && base_->IsIdentical(type->GetDerefedType());
+  if (!type->IsPointer()) return false;
+  if (trivial_ == type->GetTrivialType()) return true;
+  return base_->IsIdentical(type->GetDerefedType());
 }
 
 std::size_t PointerType::GetSize() const {
@@ -269,9 +486,5 @@ std::string PointerType::GetTypeId() const {
 }
 
 TypePtr PointerType::GetValueType(bool is_right) const {
-  return std::make_shared<PointerType>(base_, is_right);
-}
-
-TypePtr PointerType::GetTrivialType() const {
-  return std::make_shared<PointerType>(base_->GetTrivialType(), false);
+  return MakePointer(base_, is_right);
 }
@@ -12,6 +12,8 @@
 #include <cstddef>
 #include <cassert>
 
+#include "utils/hashing.h"
+
 namespace mimic::define {
 
 // definition of base class of all types
@@ -86,6 +88,16 @@ class BaseType {
 
   // getters
   static std::size_t ptr_size() { return ptr_size_; }
+  // hash value of current type, consistent with 'GetTypeId'
+  std::size_t hash() const { return hash_; }
+
+ protected:
+  friend class TypeContext;
+
+  // hash value of current type
+  std::size_t hash_ = 0;
+  // trivial type of current type, set by type context
+  TypePtr trivial_;
 
  private:
   // size of pointer
@@ -100,7 +112,9 @@ class PrimType : public BaseType {
     UInt8, UInt32,
   };
 
-  PrimType(Type type, bool is_right) : type_(type), is_right_(is_right) {}
+  PrimType(Type type, bool is_right) : type_(type), is_right_(is_right) {
+    hash_ = utils::HashCombine('p', static_cast<int>(type));
+  }
 
   bool IsRightValue() const override { return is_right_; }
   bool IsVoid() const override { return type_ == Type::Void; }
@@ -135,7 +149,7 @@ class PrimType : public BaseType {
   }
   TypePtr GetDerefedType() const override { return nullptr; }
   TypePtr GetDeconstedType() const override { return nullptr; }
-  TypePtr GetTrivialType() const override { return GetValueType(false); }
+  TypePtr GetTrivialType() const override { return trivial_; }
 
   bool CanAccept(const TypePtr &type) const override;
   bool CanCastTo(const TypePtr &type) const override;
@@ -151,9 +165,21 @@ class PrimType : public BaseType {
 
 class StructType : public BaseType {
  public:
-  StructType(TypePairList elems, const std::string &id, bool is_right)
-      : elems_(std::move(elems)), id_(id), is_right_(is_right) {
-    CalcSize();
+  // body of structure, shared by all variants of the same structure
+  struct Body {
+    TypePairList elems;
+    std::string id;
+    std::size_t size, base_size;
+    // left/right value variants of the structure
+    std::weak_ptr<BaseType> variants[2];
+    // trivial variant of the structure
+    std::weak_ptr<BaseType> trivial;
+  };
+  using BodyPtr = std::shared_ptr<Body>;
+
+  StructType(BodyPtr body, bool is_right)
+      : body_(std::move(body)), is_right_(is_right) {
+    hash_ = utils::HashCombine('s', body_->id);
   }
 
   bool IsRightValue() const override { return is_right_; }
@@ -168,19 +194,19 @@ class StructType : public BaseType {
   bool CanCastTo(const TypePtr &type) const override {
     return IsIdentical(type);
   }
-  std::size_t GetSize() const override { return size_; }
-  std::size_t GetAlignSize() const override { return base_size_; }
+  std::size_t GetSize() const override { return body_->size; }
+  std::size_t GetAlignSize() const override { return body_->base_size; }
   std::optional<TypePtrList> GetArgsType() const override { return {}; }
   TypePtr GetReturnType(const TypePtrList &args) const override {
     return nullptr;
   }
-  std::size_t GetLength() const override { return elems_.size(); }
+  std::size_t GetLength() const override { return body_->elems.size(); }
   TypePtr GetElem(std::size_t index) const override {
-    return elems_[index].second;
+    return body_->elems[index].second;
   }
   TypePtr GetDerefedType() const override { return nullptr; }
   TypePtr GetDeconstedType() const override { return nullptr; }
-  std::string GetTypeId() const override { return id_; }
+  std::string GetTypeId() const override { return body_->id; }
 
   bool CanAccept(const TypePtr &type) const override;
   bool IsIdentical(const TypePtr &type) const override;
@@ -191,23 +217,22 @@ class StructType : public BaseType {
   TypePtr GetTrivialType() const override;
 
   // setters
-  void set_elems(TypePairList elems) {
-    elems_ = std::move(elems);
-    CalcSize();
-  }
+  // update elements of structure, affects all variants
+  void set_elems(TypePairList elems);
 
- private:
-  void CalcSize();
+  // getters
+  const BodyPtr &body() const { return body_; }
 
-  TypePairList elems_;
-  std::string id_;
+ private:
+  BodyPtr body_;
   bool is_right_;
-  std::size_t size_, base_size_;
 };
 
 class ConstType : public BaseType {
  public:
-  ConstType(TypePtr type) : type_(type) {}
+  ConstType(TypePtr type) : type_(std::move(type)) {
+    hash_ = type_->hash();
+  }
 
   bool IsRightValue() const override { return type_->IsRightValue(); }
   bool IsVoid() const override { return type_->IsVoid(); }
@@ -265,7 +290,12 @@ class FuncType : public BaseType {
  public:
   FuncType(TypePtrList args, TypePtr ret, bool is_right)
       : args_(std::move(args)), ret_(std::move(ret)),
-        is_right_(is_right) {}
+        is_right_(is_right) {
+    hash_ = utils::HashCombine('f', args_.size(), ret_->hash());
+    for (const auto &i : args_) {
+      hash_ = utils::HashCombine(hash_, i->hash());
+    }
+  }
 
   bool IsRightValue() const override { return is_right_; }
   bool IsVoid() const override { return false; }
@@ -289,6 +319,7 @@ class FuncType : public BaseType {
   }
   TypePtr GetDerefedType() const override { return nullptr; }
   TypePtr GetDeconstedType() const override { return nullptr; }
+  TypePtr GetTrivialType() const override { return trivial_; }
 
   bool CanAccept(const TypePtr &type) const override;
   bool CanCastTo(const TypePtr &type) const override;
@@ -297,7 +328,6 @@ class FuncType : public BaseType {
   TypePtr GetReturnType(const TypePtrList &args) const override;
   std::string GetTypeId() const override;
   TypePtr GetValueType(bool is_right) const override;
-  TypePtr GetTrivialType() const override;
 
  private:
   TypePtrList args_;
@@ -308,7 +338,9 @@ class FuncType : public BaseType {
 class ArrayType : public BaseType {
  public:
   ArrayType(TypePtr base, std::size_t len, bool is_right)
-      : base_(std::move(base)), len_(len), is_right_(is_right) {}
+      : base_(std::move(base)), len_(len), is_right_(is_right) {
+    hash_ = utils::HashCombine('a', len_, base_->hash());
+  }
 
   bool IsRightValue() const override { return is_right_; }
   bool IsVoid() const override { return false; }
@@ -340,13 +372,13 @@ class ArrayType : public BaseType {
   }
   TypePtr GetDerefedType() const override { return base_; }
   TypePtr GetDeconstedType() const override { return nullptr; }
+  TypePtr GetTrivialType() const override { return trivial_; }
 
   bool CanAccept(const TypePtr &type) const override;
   bool CanCastTo(const TypePtr &type) const override;
   bool IsIdentical(const TypePtr &type) const override;
   std::string GetTypeId() const override;
   TypePtr GetValueType(bool is_right) const override;
-  TypePtr GetTrivialType() const override;
 
  private:
   TypePtr base_;
@@ -357,7 +389,9 @@ class ArrayType : public BaseType {
 class PointerType : public BaseType {
  public:
   PointerType(TypePtr base, bool is_right)
-      : base_(std::move(base)), is_right_(is_right) {}
+      : base_(std::move(base)), is_right_(is_right) {
+    hash_ = utils::HashCombine('*', base_->hash());
+  }
 
   bool IsRightValue() const override { return is_right_; }
   bool IsVoid() const override { return false; }
@@ -384,6 +418,7 @@ class PointerType : public BaseType {
   }
   TypePtr GetDerefedType() const override { return base_; }
   TypePtr GetDeconstedType() const override { return nullptr; }
+  TypePtr GetTrivialType() const override { return trivial_; }
 
   bool CanAccept(const TypePtr &type) const override;
   bool CanCastTo(const TypePtr &type) const override;
@@ -391,33 +426,46 @@ class PointerType : public BaseType {
   std::size_t GetSize() const override;
   std::string GetTypeId() const override;
   TypePtr GetValueType(bool is_right) const override;
-  TypePtr GetTrivialType() const override;
 
  private:
   TypePtr base_;
   bool is_right_;
 };
 
-// create a new primitive type
-inline TypePtr MakePrimType(PrimType::Type type, bool is_right) {
-  return std::make_shared<PrimType>(type, is_right);
-}
+// all types except structures are interned by the type context,
+// so two types are the same if their pointers are equal
+// interned types will live as long as the program
 
-// create a new void type
+// get a primitive type
+TypePtr MakePrimType(PrimType::Type type, bool is_right);
+
+// get void type
 inline TypePtr MakeVoid() {
-  return std::make_shared<PrimType>(PrimType::Type::Void, true);
+  return MakePrimType(PrimType::Type::Void, true);
 }
 
-// create a new pointer type
-inline TypePtr MakePointer(const TypePtr &type, bool is_right) {
-  return std::make_shared<PointerType>(type, is_right);
-}
+// get a pointer type
+TypePtr MakePointer(const TypePtr &type, bool is_right);
 
-// create a new pointer type (right value)
+// get a pointer type (right value)
 inline TypePtr MakePointer(const TypePtr &type) {
-  return std::make_shared<PointerType>(type, true);
+  return MakePointer(type, true);
 }
 
+// get a constant type
+TypePtr MakeConst(const TypePtr &type);
+
+// get an array type
+TypePtr MakeArray(const TypePtr &base, std::size_t len, bool is_right);
+
+// get a function type
+TypePtr MakeFunc(const TypePtrList &args, const TypePtr &ret,
+                 bool is_right);
+
+// create a new structure type (left value)
+std::shared_ptr<StructType> MakeStruct(TypePairList elems,
+                                       const std::string &id);
+
 // get common type of two specific types
 // perform implicit casting of integer types
 inline const TypePtr &GetCommonType(const TypePtr &t1, const TypePtr &t2) {
@@ -0,0 +1,180 @@
+#include "driver/cache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#include <cctype>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+#include "utils/mmap.h"
+
+using namespace mimic::driver;
+using namespace mimic::utils;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// name of statistics file & its lock file
+constexpr const char *kStatsFile = "stats";
+constexpr const char *kStatsLockFile = "stats.lock";
+
+// entry file in cache directory
+struct Entry {
+  fs::path path;
+  std::uintmax_t size;
+  fs::file_time_type time;
+};
+
+// check if the specific file name is a name of entry
+bool IsEntryName(const std::string &name) {
+  return name.size() == 32 &&
+         std::all_of(name.begin(), name.end(), [](char c) {
+           return std::isdigit(c) || (c >= 'a' && c <= 'f');
+         });
+}
+
+// get all entries in the specific directory
+std::vector<Entry> GetEntries(const std::string &dir) {
+  std::vector<Entry> entries;
+  std::error_code ec;
+  for (const auto &i : fs::directory_iterator(dir, ec)) {
+    if (!IsEntryName(i.path().filename().string())) continue;
+    Entry entry = {i.path(), i.file_size(ec), i.last_write_time(ec)};
+    if (!ec && i.is_regular_file(ec)) entries.push_back(entry);
+  }
+  return entries;
+}
+
+}  // namespace
+
+void CompileCache::ResetKey() {
+  // offset basis of FNV-1a and the fractional part of golden ratio
+  key_[0] = 0xcbf29ce484222325;
+  key_[1] = 0x9e3779b97f4a7c15;
+}
+
+void CompileCache::AddKey(std::string_view data) {
+  // length is also hashed, so the boundary of data is kept
+  auto len = data.size();
+  for (std::size_t i = 0; i < sizeof(len); ++i) {
+    auto byte = static_cast<std::uint8_t>(len >> (i * 8));
+    key_[0] = (key_[0] ^ byte) * 0x100000001b3;
+    key_[1] = ((key_[1] ^ byte) * 0xff51afd7ed558ccd) ^ (key_[1] >> 29);
+  }
+  for (const auto &c : data) {
+    auto byte = static_cast<std::uint8_t>(c);
+    key_[0] = (key_[0] ^ byte) * 0x100000001b3;
+    key_[1] = ((key_[1] ^ byte) * 0xff51afd7ed558ccd) ^ (key_[1] >> 29);
+  }
+}
+
+bool CompileCache::Lookup(std::string &output) {
+  std::error_code ec;
+  fs::create_directories(dir_, ec);
+  // read entry
+  auto path = GetPath(key());
+  MappedFile file(path);
+  is_hit_ = file.valid();
+  if (is_hit_) {
+    output.assign(file.content());
+    // mark as the most recently used entry
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+  }
+  UpdateStats();
+  return is_hit_;
+}
+
+void CompileCache::Store(std::string_view output) {
+  // entry larger than the limit can not be stored
+  if (output.size() > max_size_) return;
+  if (WriteFile(key(), output)) Evict();
+}
+
+void CompileCache::DumpStats(std::ostream &os) const {
+  std::uintmax_t size = 0;
+  auto entries = GetEntries(dir_);
+  for (const auto &i : entries) size += i.size;
+  auto total = hits_ + misses_;
+  os << "cache " << (is_hit_ ? "hit" : "miss") << ": " << key()
+     << std::endl;
+  os << "  hits: " << hits_ << ", misses: " << misses_;
+  if (total) {
+    os << " (" << std::fixed << std::setprecision(1)
+       << hits_ * 100.0 / total << "% hit rate)";
+  }
+  os << std::endl;
+  os << "  entries: " << entries.size() << ", size: " << size << " / "
+     << max_size_ << " bytes" << std::endl;
+}
+
+std::string CompileCache::key() const {
+  std::ostringstream oss;
+  oss << std::hex << std::setfill('0');
+  for (const auto &i : key_) oss << std::setw(16) << i;
+  return oss.str();
+}
+
+std::string CompileCache::GetPath(std::string_view name) const {
+  return (fs::path(dir_) / name).string();
+}
+
+bool CompileCache::WriteFile(std::string_view name,
+                             std::string_view data) const {
+  // write to a temporary file first, then rename it
+  auto path = GetPath(name);
+  auto temp = path + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream ofs(temp, std::ios::binary);
+    if (!ofs) return false;
+    ofs.write(data.data(), data.size());
+    if (!ofs) {
+      ofs.close();
+      std::error_code ec;
+      fs::remove(temp, ec);
+      return false;
+    }
+  }
+  std::error_code ec;
+  fs::rename(temp, path, ec);
+  if (!ec) return true;
+  fs::remove(temp, ec);
+  return false;
+}
+
+void CompileCache::UpdateStats() {
+  // hold the lock during updating, so concurrent updates will not be lost
+  // the lock will be released when the file descriptor is closed
+  auto fd = open(GetPath(kStatsLockFile).c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd >= 0) flock(fd, LOCK_EX);
+  // read statistics
+  hits_ = misses_ = 0;
+  std::ifstream ifs(GetPath(kStatsFile));
+  if (!(ifs >> hits_ >> misses_)) hits_ = misses_ = 0;
+  // update statistics
+  ++(is_hit_ ? hits_ : misses_);
+  WriteFile(kStatsFile, std::to_string(hits_) + " " +
+                            std::to_string(misses_) + "\n");
+  if (fd >= 0) close(fd);
+}
+
+void CompileCache::Evict() const {
+  auto entries = GetEntries(dir_);
+  std::uintmax_t size = 0;
+  for (const auto &i : entries) size += i.size;
+  if (size <= max_size_) return;
+  // remove entries from the least recently used one
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &l, const Entry &r) { return l.time < r.time; });
+  for (const auto &i : entries) {
+    if (size <= max_size_) break;
+    std::error_code ec;
+    if (fs::remove(i.path, ec)) size -= i.size;
+  }
+}
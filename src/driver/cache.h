@@ -0,0 +1,70 @@
+#ifndef MIMIC_DRIVER_CACHE_H_
+#define MIMIC_DRIVER_CACHE_H_
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+namespace mimic::driver {
+
+/*
+  content-addressed on-disk cache of compilation outputs
+
+  key of an entry is the hash of all inputs of the compilation (source
+  file, compiler version, options, ...), and each entry is stored as a
+  single file named by its key in the cache directory. modification
+  time of entry files is used as the LRU order, least recently used
+  entries will be evicted when total size exceeds the limit.
+
+  entries and statistics are replaced by renaming, so concurrent
+  compilers sharing the same cache will never see partial files, and
+  statistics are updated while holding a file lock ('flock'), so no
+  update will be lost.
+*/
+class CompileCache {
+ public:
+  CompileCache(const std::string &dir, std::size_t max_size)
+      : dir_(dir), max_size_(max_size), is_hit_(false), hits_(0),
+        misses_(0) {
+    ResetKey();
+  }
+
+  // add a piece of input data to the key
+  void AddKey(std::string_view data);
+  // look up the output of current key, returns false if missed
+  bool Lookup(std::string &output);
+  // store the output of current key, and evict old entries
+  void Store(std::string_view output);
+  // dump statistics of cache
+  void DumpStats(std::ostream &os) const;
+
+  // getters
+  // hexadecimal string of current key
+  std::string key() const;
+
+ private:
+  // reset current key to the initial state
+  void ResetKey();
+  // path of the specific file in cache directory
+  std::string GetPath(std::string_view name) const;
+  // write file to cache directory atomically, returns false if failed
+  bool WriteFile(std::string_view name, std::string_view data) const;
+  // read & update statistics
+  void UpdateStats();
+  // remove least recently used entries until size does not exceed limit
+  void Evict() const;
+
+  std::string dir_;
+  std::size_t max_size_;
+  // two lanes of 64-bit hash
+  std::uint64_t key_[2];
+  // statistics
+  bool is_hit_;
+  std::size_t hits_, misses_;
+};
+
+}  // namespace mimic::driver
+
+#endif  // MIMIC_DRIVER_CACHE_H_
@@ -1,5 +1,6 @@
 #include "driver/compiler.h"
 
+#include <fstream>
 #include <cstdlib>
 
 #include "front/logger.h"
@@ -8,6 +9,7 @@ using namespace mimic::driver;
 using namespace mimic::front;
 using namespace mimic::opt;
 using namespace mimic::back;
+using namespace mimic::utils;
 
 void Compiler::Reset() {
   // reset lexer & parser
@@ -24,31 +26,119 @@ void Compiler::Open(std::istream *in) {
   parser_.Reset();
 }
 
+void Compiler::Open(std::string_view buf) {
+  lexer_.Reset(buf);
+  parser_.Reset();
+}
+
 void Compiler::CompileToIR() {
-  while (auto ast = parser_.ParseNext()) {
+  Timer parse_timer, sema_timer, irgen_timer;
+  auto lex_time = lex_timer_.elapsed();
+  for (;;) {
+    parse_timer.Start();
+    auto ast = parser_.ParseNext();
+    parse_timer.Stop();
+    if (!ast) break;
     // perform sematic analyze
+    sema_timer.Start();
     if (!ast->SemaAnalyze(ana_)) break;
     ast->Eval(eval_);
+    sema_timer.Stop();
     if (dump_ast_) ast->Dump(*os_);
     // generate IR
+    irgen_timer.Start();
     ast->GenerateIR(irb_);
+    irgen_timer.Stop();
+  }
+  // update time report
+  if (is_time_report_enabled()) {
+    lex_time = lex_timer_.elapsed() - lex_time;
+    time_report_.AddTime("phases", "lex", lex_time);
+    time_report_.AddTime("phases", "parse",
+                         parse_timer.elapsed() - lex_time);
+    time_report_.AddTime("phases", "sema", sema_timer.elapsed());
+    time_report_.AddTime("phases", "irgen", irgen_timer.elapsed());
   }
   // check if need to exit
   auto err_num = Logger::error_num();
-  if (err_num) std::exit(err_num);
+  if (err_num) Exit(err_num);
+}
+
+void Compiler::LoadIR(std::string_view buf) {
+  Timer timer;
+  timer.Start();
+  auto is_bin = irb_.module().IsSerialized(buf);
+  auto ret = is_bin ? irb_.module().Deserialize(buf, ir_src_file_)
+                    : irb_.module().Parse(buf);
+  timer.Stop();
+  if (is_time_report_enabled()) {
+    time_report_.AddTime("phases", "irload", timer.elapsed());
+  }
+  if (!ret) {
+    if (is_bin) Logger::LogRawError("invalid binary IR");
+    Exit(1);
+  }
+  // report errors with the original source file name
+  if (is_bin) Logger::set_file(ir_src_file_);
 }
 
 void Compiler::RunPasses() {
   // run passes on IR
   if (dump_pass_info_) pass_man_.ShowInfo(std::cerr);
+  Timer timer;
+  timer.Start();
   irb_.module().RunPasses(pass_man_);
+  timer.Stop();
+  if (is_time_report_enabled()) {
+    time_report_.AddTime("phases", "opt", timer.elapsed());
+  }
   // check if need to dump IR
   auto err_num = Logger::error_num();
   if (!err_num && dump_yuir_) irb_.module().Dump(*os_);
-  if (!pass_man_.is_stage_last() || err_num) std::exit(err_num);
+  if (!err_num && dump_yuir_bin_) {
+    irb_.module().Serialize(*os_);
+    // output stream will not be flushed if compiler exits here
+    os_->flush();
+  }
+  if (!pass_man_.is_stage_last() || err_num) Exit(err_num);
 }
 
 void Compiler::GenerateCode(CodeGen &gen) {
+  Timer gen_timer, emit_timer;
+  gen_timer.Start();
   irb_.module().GenerateCode(gen);
+  // machine passes (register allocation, ...) are part of code generation
+  if (dump_code_) gen.RunPasses();
+  gen_timer.Stop();
+  emit_timer.Start();
   if (dump_code_) gen.Dump(*os_);
+  emit_timer.Stop();
+  if (is_time_report_enabled()) {
+    time_report_.AddTime("phases", "codegen", gen_timer.elapsed());
+    time_report_.AddTime("phases", "emit", emit_timer.elapsed());
+  }
+}
+
+void Compiler::DumpTimeReport() const {
+  if (dump_time_report_) time_report_.Dump(std::cerr);
+  if (!time_report_file_.empty()) {
+    std::ofstream ofs(time_report_file_);
+    if (!ofs) {
+      Logger::LogRawError("failed to open time report file");
+    }
+    else {
+      time_report_.DumpJSON(ofs);
+    }
+  }
+}
+
+void Compiler::UpdateTimeReport() {
+  auto enabled = is_time_report_enabled();
+  parser_.set_lex_timer(enabled ? &lex_timer_ : nullptr);
+  pass_man_.set_time_report(enabled ? &time_report_ : nullptr);
+}
+
+void Compiler::Exit(int code) const {
+  DumpTimeReport();
+  std::exit(code);
 }
@@ -3,6 +3,8 @@
 
 #include <istream>
 #include <ostream>
+#include <string_view>
+#include <string>
 #include <iostream>
 #include <cassert>
 
@@ -13,6 +15,7 @@
 #include "mid/irbuilder.h"
 #include "opt/passman.h"
 #include "back/codegen.h"
+#include "utils/timereport.h"
 
 namespace mimic::driver {
 
@@ -21,9 +24,9 @@ class Compiler {
  public:
   Compiler()
       : parser_(lexer_), ana_(eval_),
-        dump_ast_(false), dump_yuir_(false),
+        dump_ast_(false), dump_yuir_(false), dump_yuir_bin_(false),
         dump_pass_info_(false), dump_code_(false),
-        os_(&std::cout) {
+        dump_time_report_(false), os_(&std::cout) {
     Reset();
   }
 
@@ -31,24 +34,47 @@ class Compiler {
   void Reset();
   // open stream
   void Open(std::istream *in);
+  // open buffer
+  // NOTE: buffer must be kept alive until compilation is done
+  void Open(std::string_view buf);
   // compile stream to IR, return false if failed
   void CompileToIR();
+  // load IR from binary/textual IR instead of compiling
+  void LoadIR(std::string_view buf);
   // run passes on IRs
   void RunPasses();
   // generate target code
   void GenerateCode(back::CodeGen &gen);
+  // dump time report to standard error and the report file
+  // if time report is enabled
+  void DumpTimeReport() const;
 
   // setters
   void set_opt_level(std::size_t opt_level) {
     pass_man_.set_opt_level(opt_level);
   }
   void set_stage(opt::PassStage stage) { pass_man_.set_stage(stage); }
+  void set_thread_count(std::size_t thread_count) {
+    pass_man_.set_thread_count(thread_count);
+  }
   void set_dump_ast(bool dump_ast) { dump_ast_ = dump_ast; }
   void set_dump_yuir(bool dump_yuir) { dump_yuir_ = dump_yuir; }
+  void set_dump_yuir_bin(bool dump_yuir_bin) {
+    dump_yuir_bin_ = dump_yuir_bin;
+  }
   void set_dump_pass_info(bool dump_pass_info) {
     dump_pass_info_ = dump_pass_info;
   }
   void set_dump_code(bool dump_code) { dump_code_ = dump_code; }
+  void set_dump_time_report(bool dump_time_report) {
+    dump_time_report_ = dump_time_report;
+    UpdateTimeReport();
+  }
+  // set file for dumping time report in JSON, empty to disable
+  void set_time_report_file(const std::string &time_report_file) {
+    time_report_file_ = time_report_file;
+    UpdateTimeReport();
+  }
   void set_ostream(std::ostream *os) {
     assert(os);
     os_ = os;
@@ -56,12 +82,28 @@ class Compiler {
 
   // getters
   std::size_t opt_level() const { return pass_man_.opt_level(); }
+  std::size_t thread_count() const { return pass_man_.thread_count(); }
   bool dump_ast() const { return dump_ast_; }
   bool dump_yuir() const { return dump_yuir_; }
+  bool dump_yuir_bin() const { return dump_yuir_bin_; }
   bool dump_pass_info() const { return dump_pass_info_; }
   bool dump_code() const { return dump_code_; }
+  // time report, 'nullptr' if time report is disabled
+  utils::TimeReport *time_report() {
+    return is_time_report_enabled() ? &time_report_ : nullptr;
+  }
 
  private:
+  // enable/disable recording time of phases & passes
+  void UpdateTimeReport();
+  // dump time report and exit
+  [[noreturn]] void Exit(int code) const;
+
+  // private getters
+  bool is_time_report_enabled() const {
+    return dump_time_report_ || !time_report_file_.empty();
+  }
+
   front::Lexer lexer_;
   front::Parser parser_;
   mid::Evaluator eval_;
@@ -69,8 +111,15 @@ class Compiler {
   mid::IRBuilder irb_;
   opt::PassManager pass_man_;
   // options
-  bool dump_ast_, dump_yuir_, dump_pass_info_, dump_code_;
+  bool dump_ast_, dump_yuir_, dump_yuir_bin_, dump_pass_info_, dump_code_;
+  bool dump_time_report_;
+  std::string time_report_file_;
   std::ostream *os_;
+  // time report of phases & passes
+  utils::TimeReport time_report_;
+  utils::Timer lex_timer_;
+  // source file name recorded in binary IR
+  std::string ir_src_file_;
 };
 
 }  // namespace mimic::driver
@@ -0,0 +1,291 @@
+#include "driver/server.h"
+
+#include <filesystem>
+#include <unordered_map>
+#include <system_error>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <csignal>
+
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include "front/logger.h"
+
+using namespace mimic::driver;
+using namespace mimic::front;
+
+namespace {
+
+// count of standard I/O file descriptors
+constexpr int kStdFdCount = 3;
+// maximum size of request payload
+constexpr std::uint32_t kMaxPayloadSize = 1 << 20;
+
+// set when server should stop
+volatile std::sig_atomic_t stop_server = 0;
+
+void StopServer(int) { stop_server = 1; }
+
+// get address of the specific socket, returns false if path is too long
+bool GetAddress(const std::string &path, sockaddr_un &addr) {
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) return false;
+  std::memcpy(addr.sun_path, path.c_str(), path.size());
+  return true;
+}
+
+// read all bytes from socket, returns false if failed
+bool ReadAll(int fd, void *buf, std::size_t len) {
+  auto ptr = static_cast<char *>(buf);
+  while (len) {
+    auto ret = read(fd, ptr, len);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) return false;
+    ptr += ret;
+    len -= ret;
+  }
+  return true;
+}
+
+// write all bytes to socket, returns false if failed
+bool WriteAll(int fd, const void *buf, std::size_t len) {
+  auto ptr = static_cast<const char *>(buf);
+  while (len) {
+    auto ret = send(fd, ptr, len, MSG_NOSIGNAL);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) return false;
+    ptr += ret;
+    len -= ret;
+  }
+  return true;
+}
+
+// send size of payload along with standard I/O file descriptors
+bool SendHeader(int fd, std::uint32_t size, const int *fds) {
+  iovec iov = {&size, sizeof(size)};
+  alignas(cmsghdr) char ctrl[CMSG_SPACE(sizeof(int) * kStdFdCount)] = {};
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = ctrl;
+  msg.msg_controllen = sizeof(ctrl);
+  auto cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int) * kStdFdCount);
+  std::memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * kStdFdCount);
+  ssize_t ret;
+  while ((ret = sendmsg(fd, &msg, MSG_NOSIGNAL)) < 0 && errno == EINTR) {}
+  return ret == sizeof(size);
+}
+
+// receive size of payload and standard I/O file descriptors
+bool RecvHeader(int fd, std::uint32_t &size, int *fds) {
+  iovec iov = {&size, sizeof(size)};
+  alignas(cmsghdr) char ctrl[CMSG_SPACE(sizeof(int) * kStdFdCount)] = {};
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = ctrl;
+  msg.msg_controllen = sizeof(ctrl);
+  ssize_t ret;
+  while ((ret = recvmsg(fd, &msg, 0)) < 0 && errno == EINTR) {}
+  if (ret != sizeof(size)) return false;
+  auto cmsg = CMSG_FIRSTHDR(&msg);
+  if (!cmsg || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS ||
+      cmsg->cmsg_len != CMSG_LEN(sizeof(int) * kStdFdCount)) {
+    return false;
+  }
+  std::memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * kStdFdCount);
+  return true;
+}
+
+// send exit code of handler process back to client, and close connection
+void SendExitCode(int conn, int status) {
+  std::int32_t code = WIFEXITED(status) ? WEXITSTATUS(status)
+                                        : 128 + WTERMSIG(status);
+  WriteAll(conn, &code, sizeof(code));
+  close(conn);
+}
+
+}  // namespace
+
+CompileServer::~CompileServer() {
+  if (fd_ < 0) return;
+  close(fd_);
+  unlink(path_.c_str());
+}
+
+bool CompileServer::Listen() {
+  sockaddr_un addr;
+  if (!GetAddress(path_, addr)) return false;
+  struct stat st;
+  if (!lstat(path_.c_str(), &st) && S_ISSOCK(st.st_mode)) {
+    // check if there is a server listening on the socket
+    auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    auto ret = connect(fd, reinterpret_cast<sockaddr *>(&addr),
+                       sizeof(addr));
+    auto err = errno;
+    close(fd);
+    if (!ret) {
+      Logger::LogRawError("compile server is already running");
+      return false;
+    }
+    // remove the socket left by the previous server
+    if (err != ECONNREFUSED) return false;
+    unlink(path_.c_str());
+  }
+  fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd_ < 0) return false;
+  if (bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+      listen(fd_, SOMAXCONN) < 0) {
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  return true;
+}
+
+void CompileServer::Serve(const Handler &handler) {
+  // block signals, they are only delivered when waiting for connections
+  // so that no exited handler process will be missed
+  struct sigaction sa = {};
+  sa.sa_handler = StopServer;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGINT, &sa, nullptr);
+  sigaction(SIGTERM, &sa, nullptr);
+  sa.sa_handler = [](int) {};
+  sigaction(SIGCHLD, &sa, nullptr);
+  sigset_t mask, orig_mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGINT);
+  sigaddset(&mask, SIGTERM);
+  sigaddset(&mask, SIGCHLD);
+  sigprocmask(SIG_BLOCK, &mask, &orig_mask);
+  // connections of running handler processes
+  std::unordered_map<pid_t, int> conns;
+  for (;;) {
+    // send exit codes of all exited handlers back to clients
+    pid_t pid;
+    int status;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+      auto it = conns.find(pid);
+      if (it == conns.end()) continue;
+      SendExitCode(it->second, status);
+      conns.erase(it);
+    }
+    if (stop_server) break;
+    // wait for new connection
+    pollfd pfd = {fd_, POLLIN, 0};
+    if (ppoll(&pfd, 1, nullptr, &orig_mask) <= 0) continue;
+    auto conn = accept(fd_, nullptr, nullptr);
+    if (conn < 0) continue;
+    // make sure that buffered output will not be written twice
+    std::cout.flush();
+    std::cerr.flush();
+    pid = fork();
+    if (!pid) {
+      // restore signals and close all sockets in handler process
+      std::signal(SIGINT, SIG_DFL);
+      std::signal(SIGTERM, SIG_DFL);
+      std::signal(SIGCHLD, SIG_DFL);
+      sigprocmask(SIG_SETMASK, &orig_mask, nullptr);
+      close(fd_);
+      for (const auto &i : conns) close(i.second);
+      HandleConnection(conn, handler);
+    }
+    if (pid < 0) {
+      Logger::LogRawError("failed to create handler process");
+      close(conn);
+    }
+    else {
+      conns.insert({pid, conn});
+    }
+  }
+  // wait for running handlers
+  for (const auto &[pid, conn] : conns) {
+    int status;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    SendExitCode(conn, status);
+  }
+  sigprocmask(SIG_SETMASK, &orig_mask, nullptr);
+}
+
+void CompileServer::HandleConnection(int conn, const Handler &handler) {
+  // receive request
+  std::uint32_t size;
+  int fds[kStdFdCount];
+  if (!RecvHeader(conn, size, fds)) std::_Exit(1);
+  if (size > kMaxPayloadSize) std::_Exit(1);
+  std::string payload(size, '\0');
+  if (!ReadAll(conn, payload.data(), size)) std::_Exit(1);
+  close(conn);
+  // get working directory and arguments
+  ArgList args;
+  for (std::size_t pos = 0; pos < payload.size();) {
+    auto end = payload.find('\0', pos);
+    if (end == std::string::npos) std::_Exit(1);
+    args.push_back(payload.substr(pos, end - pos));
+    pos = end + 1;
+  }
+  if (args.size() < 2) std::_Exit(1);
+  // run handler with standard I/O and working directory of client
+  for (int i = 0; i < kStdFdCount; ++i) {
+    dup2(fds[i], i);
+    close(fds[i]);
+  }
+  if (chdir(args.front().c_str()) < 0) {
+    Logger::LogRawError("invalid working directory");
+    std::exit(1);
+  }
+  args.erase(args.begin());
+  std::exit(handler(args));
+}
+
+bool mimic::driver::RequestCompileServer(const std::string &path,
+                                         int argc, const char *argv[],
+                                         int &code) {
+  sockaddr_un addr;
+  if (!GetAddress(path, addr)) return false;
+  auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return false;
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+    close(fd);
+    return false;
+  }
+  // send request
+  std::error_code ec;
+  auto payload = std::filesystem::current_path(ec).string();
+  payload.push_back('\0');
+  for (int i = 0; i < argc; ++i) {
+    payload += argv[i];
+    payload.push_back('\0');
+  }
+  int fds[kStdFdCount] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+  if (ec || payload.size() > kMaxPayloadSize ||
+      !SendHeader(fd, payload.size(), fds) ||
+      !WriteAll(fd, payload.data(), payload.size())) {
+    close(fd);
+    return false;
+  }
+  // wait for exit code
+  std::int32_t ret;
+  if (!ReadAll(fd, &ret, sizeof(ret))) {
+    Logger::LogRawError("lost connection to compile server");
+    ret = 1;
+  }
+  close(fd);
+  code = ret;
+  return true;
+}
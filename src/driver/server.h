@@ -0,0 +1,54 @@
+#ifndef MIMIC_DRIVER_SERVER_H_
+#define MIMIC_DRIVER_SERVER_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace mimic::driver {
+
+/*
+  compile server listening on a local UNIX socket
+
+  client sends its working directory, command line arguments and
+  standard I/O file descriptors to server, server handles each request
+  in a process forked from itself, so all states prepared before
+  serving (registered passes, analysed pre-declared functions, ...)
+  are reused, and the handler reads/writes files and prints messages
+  just like it's running in the client process. after the handler
+  process exits, its exit code will be sent back to client by server.
+*/
+class CompileServer {
+ public:
+  using ArgList = std::vector<std::string>;
+  // handler of requests, returns exit code
+  using Handler = std::function<int(const ArgList &args)>;
+
+  CompileServer(const std::string &path) : path_(path), fd_(-1) {}
+  CompileServer(const CompileServer &) = delete;
+  CompileServer &operator=(const CompileServer &) = delete;
+  ~CompileServer();
+
+  // start listening on socket, returns false if failed
+  // or another server is already listening on the socket
+  bool Listen();
+  // serve requests until receiving 'SIGINT' or 'SIGTERM'
+  void Serve(const Handler &handler);
+
+ private:
+  // handle a connection in the forked handler process
+  [[noreturn]] void HandleConnection(int conn, const Handler &handler);
+
+  std::string path_;
+  int fd_;
+};
+
+// send compile request to the compile server listening on the socket
+// returns false if server is unavailable, otherwise the exit code of
+// handler will be stored in 'code'
+bool RequestCompileServer(const std::string &path, int argc,
+                          const char *argv[], int &code);
+
+}  // namespace mimic::driver
+
+#endif  // MIMIC_DRIVER_SERVER_H_
@@ -1,9 +1,10 @@
 #include "front/lexer.h"
 
 #include <cstddef>
-#include <cstring>
+#include <cstdint>
 #include <cstdlib>
 #include <cctype>
+#include <iterator>
 
 using namespace mimic::front;
 
@@ -13,17 +14,64 @@ enum class NumberType {
   Normal, Hex, Oct,
 };
 
-const char *kKeywords[] = {MIMIC_KEYWORDS(MIMIC_EXPAND_SECOND)};
-const char *kOperators[] = {MIMIC_OPERATORS(MIMIC_EXPAND_SECOND)};
+// perfect hash table of strings, built at compile time
+// 'Size' must be a power of two
+template <std::size_t N, std::size_t Size>
+class StrTable {
+ public:
+  constexpr StrTable(const char *const (&strs)[N])
+      : strs_(), slots_(), seed_(0) {
+    for (std::size_t i = 0; i < N; ++i) strs_[i] = strs[i];
+    // find a seed that makes the hash function perfect
+    while (!TryBuild()) ++seed_;
+  }
 
-// get index of a string in string array
-template <typename T, std::size_t N>
-int GetIndex(const char *str, T (&str_array)[N]) {
-  for (std::size_t i = 0; i < N; ++i) {
-    if (!std::strcmp(str, str_array[i])) return i;
+  // get index of the specific string, returns -1 if not found
+  constexpr int Find(std::string_view str) const {
+    auto index = slots_[Hash(str, seed_)];
+    return index >= 0 && strs_[index] == str ? index : -1;
   }
-  return -1;
-}
+
+ private:
+  static_assert(Size && !(Size & (Size - 1)), "invalid table size");
+  static_assert(N <= Size, "table size is too small");
+
+  // FNV-1a
+  static constexpr std::size_t Hash(std::string_view str,
+                                    std::uint32_t seed) {
+    std::uint32_t hash = 2166136261u ^ seed;
+    for (const auto &c : str) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    // fold high bits, since low bits of FNV hash are poorly mixed
+    return (hash ^ (hash >> 16)) & (Size - 1);
+  }
+
+  // try to fill all slots using current seed
+  // returns false if there are collisions
+  constexpr bool TryBuild() {
+    for (auto &i : slots_) i = -1;
+    for (std::size_t i = 0; i < N; ++i) {
+      auto &slot = slots_[Hash(strs_[i], seed_)];
+      if (slot >= 0) return false;
+      slot = i;
+    }
+    return true;
+  }
+
+  std::string_view strs_[N];
+  int slots_[Size];
+  std::uint32_t seed_;
+};
+
+constexpr const char *kKeywords[] = {MIMIC_KEYWORDS(MIMIC_EXPAND_SECOND)};
+constexpr const char *kOperators[] = {
+  MIMIC_OPERATORS(MIMIC_EXPAND_SECOND)
+};
+
+// lookup tables of keywords and operators
+constexpr StrTable<std::size(kKeywords), 64> kKeywordTable(kKeywords);
+constexpr StrTable<std::size(kOperators), 128> kOperatorTable(kOperators);
 
 bool IsOperatorHeadChar(char c) {
   const char op_head_chars[] = "+-*/%=!<>&|~^.";
@@ -82,20 +130,16 @@ int Lexer::ReadEscape() {
 }
 
 void Lexer::SkipSpaces() {
-  while (!IsEOL() && std::isspace(last_char_)) NextChar();
+  ReadWhile([](char c) { return std::isspace(c); });
 }
 
 Token Lexer::HandleId() {
   // read string
-  std::string id;
-  do {
-    id += last_char_;
-    NextChar();
-  } while (!IsEOL() && (std::isalnum(last_char_) || last_char_ == '_'));
+  auto id = ReadWhile([](char c) { return std::isalnum(c) || c == '_'; });
   // check if string is keyword
-  int index = GetIndex(id.c_str(), kKeywords);
+  int index = kKeywordTable.Find(id);
   if (index < 0) {
-    id_val_ = id;
+    id_val_ = Symbol(id);
     return Token::Id;
   }
   else {
@@ -105,7 +149,6 @@ Token Lexer::HandleId() {
 }
 
 Token Lexer::HandleNum() {
-  std::string num;
   NumberType num_type = NumberType::Normal;
   // check if is hexadecimal/octal number
   if (last_char_ == '0') {
@@ -121,10 +164,7 @@ Token Lexer::HandleNum() {
     }
   }
   // read number string
-  while (!IsEOL() && std::isxdigit(last_char_)) {
-    num += last_char_;
-    NextChar();
-  }
+  std::string num(ReadWhile([](char c) { return std::isxdigit(c); }));
   // convert to number
   char *end_pos;
   switch (num_type) {
@@ -189,24 +229,21 @@ Token Lexer::HandleChar() {
 }
 
 Token Lexer::HandleOperator() {
-  std::string op;
   // read first char
-  op += last_char_;
+  auto begin = cur_ - 1;
   NextChar();
   // check if is comment
-  if (op[0] == '/' && !IsEOL()) {
+  if (*begin == '/' && !IsEOL()) {
     switch (last_char_) {
       case '/': return HandleComment();
       case '*': return HandleBlockComment();
     }
   }
   // read rest chars
-  while (!IsEOL() && IsOperatorChar(last_char_)) {
-    op += last_char_;
-    NextChar();
-  }
+  auto rest = ReadWhile(IsOperatorChar);
+  std::string_view op(begin, rest.size() + 1);
   // check if operator is valid
-  int index = GetIndex(op.c_str(), kOperators);
+  int index = kOperatorTable.Find(op);
   if (index < 0) {
     return LogError("unknown operator");
   }
@@ -219,7 +256,7 @@ Token Lexer::HandleOperator() {
 Token Lexer::HandleComment() {
   // eat '/'
   NextChar();
-  while (!IsEOL()) NextChar();
+  ReadWhile([](char) { return true; });
   return NextToken();
 }
 
@@ -251,15 +288,30 @@ Token Lexer::HandleEOL() {
 void Lexer::Reset() {
   logger_.Reset();
   last_char_ = ' ';
-  if (!in_) return;
-  // reset status of file stream
-  in_->clear();
-  in_->seekg(0, std::ios::beg);
-  *in_ >> std::noskipws;
+  cur_ = begin_;
+  eof_ = !begin_;
 }
 
 void Lexer::Reset(std::istream *in) {
-  in_ = in;
+  if (in) {
+    // read the whole stream in one shot
+    buffer_.assign(std::istreambuf_iterator<char>(*in),
+                   std::istreambuf_iterator<char>());
+    begin_ = buffer_.data();
+    end_ = begin_ + buffer_.size();
+  }
+  else {
+    buffer_.clear();
+    begin_ = end_ = nullptr;
+  }
+  Reset();
+}
+
+void Lexer::Reset(std::string_view buf) {
+  buffer_.clear();
+  // make sure that 'begin_' is not null
+  begin_ = buf.empty() ? "" : buf.data();
+  end_ = begin_ + buf.size();
   Reset();
 }
 
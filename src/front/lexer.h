@@ -4,10 +4,12 @@
 #include <istream>
 #include <string_view>
 #include <string>
+#include <cstddef>
 #include <cstdint>
 
 #include "front/token.h"
 #include "front/logger.h"
+#include "front/symbol.h"
 
 namespace mimic::front {
 
@@ -15,18 +17,23 @@ class Lexer {
  public:
   Lexer() : logger_() { Reset(nullptr); }
   Lexer(std::istream *in) : logger_() { Reset(in); }
+  Lexer(std::string_view buf) : logger_() { Reset(buf); }
 
   // reset lexer status
   void Reset();
   // reset lexer status (including input stream)
+  // content of stream will be read into an internal buffer
   void Reset(std::istream *in);
-  // get next token from input stream
+  // reset lexer status (including input buffer)
+  // NOTE: lexer does not own the buffer
+  void Reset(std::string_view buf);
+  // get next token from input buffer
   Token NextToken();
 
   // current logger
   const Logger &logger() const { return logger_; }
   // identifiers
-  const std::string &id_val() const { return id_val_; }
+  Symbol id_val() const { return id_val_; }
   // integer values
   std::uint32_t int_val() const { return int_val_; }
   // string literals
@@ -41,15 +48,40 @@ class Lexer {
   char other_val() const { return other_val_; }
 
  private:
-  bool IsEOF() { return !in_ || in_->eof(); }
-  bool IsEOL() {
-    return IsEOF() || last_char_ == '\n' || last_char_ == '\r';
-  }
+  static bool IsEOLChar(char c) { return c == '\n' || c == '\r'; }
+
+  bool IsEOF() { return eof_; }
+  bool IsEOL() { return IsEOF() || IsEOLChar(last_char_); }
   void NextChar() {
     if (IsEOF()) return;
-    *in_ >> last_char_;
+    if (cur_ == end_) {
+      eof_ = true;
+    }
+    else {
+      last_char_ = *cur_++;
+    }
     logger_.IncreaseColPos();
   }
+  // read characters until predicate fails or reaches EOL,
+  // starting with the current character
+  // returns all characters that satisfy the predicate
+  template <typename Pred>
+  std::string_view ReadWhile(Pred pred) {
+    if (IsEOL() || !pred(last_char_)) return {};
+    // the initial character after reset is not in the buffer
+    auto begin = cur_ == begin_ ? nullptr : cur_ - 1, pos = cur_;
+    // scan buffer directly
+    while (pos != end_ && !IsEOLChar(*pos) && pred(*pos)) ++pos;
+    if (pos != cur_) {
+      logger_.IncreaseColPos(pos - cur_);
+      cur_ = pos;
+      last_char_ = pos[-1];
+    }
+    // read the first character that does not satisfy the predicate
+    NextChar();
+    if (!begin) return {};
+    return {begin, static_cast<std::size_t>(pos - begin)};
+  }
 
   // print error message and return Token::Error
   Token LogError(std::string_view message);
@@ -68,11 +100,15 @@ class Lexer {
   Token HandleBlockComment();
   Token HandleEOL();
 
-  std::istream *in_;
+  // input buffer
+  std::string buffer_;
+  const char *begin_, *cur_, *end_;
+  bool eof_;
   Logger logger_;
   char last_char_;
   // value of token
-  std::string id_val_, str_val_;
+  Symbol id_val_;
+  std::string str_val_;
   std::uint32_t int_val_;
   std::int8_t char_val_;
   Keyword key_val_;
@@ -1,6 +1,7 @@
 #include "front/logger.h"
 
 #include <iostream>
+#include <mutex>
 
 #include "xstl/style.h"
 
@@ -11,6 +12,13 @@ std::string_view Logger::file_;
 std::size_t Logger::error_num_, Logger::warning_num_;
 bool Logger::enable_warn_, Logger::warn_as_err_;
 
+namespace {
+
+// messages may be logged by passes running in parallel
+std::recursive_mutex log_mutex;
+
+}  // namespace
+
 void Logger::LogFileInfo() const {
   using namespace xstl;
   std::cerr << style("B") << file_ << ":";
@@ -18,6 +26,7 @@ void Logger::LogFileInfo() const {
 }
 
 void Logger::LogRawError(std::string_view message) {
+  std::lock_guard<std::recursive_mutex> lock(log_mutex);
   using namespace xstl;
   // print error message
   std::cerr << style("Br") << "error: ";
@@ -27,12 +36,14 @@ void Logger::LogRawError(std::string_view message) {
 }
 
 void Logger::LogError(std::string_view message) const {
+  std::lock_guard<std::recursive_mutex> lock(log_mutex);
   LogFileInfo();
   LogRawError(message);
 }
 
 void Logger::LogError(std::string_view message,
                       std::string_view id) const {
+  std::lock_guard<std::recursive_mutex> lock(log_mutex);
   using namespace xstl;
   LogFileInfo();
   // print error message
@@ -44,6 +55,7 @@ void Logger::LogError(std::string_view message,
 
 // print warning message to stderr
 void Logger::LogWarning(std::string_view message) const {
+  std::lock_guard<std::recursive_mutex> lock(log_mutex);
   using namespace xstl;
   if (!enable_warn_) return;
   // log all warnings as errors
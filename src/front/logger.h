@@ -42,11 +42,13 @@ class Logger {
   }
   // increase column position
   void IncreaseColPos() { ++col_pos_; }
+  void IncreaseColPos(std::size_t n) { col_pos_ += n; }
 
   // setters
   static void set_file(std::string_view file) { file_ = file; }
 
   // getters
+  static std::string_view file() { return file_; }
   std::size_t line_pos() const { return line_pos_; }
   std::size_t col_pos() const { return col_pos_; }
   static std::size_t error_num() { return error_num_; }
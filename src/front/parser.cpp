@@ -101,7 +101,7 @@ ASTPtr Parser::ParseDeclDef(bool parse_func_def) {
       NextToken();
       if (IsTokenChar('{')) {
         // enum def without id
-        return ParseEnumDef("");
+        return ParseEnumDef(Symbol(""));
       }
       else {
         // get id
@@ -158,7 +158,7 @@ ASTPtr Parser::ParseVarFunc(ASTPtr type, bool parse_func_def) {
   }
 }
 
-ASTPtr Parser::ParseVarDecl(ASTPtr type, const std::string &id) {
+ASTPtr Parser::ParseVarDecl(ASTPtr type, Symbol id) {
   auto log = logger();
   // get definitions
   ASTPtrList defs;
@@ -180,7 +180,7 @@ ASTPtr Parser::ParseVarDecl(ASTPtr type, const std::string &id) {
   return MakeAST<VarDeclAST>(log, std::move(type), std::move(defs));
 }
 
-ASTPtr Parser::ParseVarDef(const std::string &id) {
+ASTPtr Parser::ParseVarDef(Symbol id) {
   auto log = logger();
   // parse array def
   ASTPtrList arr_lens;
@@ -221,7 +221,7 @@ ASTPtr Parser::ParseInitVal() {
   }
 }
 
-ASTPtr Parser::ParseFuncHeader(ASTPtr type, const std::string &id) {
+ASTPtr Parser::ParseFuncHeader(ASTPtr type, Symbol id) {
   auto log = logger();
   // eat '('
   NextToken();
@@ -274,7 +274,7 @@ ASTPtr Parser::ParseFuncParam() {
                                std::move(arr_lens));
 }
 
-ASTPtr Parser::ParseStructDef(const std::string &id) {
+ASTPtr Parser::ParseStructDef(Symbol id) {
   auto log = logger();
   // eat '{'
   NextToken();
@@ -292,7 +292,7 @@ ASTPtr Parser::ParseStructDef(const std::string &id) {
   return MakeAST<StructDefAST>(log, id, std::move(elems));
 }
 
-ASTPtr Parser::ParseEnumDef(const std::string &id) {
+ASTPtr Parser::ParseEnumDef(Symbol id) {
   auto log = logger();
   // eat '{'
   NextToken();
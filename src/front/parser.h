@@ -7,12 +7,13 @@
 #include "front/lexer.h"
 #include "define/ast.h"
 #include "front/token.h"
+#include "utils/timereport.h"
 
 namespace mimic::front {
 
 class Parser {
  public:
-  Parser(Lexer &lexer) : lexer_(lexer) { Reset(); }
+  Parser(Lexer &lexer) : lexer_(lexer), lex_timer_(nullptr) { Reset(); }
 
   // reset parser status
   void Reset() {
@@ -32,20 +33,30 @@ class Parser {
     }
   }
 
+  // setters
+  // set timer for recording time of lexer, 'nullptr' to disable
+  void set_lex_timer(utils::Timer *lex_timer) { lex_timer_ = lex_timer; }
+
   // getters
   // returns true if parser met EOF
   bool ended() const { return ended_; }
 
  private:
   // get next token from lexer and skip all EOLs
-  Token NextToken() { return cur_token_ = lexer_.NextToken(); }
+  Token NextToken() {
+    if (!lex_timer_) return cur_token_ = lexer_.NextToken();
+    lex_timer_->Start();
+    cur_token_ = lexer_.NextToken();
+    lex_timer_->Stop();
+    return cur_token_;
+  }
 
   // check if current token is a character (token type 'Other')
   bool IsTokenChar(char c) const {
     using namespace define;
     return (cur_token_ == Token::Other && lexer_.other_val() == c) ||
-           (cur_token_ == Token::Id && lexer_.id_val().size() == 1 &&
-            lexer_.id_val()[0] == c);
+           (cur_token_ == Token::Id && lexer_.id_val().str().size() == 1 &&
+            lexer_.id_val().str()[0] == c);
   }
 
   // check if current token is a keyword
@@ -83,16 +94,16 @@ class Parser {
   define::ASTPtr ParseDeclDef(bool parse_func_def);
   define::ASTPtr ParseVarFunc(define::ASTPtr type, bool parse_func_def);
 
-  define::ASTPtr ParseVarDecl(define::ASTPtr type, const std::string &id);
-  define::ASTPtr ParseVarDef(const std::string &id);
+  define::ASTPtr ParseVarDecl(define::ASTPtr type, Symbol id);
+  define::ASTPtr ParseVarDef(Symbol id);
   define::ASTPtr ParseInitVal();
 
   define::ASTPtr ParseFuncHeader(define::ASTPtr type,
-                                 const std::string &id);
+                                 Symbol id);
   define::ASTPtr ParseFuncParam();
 
-  define::ASTPtr ParseStructDef(const std::string &id);
-  define::ASTPtr ParseEnumDef(const std::string &id);
+  define::ASTPtr ParseStructDef(Symbol id);
+  define::ASTPtr ParseEnumDef(Symbol id);
   define::ASTPtr ParseStructElem();
   define::ASTPtr ParseStructElemDef();
   define::ASTPtr ParseEnumElem();
@@ -134,6 +145,7 @@ class Parser {
   const Logger &logger() const { return lexer_.logger(); }
 
   Lexer &lexer_;
+  utils::Timer *lex_timer_;
   Token cur_token_;
   bool ended_;
 };
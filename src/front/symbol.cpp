@@ -0,0 +1,51 @@
+#include "front/symbol.h"
+
+#include <unordered_map>
+#include <mutex>
+#include <cstring>
+
+#include "utils/arena.h"
+
+using namespace mimic::front;
+using namespace mimic::utils;
+
+namespace mimic::front {
+
+// global table of all interned symbols
+// entries will never be freed, so symbols are always valid
+class SymbolTable {
+ public:
+  static SymbolTable &Instance() {
+    static SymbolTable table;
+    return table;
+  }
+
+  Symbol Intern(std::string_view str) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(str);
+    if (it != entries_.end()) return Symbol(it->second);
+    // copy string to arena
+    auto data = static_cast<char *>(arena_.Allocate(str.size(), 1));
+    std::memcpy(data, str.data(), str.size());
+    // create a new entry, id of the first symbol is 1
+    auto mem = arena_.Allocate(sizeof(Symbol::Entry),
+                               alignof(Symbol::Entry));
+    auto id = static_cast<std::uint32_t>(entries_.size() + 1);
+    auto entry = new (mem) Symbol::Entry{{data, str.size()}, id};
+    entries_.insert({entry->str, entry});
+    return Symbol(entry);
+  }
+
+ private:
+  SymbolTable() {}
+
+  std::mutex mutex_;
+  Arena arena_;
+  std::unordered_map<std::string_view, const Symbol::Entry *> entries_;
+};
+
+}  // namespace mimic::front
+
+Symbol::Symbol(std::string_view str) {
+  entry_ = SymbolTable::Instance().Intern(str).entry_;
+}
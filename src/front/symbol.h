@@ -0,0 +1,182 @@
+#ifndef MIMIC_FRONT_SYMBOL_H_
+#define MIMIC_FRONT_SYMBOL_H_
+
+#include <string_view>
+#include <ostream>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+namespace mimic::front {
+
+// interned identifier
+// symbols with the same name always share the same entry,
+// so comparing/hashing a symbol is just comparing/hashing a pointer
+class Symbol {
+ public:
+  Symbol() : entry_(nullptr) {}
+  // intern the specific string
+  explicit Symbol(std::string_view str);
+
+  bool operator==(const Symbol &rhs) const { return entry_ == rhs.entry_; }
+  bool operator!=(const Symbol &rhs) const { return entry_ != rhs.entry_; }
+  explicit operator bool() const { return entry_; }
+
+  // getters
+  // unique id of symbol, zero if symbol is empty
+  std::uint32_t id() const { return entry_ ? entry_->id : 0; }
+  // name of symbol
+  std::string_view str() const { return entry_ ? entry_->str : ""; }
+
+ private:
+  friend class SymbolTable;
+
+  struct Entry {
+    std::string_view str;
+    std::uint32_t id;
+  };
+
+  explicit Symbol(const Entry *entry) : entry_(entry) {}
+
+  const Entry *entry_;
+};
+
+inline std::ostream &operator<<(std::ostream &os, const Symbol &sym) {
+  return os << sym.str();
+}
+
+// flat hash map that maps symbols to values of type 'V'
+// using open addressing with linear probing
+template <typename V>
+class SymbolMap {
+ public:
+  SymbolMap() : size_(0) {}
+
+  // insert a new item, do nothing if symbol already exists
+  // returns false if symbol already exists
+  bool Insert(Symbol sym, V value) {
+    if ((size_ + 1) * 4 > slots_.size() * 3) Grow();
+    auto &slot = slots_[FindSlot(slots_, sym)];
+    if (slot.first) return false;
+    slot = {sym, std::move(value)};
+    ++size_;
+    return true;
+  }
+
+  // find value of the specific symbol, returns 'nullptr' if not found
+  const V *Find(Symbol sym) const {
+    if (slots_.empty()) return nullptr;
+    const auto &slot = slots_[FindSlot(slots_, sym)];
+    return slot.first ? &slot.second : nullptr;
+  }
+
+  // remove all items
+  void Clear() {
+    slots_.clear();
+    size_ = 0;
+  }
+
+  // getters
+  std::size_t size() const { return size_; }
+  bool empty() const { return !size_; }
+
+ private:
+  using Slot = std::pair<Symbol, V>;
+
+  // initial count of slots, must be a power of two
+  static constexpr std::size_t kInitSize = 8;
+
+  // get index of the slot that contains the symbol,
+  // or the empty slot that the symbol should be placed to
+  static std::size_t FindSlot(const std::vector<Slot> &slots,
+                              Symbol sym) {
+    auto mask = slots.size() - 1;
+    // multiplicative hashing
+    auto index = (sym.id() * 2654435769u) & mask;
+    while (slots[index].first && slots[index].first != sym) {
+      index = (index + 1) & mask;
+    }
+    return index;
+  }
+
+  // double the count of slots and rehash all items
+  void Grow() {
+    auto size = slots_.empty() ? kInitSize : slots_.size() * 2;
+    std::vector<Slot> slots(size);
+    for (auto &&i : slots_) {
+      if (i.first) slots[FindSlot(slots, i.first)] = std::move(i);
+    }
+    slots_ = std::move(slots);
+  }
+
+  std::vector<Slot> slots_;
+  std::size_t size_;
+};
+
+// nested symbol table (environment)
+// each scope holds a flat hash map keyed on symbols
+template <typename V>
+class Environment;
+template <typename V>
+using EnvPtr = std::shared_ptr<Environment<V>>;
+
+template <typename V>
+class Environment {
+ public:
+  Environment() {}
+  Environment(const EnvPtr<V> &outer) : outer_(outer) {}
+
+  // add a new item to current scope
+  void AddItem(Symbol sym, V value) {
+    items_.Insert(sym, std::move(value));
+  }
+  // get value of the specific symbol, returns 'V()' if not found
+  V GetItem(Symbol sym, bool recursive) const {
+    for (auto env = this; env; env = env->outer_.get()) {
+      if (auto value = env->items_.Find(sym)) return *value;
+      if (!recursive) break;
+    }
+    return V();
+  }
+  // get value of the specific symbol recursively
+  V GetItem(Symbol sym) const { return GetItem(sym, true); }
+
+  // getters
+  bool is_root() const { return !outer_; }
+  const EnvPtr<V> &outer() const { return outer_; }
+
+ private:
+  EnvPtr<V> outer_;
+  SymbolMap<V> items_;
+};
+
+// create a new root environment
+template <typename V>
+inline EnvPtr<V> MakeEnv() {
+  return std::make_shared<Environment<V>>();
+}
+
+// create a new environment with the specific outer environment
+template <typename V>
+inline EnvPtr<V> MakeEnv(const EnvPtr<V> &outer) {
+  return std::make_shared<Environment<V>>(outer);
+}
+
+}  // namespace mimic::front
+
+namespace std {
+
+// hash function of symbols
+template <>
+struct hash<mimic::front::Symbol> {
+  std::size_t operator()(const mimic::front::Symbol &sym) const {
+    return sym.id();
+  }
+};
+
+}  // namespace std
+
+#endif  // MIMIC_FRONT_SYMBOL_H_
@@ -2,23 +2,43 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <iterator>
+#include <memory>
+#include <functional>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <system_error>
+#include <cassert>
 #include <cstdlib>
+#include <cerrno>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 #include "version.h"
 
 #include "front/logger.h"
 #include "driver/compiler.h"
+#include "driver/cache.h"
+#include "driver/server.h"
+#include "mid/module.h"
 #include "opt/stage.h"
 #include "back/asm/generator.h"
 #include "back/c/generator.h"
 
+#include "utils/mmap.h"
+
 #include "xstl/argparse.h"
 
 using namespace std;
 using namespace mimic::front;
 using namespace mimic::driver;
+using namespace mimic::mid;
 using namespace mimic::opt;
 using namespace mimic::back;
+using namespace mimic::utils;
 
 namespace {
 
@@ -39,10 +59,42 @@ xstl::ArgParser GetArgp() {
                        false);
   argp.AddOption<bool>("dump-ast", "da", "dump AST to output", false);
   argp.AddOption<bool>("dump-ir", "di", "dump IR to output", false);
+  argp.AddOption<bool>("dump-ir-bin", "dib", "dump binary IR to output",
+                       false);
+  argp.AddOption<bool>("input-ir", "ir",
+                       "treat input file as IR dumped by '-di'", false);
   argp.AddOption<string>("pass-stage", "ps",
                          "optimize until specific stage", "");
   argp.AddOption<string>("target-arch", "ta",
                          "specify target architecture", "aarch32");
+  argp.AddOption<string>("reg-alloc", "fregalloc",
+                         "specify register allocator "
+                         "(linear-scan/binpacking/coloring/irc)", "");
+  argp.AddOption<int>("jobs", "j",
+                      "number of threads for running function passes", 1);
+  argp.AddOption<bool>("time-report", "ftime-report",
+                       "report time of compiler phases & passes", false);
+  argp.AddOption<string>("time-report-json", "ftime-report-json",
+                         "dump time report in JSON to file", "");
+  argp.AddOption<string>("cache-dir", "fcache-dir",
+                         "cache outputs of compilation in directory", "");
+  argp.AddOption<int>("cache-size", "fcache-size",
+                      "size limit of compilation cache in MiB", 256);
+  argp.AddOption<bool>("cache-stats", "fcache-stats",
+                       "report statistics of compilation cache", false);
+  argp.AddOption<bool>("batch", "fbatch",
+                       "treat input as a list of files to be compiled, "
+                       "and treat output as the output directory",
+                       false);
+  argp.AddOption<int>("batch-jobs", "fbatch-jobs",
+                      "number of processes for compiling files in batch",
+                      1);
+  argp.AddOption<bool>("server", "fserver",
+                       "run as compile server listening on the socket "
+                       "specified by input", false);
+  argp.AddOption<string>("server-socket", "fserver-socket",
+                         "send compile request to the compile server "
+                         "listening on socket", "");
   return argp;
 }
 
@@ -88,26 +140,40 @@ istringstream GetPreDeclFuncs() {
   return iss;
 }
 
-}  // namespace
-
-int main(int argc, const char *argv[]) {
-  // set up argument parser & parse argument
-  auto argp = GetArgp();
-  ParseArgument(argp, argc, argv);
+// compile pre-declared functions
+void CompilePreDeclFuncs(Compiler &comp) {
+  auto iss = GetPreDeclFuncs();
+  comp.Open(&iss);
+  comp.CompileToIR();
+}
 
-  // initialize compiler
-  Compiler comp;
+// initialize compiler by arguments, returns false if failed
+bool InitCompiler(Compiler &comp, const xstl::ArgParser &argp) {
   if (argp.GetValue<bool>("dump-ast")) {
     comp.set_dump_ast(true);
   }
   else if (argp.GetValue<bool>("dump-ir")) {
     comp.set_dump_yuir(true);
   }
+  else if (argp.GetValue<bool>("dump-ir-bin")) {
+    comp.set_dump_yuir_bin(true);
+  }
   else {
     comp.set_dump_code(true);
   }
   comp.set_dump_pass_info(argp.GetValue<bool>("verbose"));
   comp.set_opt_level(argp.GetValue<bool>("opt-2") ? 2 : 0);
+  if (argp.GetValue<int>("jobs") < 1 ||
+      argp.GetValue<int>("batch-jobs") < 1) {
+    Logger::LogRawError("invalid number of jobs");
+    return false;
+  }
+  if (argp.GetValue<int>("cache-size") < 1) {
+    Logger::LogRawError("invalid cache size");
+    return false;
+  }
+  comp.set_dump_time_report(argp.GetValue<bool>("time-report"));
+  comp.set_time_report_file(argp.GetValue<string>("time-report-json"));
 
   // initialize pass stage
   auto stage_name = argp.GetValue<string>("pass-stage");
@@ -115,39 +181,142 @@ int main(int argc, const char *argv[]) {
     auto stage = GetStageByName(stage_name);
     if (stage == PassStage::None) {
       Logger::LogRawError("invalid stage name");
-      return 1;
+      return false;
     }
     comp.set_stage(stage);
   }
+  return true;
+}
 
-  // initialize input stream & logger
-  auto in_file = argp.GetValue<string>("input");
-  ifstream ifs(in_file);
-  if (!ifs.is_open()) {
-    Logger::LogRawError("invalid input file");
-    return 1;
+// get identity of the current build of compiler, empty if unavailable
+// executable is hashed, so outputs of different builds of the same
+// version will not be mixed in the compilation cache
+const string &GetBuildId() {
+  static const string build_id = [] {
+    MappedFile exe("/proc/self/exe");
+    if (!exe.valid()) return string();
+    return to_string(hash<string_view>()(exe.content()));
+  }();
+  return build_id;
+}
+
+// add all inputs that may affect the output to the key of cache
+void AddCacheKey(CompileCache &cache, const xstl::ArgParser &argp,
+                 const string &in_file, string_view input) {
+  cache.AddKey(APP_VERSION);
+  cache.AddKey(GetBuildId());
+  cache.AddKey(GetPreDeclFuncs().str());
+  cache.AddKey(input);
+  for (const auto &opt : {"asm", "opt-2", "warn-error", "warn-all",
+                          "dump-ast", "dump-ir", "dump-ir-bin",
+                          "input-ir"}) {
+    cache.AddKey(argp.GetValue<bool>(opt) ? "1" : "0");
+  }
+  cache.AddKey(argp.GetValue<string>("pass-stage"));
+  auto is_asm = argp.GetValue<bool>("asm");
+  cache.AddKey(is_asm ? argp.GetValue<string>("target-arch") : "");
+  cache.AddKey(is_asm ? argp.GetValue<string>("reg-alloc") : "");
+  // binary IR contains the name of source file
+  auto is_bin = argp.GetValue<bool>("dump-ir-bin");
+  cache.AddKey(is_bin ? in_file : "");
+}
+
+// compile the specific input file to the output file
+// pre-declared functions will be compiled first if not compiled yet
+int CompileFile(Compiler &comp, const xstl::ArgParser &argp,
+                const string &in_file, const string &out_file,
+                bool has_predecl) {
+  comp.set_thread_count(argp.GetValue<int>("jobs"));
+
+  // initialize input file & logger
+  // map input file into memory, or fall back to stream if failed
+  MappedFile in_map(in_file);
+  ifstream ifs;
+  if (!in_map.valid()) {
+    ifs.open(in_file);
+    if (!ifs.is_open()) {
+      Logger::LogRawError("invalid input file");
+      return 1;
+    }
   }
   Logger::set_file(in_file);
   Logger::ResetErrorNum(argp.GetValue<bool>("warn-all"),
                         argp.GetValue<bool>("warn-error"));
 
   // initialize output stream
-  auto out_file = argp.GetValue<string>("output");
   ofstream ofs;
   if (!out_file.empty()) ofs.open(out_file);
-  comp.set_ostream(out_file.empty() ? &cout : &ofs);
+  auto os = out_file.empty() ? static_cast<ostream *>(&cout) : &ofs;
+  comp.set_ostream(os);
 
-  // handle pre-declared functions
-  auto iss = GetPreDeclFuncs();
-  comp.Open(&iss);
-  comp.CompileToIR();
+  // look up compilation cache, outputs of compilations that are being
+  // profiled or reading from stream, or of an unidentified build of
+  // compiler will not be cached
+  unique_ptr<CompileCache> cache;
+  ostringstream cache_os;
+  auto cache_dir = argp.GetValue<string>("cache-dir");
+  if (!cache_dir.empty() && in_map.valid() && !GetBuildId().empty() &&
+      !argp.GetValue<bool>("verbose") &&
+      !argp.GetValue<bool>("time-report") &&
+      argp.GetValue<string>("time-report-json").empty()) {
+    auto cache_size = argp.GetValue<int>("cache-size");
+    cache = make_unique<CompileCache>(
+        cache_dir, static_cast<size_t>(cache_size) << 20);
+    AddCacheKey(*cache, argp, in_file, in_map.content());
+    string output;
+    if (cache->Lookup(output)) {
+      os->write(output.data(), output.size());
+      if (argp.GetValue<bool>("cache-stats")) cache->DumpStats(cerr);
+      return 0;
+    }
+    // capture the output
+    comp.set_ostream(&cache_os);
+  }
 
-  // compile input file
-  comp.Open(&ifs);
-  comp.CompileToIR();
-  if (comp.dump_ast()) exit(0);
+  // finish compilation, store output to cache if there is no error
+  auto finish = [&] {
+    comp.DumpTimeReport();
+    if (cache) {
+      auto output = cache_os.str();
+      os->write(output.data(), output.size());
+      if (!Logger::error_num() && !Logger::warning_num()) {
+        cache->Store(output);
+      }
+      if (argp.GetValue<bool>("cache-stats")) cache->DumpStats(cerr);
+    }
+    return static_cast<int>(Logger::error_num());
+  };
+
+  if (argp.GetValue<bool>("input-ir")) {
+    // load textual or binary IR, pre-declared functions are already in it
+    if (in_map.valid()) {
+      comp.LoadIR(in_map.content());
+    }
+    else {
+      string buf(istreambuf_iterator<char>(ifs), {});
+      comp.LoadIR(buf);
+    }
+  }
+  else if (in_map.valid() && Module::IsSerialized(in_map.content())) {
+    // load binary IR
+    comp.LoadIR(in_map.content());
+  }
+  else {
+    // handle pre-declared functions
+    if (!has_predecl) CompilePreDeclFuncs(comp);
+
+    // compile input file
+    if (in_map.valid()) {
+      comp.Open(in_map.content());
+    }
+    else {
+      comp.Open(&ifs);
+    }
+    comp.CompileToIR();
+    if (comp.dump_ast()) return finish();
+  }
   comp.RunPasses();
-  if (comp.dump_yuir()) exit(0);
+  if (comp.dump_yuir() || comp.dump_yuir_bin()) return finish();
 
   // generate code
   if (argp.GetValue<bool>("asm")) {
@@ -159,7 +328,12 @@ int main(int argc, const char *argv[]) {
       gen.ShowAvaliableArchs(std::cerr);
       return 1;
     }
+    if (!gen.SetRegAlloc(argp.GetValue<string>("reg-alloc"))) {
+      Logger::LogRawError("invalid register allocator");
+      return 1;
+    }
     gen.set_opt_level(comp.opt_level());
+    gen.set_time_report(comp.time_report());
     comp.GenerateCode(gen);
   }
   else {
@@ -167,5 +341,156 @@ int main(int argc, const char *argv[]) {
     c::CCodeGen gen;
     comp.GenerateCode(gen);
   }
-  return Logger::error_num();
+  return finish();
+}
+
+// get output file of the specific input file in batch mode
+string GetBatchOutputFile(const xstl::ArgParser &argp,
+                          const string &in_file) {
+  const char *ext = argp.GetValue<bool>("dump-ast")      ? ".ast"
+                    : argp.GetValue<bool>("dump-ir")     ? ".ir"
+                    : argp.GetValue<bool>("dump-ir-bin") ? ".irb"
+                    : argp.GetValue<bool>("asm")         ? ".s"
+                                                         : ".c";
+  // put output file in the output directory, or beside the input file
+  filesystem::path path(in_file);
+  auto out_dir = argp.GetValue<string>("output");
+  if (!out_dir.empty()) path = filesystem::path(out_dir) / path.filename();
+  path.replace_extension(ext);
+  // never overwrite the input file
+  if (path == filesystem::path(in_file)) path += ext;
+  return path.string();
+}
+
+// wait for a worker process to exit, returns false if compilation failed
+bool WaitWorker(unordered_map<pid_t, string> &workers) {
+  int status;
+  pid_t pid;
+  while ((pid = wait(&status)) < 0 && errno == EINTR) {}
+  auto it = workers.find(pid);
+  assert(it != workers.end());
+  auto ret = WIFEXITED(status) && !WEXITSTATUS(status);
+  if (!ret) cerr << "failed to compile '" << it->second << "'" << endl;
+  workers.erase(it);
+  return ret;
+}
+
+// compile all input files listed in the response file
+// each file is compiled in a worker process forked from current
+// process, so the analysed pre-declared functions are reused, and
+// states of compiler (logger, passes, instruction generators) are
+// always reset between files
+int CompileBatch(Compiler &comp, const xstl::ArgParser &argp,
+                 bool has_predecl) {
+  // read list of input files, empty lines and comments are ignored
+  ifstream ifs(argp.GetValue<string>("input"));
+  if (!ifs.is_open()) {
+    Logger::LogRawError("invalid response file");
+    return 1;
+  }
+  vector<string> files;
+  for (string line; getline(ifs, line);) {
+    auto first = line.find_first_not_of(" \t\r");
+    if (first == string::npos || line[first] == '#') continue;
+    auto last = line.find_last_not_of(" \t\r");
+    files.push_back(line.substr(first, last - first + 1));
+  }
+  auto out_dir = argp.GetValue<string>("output");
+  if (!out_dir.empty()) {
+    error_code ec;
+    filesystem::create_directories(out_dir, ec);
+  }
+
+  // compile pre-declared functions
+  if (!has_predecl && !argp.GetValue<bool>("input-ir")) {
+    Logger::set_file("<pre-declared>");
+    CompilePreDeclFuncs(comp);
+    has_predecl = true;
+  }
+
+  // spread files across worker processes
+  auto max_workers = static_cast<size_t>(argp.GetValue<int>("batch-jobs"));
+  unordered_map<pid_t, string> workers;
+  size_t failed = 0;
+  for (const auto &file : files) {
+    if (workers.size() >= max_workers && !WaitWorker(workers)) ++failed;
+    // make sure that buffered output will not be written twice
+    cout.flush();
+    cerr.flush();
+    auto pid = fork();
+    if (pid < 0) {
+      Logger::LogRawError("failed to create worker process");
+      ++failed;
+      continue;
+    }
+    if (!pid) {
+      auto out_file = GetBatchOutputFile(argp, file);
+      exit(CompileFile(comp, argp, file, out_file, has_predecl) ? 1 : 0);
+    }
+    workers.insert({pid, file});
+  }
+  while (!workers.empty()) {
+    if (!WaitWorker(workers)) ++failed;
+  }
+  if (failed) {
+    cerr << failed << " of " << files.size()
+         << " file(s) failed to compile" << endl;
+  }
+  return failed ? 1 : 0;
+}
+
+// run compile server on the socket specified by input
+int RunServer(Compiler &comp, const xstl::ArgParser &argp) {
+  CompileServer server(argp.GetValue<string>("input"));
+  if (!server.Listen()) {
+    Logger::LogRawError("failed to listen on socket");
+    return 1;
+  }
+  // compile pre-declared functions
+  Logger::set_file("<pre-declared>");
+  CompilePreDeclFuncs(comp);
+  // handle requests, arguments are parsed in the same way as 'main'
+  server.Serve([&comp](const CompileServer::ArgList &args) {
+    vector<const char *> argv;
+    for (const auto &i : args) argv.push_back(i.c_str());
+    auto argp = GetArgp();
+    ParseArgument(argp, argv.size(), argv.data());
+    if (!InitCompiler(comp, argp)) return 1;
+    if (argp.GetValue<bool>("batch")) return CompileBatch(comp, argp, true);
+    return CompileFile(comp, argp, argp.GetValue<string>("input"),
+                       argp.GetValue<string>("output"), true);
+  });
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, const char *argv[]) {
+  // set up argument parser & parse argument
+  auto argp = GetArgp();
+  ParseArgument(argp, argc, argv);
+
+  // send request to compile server if possible
+  // fall back to compile locally if server is unavailable
+  auto is_server = argp.GetValue<bool>("server");
+  auto socket = argp.GetValue<string>("server-socket");
+  if (auto env = getenv("MMCC_SERVER_SOCKET"); socket.empty() && env) {
+    socket = env;
+  }
+  if (!is_server && !socket.empty()) {
+    int code;
+    if (RequestCompileServer(socket, argc, argv, code)) return code;
+  }
+
+  // initialize compiler
+  Compiler comp;
+  if (is_server) return RunServer(comp, argp);
+  if (!InitCompiler(comp, argp)) return 1;
+
+  // compile input files
+  if (argp.GetValue<bool>("batch")) {
+    return CompileBatch(comp, argp, false);
+  }
+  return CompileFile(comp, argp, argp.GetValue<string>("input"),
+                     argp.GetValue<string>("output"), false);
 }
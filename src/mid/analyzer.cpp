@@ -44,10 +44,10 @@ inline bool CheckInit(const Logger &log, const TypePtr &type,
 TypePtr Analyzer::enum_base_ = MakePrimType(PrimType::Type::Int32, false);
 
 xstl::Guard Analyzer::NewEnv() {
-  symbols_ = xstl::MakeNestedMap(symbols_);
-  aliases_ = xstl::MakeNestedMap(aliases_);
-  structs_ = xstl::MakeNestedMap(structs_);
-  enums_ = xstl::MakeNestedMap(enums_);
+  symbols_ = front::MakeEnv(symbols_);
+  aliases_ = front::MakeEnv(aliases_);
+  structs_ = front::MakeEnv(structs_);
+  enums_ = front::MakeEnv(enums_);
   return xstl::Guard([this] {
     symbols_ = symbols_->outer();
     aliases_ = aliases_->outer();
@@ -83,7 +83,7 @@ TypePtr Analyzer::HandleArray(TypePtr base, const ASTPtrList &arr_lens,
         return LogError(expr->logger(), "invalid array length", id);
       }
       // make array type
-      base = std::make_shared<ArrayType>(std::move(base), *len, false);
+      base = MakeArray(base, *len, false);
     }
   }
   return base;
@@ -91,7 +91,7 @@ TypePtr Analyzer::HandleArray(TypePtr base, const ASTPtrList &arr_lens,
 
 void Analyzer::Reset() {
   auto new_env = [] {
-    return xstl::MakeNestedMap<std::string, TypePtr>();
+    return front::MakeEnv<TypePtr>();
   };
   symbols_ = new_env();
   aliases_ = new_env();
@@ -121,7 +121,7 @@ TypePtr Analyzer::AnalyzeOn(VarDeclAST &ast) {
 
 TypePtr Analyzer::AnalyzeOn(VarDefAST &ast) {
   // handle array type
-  auto type = HandleArray(var_type_, ast.arr_lens(), ast.id(), false);
+  auto type = HandleArray(var_type_, ast.arr_lens(), ast.id().str(), false);
   if (!type) return nullptr;
   // push to stack in order to handle initializer list
   final_types_.push(type);
@@ -131,12 +131,12 @@ TypePtr Analyzer::AnalyzeOn(VarDefAST &ast) {
     const auto &log = ast.init()->logger();
     auto init = ast.init()->SemaAnalyze(*this);
     if (!init) return nullptr;
-    if (!CheckInit(log, type, init, ast.id())) return nullptr;
+    if (!CheckInit(log, type, init, ast.id().str())) return nullptr;
   }
   // check if is conflicted
   if (symbols_->GetItem(ast.id(), false)) {
     return LogError(ast.logger(), "symbol has already been defined",
-                    ast.id());
+                    ast.id().str());
   }
   // add to environment
   symbols_->AddItem(ast.id(), type);
@@ -203,13 +203,12 @@ TypePtr Analyzer::AnalyzeOn(FuncDeclAST &ast) {
     params.push_back(std::move(param));
   }
   // make function type
-  auto type = std::make_shared<FuncType>(std::move(params),
-                                         std::move(ret), true);
+  auto type = MakeFunc(params, ret, true);
   // add to environment
   const auto &sym = in_func_ ? symbols_->outer() : symbols_;
   if (sym->GetItem(ast.id(), false)) {
     return LogError(ast.logger(), "symbol has already been defined",
-                    ast.id());
+                    ast.id().str());
   }
   sym->AddItem(ast.id(), type);
   // add to func info map
@@ -218,10 +217,12 @@ TypePtr Analyzer::AnalyzeOn(FuncDeclAST &ast) {
     funcs_.insert({ast.id(), {type, !in_func_}});
   }
   else if (!it->second.type->IsIdentical(type)) {
-    return LogError(ast.logger(), "conflicted function type", ast.id());
+    return LogError(ast.logger(), "conflicted function type",
+                    ast.id().str());
   }
   else if (!it->second.is_decl && in_func_) {
-    return LogError(ast.logger(), "redefinition of function", ast.id());
+    return LogError(ast.logger(), "redefinition of function",
+                    ast.id().str());
   }
   else if (it->second.is_decl && in_func_) {
     it->second.is_decl = false;
@@ -253,14 +254,14 @@ TypePtr Analyzer::AnalyzeOn(FuncParamAST &ast) {
   auto type = ast.type()->SemaAnalyze(*this);
   if (!type) return nullptr;
   // handle array type
-  type = HandleArray(std::move(type), ast.arr_lens(), ast.id(), true);
+  type = HandleArray(std::move(type), ast.arr_lens(), ast.id().str(), true);
   if (!type) return nullptr;
   // add to environment
   if (in_func_) {
     // check if is conflicted
     if (symbols_->GetItem(ast.id(), false)) {
       return LogError(ast.logger(), "argument has already been declared",
-                      ast.id());
+                      ast.id().str());
     }
     symbols_->AddItem(ast.id(), type);
   }
@@ -269,15 +270,15 @@ TypePtr Analyzer::AnalyzeOn(FuncParamAST &ast) {
 
 TypePtr Analyzer::AnalyzeOn(StructDefAST &ast) {
   // reset status
-  last_struct_name_ = ast.id();
+  last_struct_name_ = ast.id().str();
   struct_elems_.clear();
   struct_elem_names_.clear();
   // create an empty struct type
-  auto type = std::make_shared<StructType>(struct_elems_, ast.id(), false);
+  auto type = MakeStruct(struct_elems_, std::string(ast.id().str()));
   // check if is conflicted
   if (structs_->GetItem(ast.id(), false)) {
     return LogError(ast.logger(), "struct has already been defined",
-                    ast.id());
+                    ast.id().str());
   }
   // add to environment
   structs_->AddItem(ast.id(), type);
@@ -299,7 +300,7 @@ TypePtr Analyzer::AnalyzeOn(EnumDefAST &ast) {
   // check if is conflicted
   if (enums_->GetItem(ast.id(), false)) {
     return LogError(ast.logger(), "enumeration has already been defined",
-                    ast.id());
+                    ast.id().str());
   }
   // add to environment
   enums_->AddItem(ast.id(), enum_base_);
@@ -315,7 +316,7 @@ TypePtr Analyzer::AnalyzeOn(TypeAliasAST &ast) {
   // check if is conflicted
   if (aliases_->GetItem(ast.id(), false)) {
     return LogError(ast.logger(), "user type has already been defined",
-                    ast.id());
+                    ast.id().str());
   }
   // add to environment
   enums_->AddItem(ast.id(), std::move(type));
@@ -342,14 +343,14 @@ TypePtr Analyzer::AnalyzeOn(StructElemDefAST &ast) {
   // check if name conflicted
   if (!struct_elem_names_.insert(ast.id()).second) {
     return LogError(ast.logger(), "conflicted struct element name",
-                    ast.id());
+                    ast.id().str());
   }
   // handle array type
   auto type = HandleArray(struct_elem_base_, ast.arr_lens(),
-                          ast.id(), false);
+                          ast.id().str(), false);
   if (!type) return nullptr;
   // add to elements
-  struct_elems_.push_back({std::string(ast.id()), type});
+  struct_elems_.push_back({std::string(ast.id().str()), type});
   return ast.set_ast_type(std::move(type));
 }
 
@@ -365,7 +366,7 @@ TypePtr Analyzer::AnalyzeOn(EnumElemAST &ast) {
   // check if is conflicted
   if (symbols_->GetItem(ast.id(), false)) {
     return LogError(ast.logger(), "enumerator has already been defined",
-                    ast.id());
+                    ast.id().str());
   }
   // add to environment
   symbols_->AddItem(ast.id(), enum_base_->GetValueType(true));
@@ -629,8 +630,10 @@ TypePtr Analyzer::AnalyzeOn(AccessAST &ast) {
   if (!expr->IsStruct()) {
     return LogError(ast.expr()->logger(), "structure type required");
   }
-  auto type = expr->GetElem(ast.id());
-  if (!type) return LogError(ast.logger(), "member not found", ast.id());
+  auto type = expr->GetElem(std::string(ast.id().str()));
+  if (!type) {
+    return LogError(ast.logger(), "member not found", ast.id().str());
+  }
   return ast.set_ast_type(std::move(type));
 }
 
@@ -647,14 +650,16 @@ TypePtr Analyzer::AnalyzeOn(CharAST &ast) {
 TypePtr Analyzer::AnalyzeOn(StringAST &ast) {
   // make right value 'const int8*' type
   auto type = MakePrimType(PrimType::Type::Int8, true);
-  type = std::make_shared<ConstType>(std::move(type));
+  type = MakeConst(type);
   return ast.set_ast_type(MakePointer(std::move(type)));
 }
 
 TypePtr Analyzer::AnalyzeOn(IdAST &ast) {
   // query from environment
   auto type = symbols_->GetItem(ast.id());
-  if (!type) return LogError(ast.logger(), "undefined symbol", ast.id());
+  if (!type) {
+    return LogError(ast.logger(), "undefined symbol", ast.id().str());
+  }
   return ast.set_ast_type(std::move(type));
 }
 
@@ -666,21 +671,27 @@ TypePtr Analyzer::AnalyzeOn(PrimTypeAST &ast) {
 TypePtr Analyzer::AnalyzeOn(UserTypeAST &ast) {
   // query from environment
   auto type = aliases_->GetItem(ast.id());
-  if (!type) return LogError(ast.logger(), "type undefined", ast.id());
+  if (!type) {
+    return LogError(ast.logger(), "type undefined", ast.id().str());
+  }
   return ast.set_ast_type(std::move(type));
 }
 
 TypePtr Analyzer::AnalyzeOn(StructTypeAST &ast) {
   // query from environment
   auto type = structs_->GetItem(ast.id());
-  if (!type) return LogError(ast.logger(), "type undefined", ast.id());
+  if (!type) {
+    return LogError(ast.logger(), "type undefined", ast.id().str());
+  }
   return ast.set_ast_type(std::move(type));
 }
 
 TypePtr Analyzer::AnalyzeOn(EnumTypeAST &ast) {
   // query from environment
   auto type = enums_->GetItem(ast.id());
-  if (!type) return LogError(ast.logger(), "type undefined", ast.id());
+  if (!type) {
+    return LogError(ast.logger(), "type undefined", ast.id().str());
+  }
   return ast.set_ast_type(std::move(type));
 }
 
@@ -689,7 +700,7 @@ TypePtr Analyzer::AnalyzeOn(ConstTypeAST &ast) {
   auto base = ast.base()->SemaAnalyze(*this);
   if (!base) return nullptr;
   // make const type
-  auto type = std::make_shared<ConstType>(std::move(base));
+  auto type = MakeConst(base);
   return ast.set_ast_type(std::move(type));
 }
 
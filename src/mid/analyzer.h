@@ -11,8 +11,8 @@
 #include "mid/eval.h"
 #include "define/ast.h"
 #include "define/type.h"
+#include "front/symbol.h"
 
-#include "xstl/nested.h"
 #include "xstl/guard.h"
 
 namespace mimic::mid {
@@ -59,7 +59,7 @@ class Analyzer {
 
  private:
   // pointer of symbol table (environment)
-  using EnvPtr = xstl::NestedMapPtr<std::string, define::TypePtr>;
+  using EnvPtr = front::EnvPtr<define::TypePtr>;
 
   // function information
   struct FuncInfo {
@@ -88,11 +88,11 @@ class Analyzer {
   // used when analyzing function related stuffs
   bool in_func_;
   define::TypePtr cur_ret_;
-  std::unordered_map<std::string, FuncInfo> funcs_;
+  std::unordered_map<front::Symbol, FuncInfo> funcs_;
   // used when analyzing structs
   std::string_view last_struct_name_;
   define::TypePairList struct_elems_;
-  std::unordered_set<std::string_view> struct_elem_names_;
+  std::unordered_set<front::Symbol> struct_elem_names_;
   define::TypePtr struct_elem_base_;
   // used when analyzing while loops
   std::size_t in_loop_;
@@ -51,7 +51,7 @@ inline std::optional<std::uint32_t> CastToType(std::uint32_t val,
 }  // namespace
 
 xstl::Guard Evaluator::NewEnv() {
-  values_ = xstl::MakeNestedMap(values_);
+  values_ = front::MakeEnv(values_);
   return xstl::Guard([this] { values_ = values_->outer(); });
 }
 
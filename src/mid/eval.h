@@ -6,8 +6,8 @@
 #include <cstdint>
 
 #include "define/ast.h"
+#include "front/symbol.h"
 
-#include "xstl/nested.h"
 #include "xstl/guard.h"
 
 namespace mimic::mid {
@@ -20,8 +20,7 @@ class Evaluator {
 
   // reset internal status
   void Reset() {
-    values_ =
-        xstl::MakeNestedMap<std::string, std::optional<std::uint32_t>>();
+    values_ = front::MakeEnv<std::optional<std::uint32_t>>();
   }
 
   std::optional<std::uint32_t> EvalOn(define::VarDeclAST &ast);
@@ -59,13 +58,12 @@ class Evaluator {
 
  private:
   // definition of environment that storing evaluated values
-  using EvalEnvPtr =
-      xstl::NestedMapPtr<std::string, std::optional<std::uint32_t>>;
+  using EvalEnvPtr = front::EnvPtr<std::optional<std::uint32_t>>;
 
   // switch to new environment
   xstl::Guard NewEnv();
   // add value to environment
-  void AddValue(const std::string &id, std::uint32_t val);
+  void AddValue(front::Symbol id, std::uint32_t val);
 
   // evaluated values
   EvalEnvPtr values_;
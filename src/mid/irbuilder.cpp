@@ -8,7 +8,7 @@ using namespace mimic::mid;
 using namespace mimic::define;
 
 xstl::Guard IRBuilder::NewEnv() {
-  vals_ = xstl::MakeNestedMap(vals_);
+  vals_ = front::MakeEnv(vals_);
   return xstl::Guard([this] { vals_ = vals_->outer(); });
 }
 
@@ -83,7 +83,7 @@ SSAPtr IRBuilder::CreateBinOp(BinaryAST::Operator op, const SSAPtr &lhs,
 
 void IRBuilder::Reset() {
   module_.Reset();
-  vals_ = xstl::MakeNestedMap<std::string, SSAPtr>();
+  vals_ = front::MakeEnv<SSAPtr>();
   in_func_ = false;
   funcs_.clear();
   assert(break_cont_.empty());
@@ -104,7 +104,8 @@ SSAPtr IRBuilder::GenerateOn(VarDefAST &ast) {
   if (vals_->is_root()) {
     // global variables/constants
     auto var = module_.CreateGlobalVar(LinkageTypes::External,
-                                       !type->IsConst(), ast.id(), type);
+                                       !type->IsConst(),
+                                       std::string(ast.id().str()), type);
     if (init) {
       if (init->IsLiteral()) {
         // generate initializer
@@ -183,7 +184,8 @@ SSAPtr IRBuilder::GenerateOn(FuncDeclAST &ast) {
   auto it = funcs_.find(ast.id());
   if (it == funcs_.end()) {
     // create function declaration
-    func = module_.CreateFunction(LinkageTypes::External, ast.id(),
+    func = module_.CreateFunction(LinkageTypes::External,
+                                  std::string(ast.id().str()),
                                   ast.ast_type());
     funcs_.insert({ast.id(), func});
     // add to environment
@@ -478,7 +480,7 @@ SSAPtr IRBuilder::GenerateOn(AccessAST &ast) {
   }
   assert(expr_ty->IsStruct());
   // get index of element
-  auto index = expr_ty->GetElemIndex(ast.id());
+  auto index = expr_ty->GetElemIndex(std::string(ast.id().str()));
   assert(index);
   // generate access operation
   auto elem_ty = expr_ty->GetElem(*index);
@@ -9,8 +9,8 @@
 #include "define/ast.h"
 #include "mid/usedef.h"
 #include "mid/module.h"
+#include "front/symbol.h"
 #include "xstl/guard.h"
-#include "xstl/nested.h"
 
 namespace mimic::mid {
 
@@ -71,10 +71,10 @@ class IRBuilder {
   // module for storing IRs
   Module module_;
   // table of values
-  xstl::NestedMapPtr<std::string, SSAPtr> vals_;
+  front::EnvPtr<SSAPtr> vals_;
   // used when generating functions
   bool in_func_;
-  std::unordered_map<std::string, UserPtr> funcs_;
+  std::unordered_map<front::Symbol, UserPtr> funcs_;
   SSAPtr ret_val_;
   BlockPtr func_entry_, func_exit_;
   // used when generating loops
@@ -0,0 +1,1131 @@
+#include "mid/module.h"
+
+#include <unordered_map>
+#include <vector>
+#include <cstring>
+#include <cctype>
+#include <cstdint>
+#include <cassert>
+
+#include "opt/helper/cast.h"
+
+using namespace mimic::mid;
+using namespace mimic::define;
+using namespace mimic::front;
+using namespace mimic::opt;
+
+/*
+  parser of textual IR, which accepts the output of 'Module::Dump'
+
+  values are referenced by their names in dump ('%1', '@args.0', '@a'),
+  references to values that have not been defined yet will be resolved
+  at the end of function (local values) or module (global values).
+  structure types can not be parsed, since their definitions are not
+  dumped by 'Module::Dump'.
+*/
+
+namespace {
+
+// names of linkage types, binary & unary operators
+// must be consistent with 'ssa.cpp'
+const char *kLinkTypes[] = {
+  "internal", "inline", "external", "global_ctor", "global_dtor",
+};
+const char *kBinOps[] = {
+  "add", "sub", "mul", "udiv", "sdiv", "urem", "srem", "eq", "neq",
+  "ult", "slt", "ule", "sle", "ugt", "sgt", "uge", "sge",
+  "and", "or", "xor", "shl", "lshr", "ashr",
+};
+const char *kUnaOps[] = {
+  "neg", "lnot", "not",
+};
+
+// get index of the specific string in list, -1 if not found
+template <std::size_t N>
+int GetIndex(const char *(&list)[N], std::string_view str) {
+  for (std::size_t i = 0; i < N; ++i) {
+    if (str == list[i]) return i;
+  }
+  return -1;
+}
+
+// check if the specific value is a terminator of block
+bool IsTerminator(const SSAPtr &val) {
+  switch (val->kind()) {
+    case SSAKind::Branch: case SSAKind::Jump: case SSAKind::Return:
+      return true;
+    default: return false;
+  }
+}
+
+// check if the specific value is a basic block
+bool IsBlock(const SSAPtr &val) {
+  return val && val->kind() == SSAKind::Block;
+}
+
+// get type of the specific operand, null if operand has no type
+TypePtr GetOprType(const User *user, std::size_t index) {
+  const auto &opr = (*user)[index].value();
+  return opr ? opr->type() : nullptr;
+}
+
+// parser of textual IR
+class IRParser {
+ public:
+  IRParser(std::string_view text, ValueContext &ctx)
+      : cur_(text.data()), end_(text.data() + text.size()), ctx_(ctx),
+        line_pos_(1), col_pos_(1) {}
+
+  // parse global variables & functions
+  bool Parse(UserPtrList &vars, UserPtrList &funcs);
+
+ private:
+  // kind of tokens
+  enum class Token {
+    End, Error, Id, Type, Local, Global, Int, Str, Other,
+  };
+
+  // reference of value, may be unresolved
+  struct ValRef {
+    SSAPtr value;
+    std::string_view name;
+    LogPtr logger;
+    // type in front of value, null if not present
+    TypePtr type;
+  };
+
+  // unresolved operand
+  struct Fixup {
+    User *user;
+    std::size_t index;
+    ValRef ref;
+  };
+
+  // lexer
+  Token NextToken();
+  void NextChar();
+  Token ReadStr();
+  // get the next non-space character without consuming it
+  char PeekChar() const {
+    auto p = cur_;
+    while (p != end_ && std::isspace(*p)) ++p;
+    return p != end_ ? *p : '\0';
+  }
+  // check current token
+  bool IsChar(char c) const {
+    return cur_token_ == Token::Other && token_[0] == c;
+  }
+  bool IsId(std::string_view id) const {
+    return cur_token_ == Token::Id && token_ == id;
+  }
+  // expect the specific token and get the next token
+  bool ExpectChar(char c);
+  bool ExpectId(std::string_view id);
+
+  // print error message, always returns false
+  bool LogError(std::string_view message);
+  // create a logger of the current token
+  LogPtr MakeLogger() const {
+    return std::make_shared<Logger>(token_line_, token_col_);
+  }
+  // create a new SSA value
+  template <typename T, typename... Args>
+  std::shared_ptr<T> NewValue(Args &&... args) {
+    auto ssa = ctx_.NewValue<T>(std::forward<Args>(args)...);
+    ssa->set_logger(logger_);
+    return ssa;
+  }
+
+  // parse types
+  TypePtr ParseType();
+  TypePtr ParseTypeId(std::string_view &id);
+  // parse values
+  bool ParseValue(ValRef &ref);
+  bool ParseTypedValue(ValRef &ref);
+  bool ParseConst(ValRef &ref);
+  // parse values and set them as operands of user
+  bool ParseOperands(User *user, std::size_t count, bool with_type);
+  // set operand of user, or record as unresolved operand
+  bool SetOperand(User *user, std::size_t index, const ValRef &ref);
+  // check if the value matches the type in reference
+  static bool IsTypeMatched(const ValRef &ref, const SSAPtr &value) {
+    const auto &type = value->type();
+    return !ref.type || (type && type->IsIdentical(ref.type));
+  }
+  // resolve unresolved operands
+  bool ResolveLocals();
+  bool ResolveGlobals();
+
+  // parse global definitions
+  bool ParseGlobalVar(UserPtrList &vars);
+  bool ParseFunction(UserPtrList &funcs);
+  bool ParseBlock();
+  bool ParseInst(BlockSSA *block);
+  SSAPtr ParseAssignInst();
+
+  // check types of constants & instructions, returns error message
+  const char *CheckConst(const SSAPtr &val);
+  const char *CheckInst(const SSAPtr &inst, const TypePtr &ret_type);
+  // check types of all parsed values
+  bool CheckTypes(const UserPtrList &vars, const UserPtrList &funcs);
+
+  // input buffer
+  const char *cur_, *end_;
+  ValueContext &ctx_;
+  // lexer status
+  std::size_t line_pos_, col_pos_, token_line_, token_col_;
+  Token cur_token_;
+  std::string_view token_;
+  std::string str_val_;
+  std::int64_t int_val_;
+  // parser status
+  LogPtr logger_;
+  FuncPtr cur_func_;
+  std::unordered_map<std::string_view, SSAPtr> globals_, locals_;
+  std::vector<Fixup> global_fixups_, local_fixups_;
+};
+
+}  // namespace
+
+
+void IRParser::NextChar() {
+  if (*cur_ == '\n') {
+    ++line_pos_;
+    col_pos_ = 1;
+  }
+  else {
+    ++col_pos_;
+  }
+  ++cur_;
+}
+
+IRParser::Token IRParser::NextToken() {
+  // skip spaces
+  while (cur_ != end_ && std::isspace(*cur_)) NextChar();
+  token_line_ = line_pos_;
+  token_col_ = col_pos_;
+  if (cur_ == end_) return cur_token_ = Token::End;
+  auto start = cur_;
+  auto c = *cur_;
+  if (c == '"') return cur_token_ = ReadStr();
+  // get kind of token by the first character
+  auto is_word = [](char c) { return std::isalnum(c) || c == '_'; };
+  Token kind;
+  if (std::isalpha(c) || c == '_') {
+    kind = Token::Id;
+    while (cur_ != end_ && is_word(*cur_)) NextChar();
+  }
+  else if (c == '$') {
+    kind = Token::Type;
+    while (cur_ != end_ && (is_word(*cur_) || *cur_ == '$')) NextChar();
+  }
+  else if (c == '%' || c == '@') {
+    kind = c == '%' ? Token::Local : Token::Global;
+    NextChar();
+    while (cur_ != end_ && (is_word(*cur_) || *cur_ == '.')) NextChar();
+    if (cur_ - start == 1) kind = Token::Error;
+  }
+  else if (std::isdigit(c) || c == '-') {
+    kind = Token::Int;
+    NextChar();
+    while (cur_ != end_ && std::isdigit(*cur_)) NextChar();
+    token_ = {start, static_cast<std::size_t>(cur_ - start)};
+    if (token_ == "-") return cur_token_ = Token::Error;
+    int_val_ = std::strtoll(std::string(token_).c_str(), nullptr, 10);
+    return cur_token_ = kind;
+  }
+  else {
+    kind = Token::Other;
+    NextChar();
+  }
+  token_ = {start, static_cast<std::size_t>(cur_ - start)};
+  return cur_token_ = kind;
+}
+
+IRParser::Token IRParser::ReadStr() {
+  str_val_.clear();
+  NextChar();
+  while (cur_ != end_ && *cur_ != '"') {
+    auto c = *cur_;
+    NextChar();
+    if (c != '\\') {
+      str_val_ += c;
+      continue;
+    }
+    // read escape character
+    if (cur_ == end_) return Token::Error;
+    c = *cur_;
+    NextChar();
+    switch (c) {
+      case 'a': str_val_ += '\a'; break;
+      case 'b': str_val_ += '\b'; break;
+      case 'f': str_val_ += '\f'; break;
+      case 'n': str_val_ += '\n'; break;
+      case 'r': str_val_ += '\r'; break;
+      case 't': str_val_ += '\t'; break;
+      case 'v': str_val_ += '\v'; break;
+      case '0': str_val_ += '\0'; break;
+      case 'x': {
+        int value = 0, count = 0;
+        while (cur_ != end_ && std::isxdigit(*cur_) && count < 2) {
+          auto d = std::tolower(*cur_);
+          value = value * 16 + (std::isdigit(d) ? d - '0' : d - 'a' + 10);
+          ++count;
+          NextChar();
+        }
+        if (!count) return Token::Error;
+        str_val_ += static_cast<char>(value);
+        break;
+      }
+      default: str_val_ += c; break;
+    }
+  }
+  if (cur_ == end_) return Token::Error;
+  NextChar();
+  return Token::Str;
+}
+
+bool IRParser::ExpectChar(char c) {
+  if (!IsChar(c)) {
+    return LogError(std::string("expected '") + c + "'");
+  }
+  NextToken();
+  return true;
+}
+
+bool IRParser::ExpectId(std::string_view id) {
+  if (!IsId(id)) {
+    return LogError("expected '" + std::string(id) + "'");
+  }
+  NextToken();
+  return true;
+}
+
+bool IRParser::LogError(std::string_view message) {
+  Logger(token_line_, token_col_).LogError(message);
+  return false;
+}
+
+TypePtr IRParser::ParseType() {
+  if (cur_token_ != Token::Id && cur_token_ != Token::Type) {
+    LogError("expected type");
+    return nullptr;
+  }
+  auto id = token_;
+  auto type = ParseTypeId(id);
+  if (!type || !id.empty()) {
+    LogError("invalid type or unsupported structure type");
+    return nullptr;
+  }
+  NextToken();
+  return type;
+}
+
+TypePtr IRParser::ParseTypeId(std::string_view &id) {
+  // primitive types
+  const std::pair<const char *, PrimType::Type> kPrimTypes[] = {
+    {"void", PrimType::Type::Void}, {"i8", PrimType::Type::Int8},
+    {"i32", PrimType::Type::Int32}, {"u8", PrimType::Type::UInt8},
+    {"u32", PrimType::Type::UInt32},
+  };
+  if (id.empty()) return nullptr;
+  if (id[0] != '$') {
+    for (const auto &[name, type] : kPrimTypes) {
+      auto len = std::strlen(name);
+      if (id.substr(0, len) == name &&
+          (id.size() == len || !std::isdigit(id[len]))) {
+        id.remove_prefix(len);
+        return MakePrimType(type, false);
+      }
+    }
+    return nullptr;
+  }
+  // pointer type
+  id.remove_prefix(1);
+  if (!id.empty() && id[0] == 'p') {
+    id.remove_prefix(1);
+    auto base = ParseTypeId(id);
+    return base ? MakePointer(base, false) : nullptr;
+  }
+  // get length of array or argument count of function
+  std::size_t len = 0, digits = 0;
+  while (digits < id.size() && std::isdigit(id[digits])) {
+    len = len * 10 + id[digits++] - '0';
+  }
+  if (!digits || digits == id.size()) return nullptr;
+  auto kind = id[digits];
+  id.remove_prefix(digits + 1);
+  if (kind == 'a') {
+    auto base = ParseTypeId(id);
+    return base ? MakeArray(base, len, false) : nullptr;
+  }
+  else if (kind == 'f') {
+    TypePtrList args;
+    for (std::size_t i = 0; i < len; ++i) {
+      auto arg = ParseTypeId(id);
+      if (!arg) return nullptr;
+      args.push_back(arg);
+    }
+    if (id.empty() || id[0] != '$') return nullptr;
+    id.remove_prefix(1);
+    auto ret = ParseTypeId(id);
+    return ret ? MakeFunc(args, ret, false) : nullptr;
+  }
+  return nullptr;
+}
+
+bool IRParser::ParseValue(ValRef &ref) {
+  ref = {nullptr, {}, MakeLogger()};
+  switch (cur_token_) {
+    case Token::Local: case Token::Global: {
+      // find in defined values
+      auto it = locals_.find(token_);
+      if (it != locals_.end()) {
+        ref.value = it->second;
+      }
+      else if ((it = globals_.find(token_)) != globals_.end()) {
+        ref.value = it->second;
+      }
+      else {
+        ref.name = token_;
+      }
+      NextToken();
+      return true;
+    }
+    case Token::Id: {
+      if (IsId("constant")) return ParseConst(ref);
+      if (IsId("arg")) {
+        if (NextToken() != Token::Int || !cur_func_ || int_val_ < 0) {
+          return LogError("invalid argument reference");
+        }
+        const auto &args = cur_func_->args();
+        if (static_cast<std::size_t>(int_val_) >= args.size()) {
+          return LogError("invalid argument reference");
+        }
+        ref.value = args[int_val_];
+        NextToken();
+        return true;
+      }
+      if (IsId("cast")) {
+        // constant casting
+        NextToken();
+        auto type = ParseType();
+        if (!type) return false;
+        auto cast = NewValue<CastSSA>(nullptr);
+        cast->set_type(type);
+        if (!ParseOperands(cast.get(), 1, false)) return false;
+        ref.value = cast;
+        return true;
+      }
+      break;
+    }
+    case Token::Type: break;
+    case Token::Other: {
+      if (!IsChar('[')) return LogError("invalid value");
+      // phi operand
+      NextToken();
+      auto phi_opr = NewValue<PhiOperandSSA>(nullptr, nullptr);
+      if (!ParseOperands(phi_opr.get(), 2, false)) return false;
+      if (!ExpectChar(']')) return false;
+      ref.value = phi_opr;
+      return true;
+    }
+    default: return LogError("invalid value");
+  }
+  // undefined value
+  auto type = ParseType();
+  if (!type || !ExpectId("undef")) return false;
+  auto undef = NewValue<UndefSSA>();
+  undef->set_type(type);
+  ref.value = undef;
+  return true;
+}
+
+bool IRParser::ParseTypedValue(ValRef &ref) {
+  auto type = ParseType();
+  if (!type || !ParseValue(ref)) return false;
+  ref.type = type;
+  return true;
+}
+
+bool IRParser::ParseConst(ValRef &ref) {
+  NextToken();
+  auto type = ParseType();
+  if (!type) return false;
+  if (cur_token_ == Token::Int) {
+    // constant integer
+    auto value = NewValue<ConstIntSSA>(int_val_ & UINT32_MAX);
+    NextToken();
+    value->set_type(type);
+    ref.value = value;
+  }
+  else if (cur_token_ == Token::Str) {
+    // constant string
+    auto value = NewValue<ConstStrSSA>(str_val_);
+    NextToken();
+    value->set_type(type);
+    ref.value = value;
+  }
+  else if (IsId("zero")) {
+    // constant zero
+    auto value = NewValue<ConstZeroSSA>();
+    NextToken();
+    value->set_type(type);
+    ref.value = value;
+  }
+  else if (IsChar('{')) {
+    // constant array
+    if (!type->IsArray()) {
+      return LogError("unsupported constant aggregate type");
+    }
+    NextToken();
+    auto value = NewValue<ConstArraySSA>(SSAPtrList());
+    value->set_type(type);
+    if (!IsChar('}')) {
+      for (std::size_t i = 0;; ++i) {
+        ValRef elem;
+        if (!ParseValue(elem)) return false;
+        value->Resize(i + 1);
+        SetOperand(value.get(), i, elem);
+        if (!IsChar(',')) break;
+        NextToken();
+      }
+    }
+    if (!ExpectChar('}')) return false;
+    ref.value = value;
+  }
+  else {
+    return LogError("invalid constant");
+  }
+  return true;
+}
+
+bool IRParser::ParseOperands(User *user, std::size_t count,
+                             bool with_type) {
+  user->Resize(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i && !ExpectChar(',')) return false;
+    ValRef ref;
+    if (!(with_type ? ParseTypedValue(ref) : ParseValue(ref))) {
+      return false;
+    }
+    if (!SetOperand(user, i, ref)) return false;
+  }
+  return true;
+}
+
+bool IRParser::SetOperand(User *user, std::size_t index,
+                          const ValRef &ref) {
+  if (ref.value) {
+    if (!IsTypeMatched(ref, ref.value)) {
+      ref.logger->LogError("type mismatch");
+      return false;
+    }
+    (*user)[index].set_value(ref.value);
+  }
+  else {
+    local_fixups_.push_back({user, index, ref});
+  }
+  return true;
+}
+
+bool IRParser::ResolveLocals() {
+  for (const auto &fixup : local_fixups_) {
+    auto it = locals_.find(fixup.ref.name);
+    if (it != locals_.end()) {
+      if (!IsTypeMatched(fixup.ref, it->second)) {
+        fixup.ref.logger->LogError("type mismatch", fixup.ref.name);
+        return false;
+      }
+      (*fixup.user)[fixup.index].set_value(it->second);
+    }
+    else if (fixup.ref.name[0] == '@' &&
+             fixup.ref.name.find('.') == std::string_view::npos) {
+      // may be a global value
+      global_fixups_.push_back(fixup);
+    }
+    else {
+      fixup.ref.logger->LogError("undefined value", fixup.ref.name);
+      return false;
+    }
+  }
+  local_fixups_.clear();
+  return true;
+}
+
+bool IRParser::ResolveGlobals() {
+  for (const auto &fixup : global_fixups_) {
+    auto it = globals_.find(fixup.ref.name);
+    if (it == globals_.end()) {
+      fixup.ref.logger->LogError("undefined value", fixup.ref.name);
+      return false;
+    }
+    if (!IsTypeMatched(fixup.ref, it->second)) {
+      fixup.ref.logger->LogError("type mismatch", fixup.ref.name);
+      return false;
+    }
+    (*fixup.user)[fixup.index].set_value(it->second);
+  }
+  global_fixups_.clear();
+  return true;
+}
+
+bool IRParser::ParseGlobalVar(UserPtrList &vars) {
+  // get name
+  auto id = token_;
+  logger_ = MakeLogger();
+  if (globals_.count(id)) return LogError("redefinition of global value");
+  NextToken();
+  if (!ExpectChar('=')) return false;
+  // get linkage type
+  auto link = cur_token_ == Token::Id ? GetIndex(kLinkTypes, token_) : -1;
+  if (link < 0) return LogError("invalid linkage type");
+  NextToken();
+  if (!ExpectId("global")) return false;
+  // get variable/constant & type
+  if (!IsId("var") && !IsId("const")) {
+    return LogError("expected 'var' or 'const'");
+  }
+  bool is_var = IsId("var");
+  NextToken();
+  auto type = ParseType();
+  if (!type) return false;
+  // create global variable
+  auto var = NewValue<GlobalVarSSA>(static_cast<LinkageTypes>(link),
+                                    is_var, std::string(id.substr(1)),
+                                    nullptr);
+  var->set_type(type);
+  globals_.insert({id, var});
+  vars.push_back(var);
+  // get initializer
+  if (IsChar(',')) {
+    NextToken();
+    ValRef init;
+    if (!ParseValue(init)) return false;
+    SetOperand(var.get(), 0, init);
+  }
+  return true;
+}
+
+bool IRParser::ParseFunction(UserPtrList &funcs) {
+  bool is_decl = IsId("declare");
+  logger_ = MakeLogger();
+  NextToken();
+  // get linkage type & type
+  auto link = cur_token_ == Token::Id ? GetIndex(kLinkTypes, token_) : -1;
+  if (link < 0) return LogError("invalid linkage type");
+  NextToken();
+  auto type = ParseType();
+  if (!type) return false;
+  if (!type->IsFunction()) return LogError("expected function type");
+  // get name
+  if (cur_token_ != Token::Global) return LogError("expected name");
+  auto id = token_;
+  if (globals_.count(id)) return LogError("redefinition of global value");
+  NextToken();
+  // create function
+  auto func = NewValue<FunctionSSA>(static_cast<LinkageTypes>(link),
+                                    std::string(id.substr(1)));
+  func->set_type(type);
+  globals_.insert({id, func});
+  funcs.push_back(func);
+  if (is_decl) return true;
+  // create argument references
+  auto args = *type->GetArgsType();
+  for (std::size_t i = 0; i < args.size(); ++i) {
+    auto arg_ref = NewValue<ArgRefSSA>(func, i);
+    arg_ref->set_type(args[i]);
+    func->set_arg(i, arg_ref);
+  }
+  // parse blocks
+  cur_func_ = func;
+  locals_.clear();
+  if (!ExpectChar('{')) return false;
+  while (!IsChar('}')) {
+    if (!ParseBlock()) return false;
+  }
+  NextToken();
+  if (func->empty()) return LogError("function has no basic block");
+  auto ret = ResolveLocals();
+  cur_func_ = nullptr;
+  locals_.clear();
+  return ret;
+}
+
+bool IRParser::ParseBlock() {
+  // get name of block
+  if (cur_token_ != Token::Local && cur_token_ != Token::Global) {
+    return LogError("expected basic block");
+  }
+  auto id = token_;
+  logger_ = MakeLogger();
+  if (locals_.count(id)) return LogError("redefinition of value");
+  NextToken();
+  if (!ExpectChar(':')) return false;
+  std::string name;
+  if (id[0] == '@') {
+    auto pos = id.rfind('.');
+    name = id.substr(1, pos == std::string_view::npos ? pos : pos - 1);
+  }
+  // create block
+  auto block = NewValue<BlockSSA>(cur_func_, name);
+  block->set_type(nullptr);
+  locals_.insert({id, block});
+  cur_func_->AddValue(block);
+  // get predecessors
+  if (IsChar(';')) {
+    NextToken();
+    if (!ExpectId("preds") || !ExpectChar(':')) return false;
+    for (std::size_t i = 0;; ++i) {
+      ValRef pred;
+      if (!ParseValue(pred)) return false;
+      block->Resize(i + 1);
+      SetOperand(block.get(), i, pred);
+      if (!IsChar(',')) break;
+      NextToken();
+    }
+  }
+  // parse instructions
+  while (cur_token_ != Token::End && !IsChar('}')) {
+    // check if is the start of the next block
+    if (cur_token_ == Token::Global) break;
+    if (cur_token_ == Token::Local && PeekChar() == ':') break;
+    if (!ParseInst(block.get())) return false;
+  }
+  // block must be terminated
+  const auto &insts = block->insts();
+  if (insts.empty() || !IsTerminator(insts.back())) {
+    block->logger()->LogError("basic block is not terminated");
+    return false;
+  }
+  return true;
+}
+
+bool IRParser::ParseInst(BlockSSA *block) {
+  logger_ = MakeLogger();
+  const auto &insts = block->insts();
+  if (!insts.empty() && IsTerminator(insts.back())) {
+    return LogError("instruction after terminator");
+  }
+  SSAPtr inst;
+  if (cur_token_ == Token::Local) {
+    // instructions with result
+    auto id = token_;
+    if (locals_.count(id)) return LogError("redefinition of value");
+    NextToken();
+    if (!ExpectChar('=')) return false;
+    inst = ParseAssignInst();
+    if (!inst) return false;
+    locals_.insert({id, inst});
+  }
+  else if (IsId("store")) {
+    NextToken();
+    auto store = NewValue<StoreSSA>(nullptr, nullptr);
+    if (!ParseOperands(store.get(), 2, true)) return false;
+    inst = store;
+  }
+  else if (IsId("branch")) {
+    NextToken();
+    auto branch = NewValue<BranchSSA>(nullptr, nullptr, nullptr);
+    if (!ParseOperands(branch.get(), 3, false)) return false;
+    inst = branch;
+  }
+  else if (IsId("jump")) {
+    NextToken();
+    auto jump = NewValue<JumpSSA>(nullptr);
+    if (!ParseOperands(jump.get(), 1, false)) return false;
+    inst = jump;
+  }
+  else if (IsId("return")) {
+    NextToken();
+    auto ret = NewValue<ReturnSSA>(nullptr);
+    if (IsId("void")) {
+      NextToken();
+    }
+    else if (!ParseOperands(ret.get(), 1, true)) {
+      return false;
+    }
+    inst = ret;
+  }
+  else {
+    return LogError("invalid instruction");
+  }
+  block->AddInst(inst);
+  return true;
+}
+
+SSAPtr IRParser::ParseAssignInst() {
+  if (cur_token_ != Token::Id) {
+    LogError("expected instruction");
+    return nullptr;
+  }
+  auto opcode = token_;
+  NextToken();
+  // parse instructions
+  UserPtr inst;
+  TypePtr type;
+  if (opcode == "alloca") {
+    type = ParseType();
+    if (!type) return nullptr;
+    auto alloca = NewValue<AllocaSSA>();
+    alloca->set_type(type);
+    return alloca;
+  }
+  else if (opcode == "load") {
+    if (!(type = ParseType()) || !ExpectChar(',')) return nullptr;
+    inst = NewValue<LoadSSA>(nullptr);
+    if (!ParseOperands(inst.get(), 1, true)) return nullptr;
+  }
+  else if (opcode == "access") {
+    using AccType = AccessSSA::AccessType;
+    if (!IsId("ptr") && !IsId("elem")) {
+      LogError("expected 'ptr' or 'elem'");
+      return nullptr;
+    }
+    auto acc_type = IsId("ptr") ? AccType::Pointer : AccType::Element;
+    NextToken();
+    // get type of pointer
+    auto ptr_type = ParseType();
+    if (!ptr_type) return nullptr;
+    auto base = ptr_type->GetDerefedType();
+    if (!base || (acc_type == AccType::Element && !base->IsArray())) {
+      LogError("invalid pointer type");
+      return nullptr;
+    }
+    type = acc_type == AccType::Pointer
+               ? ptr_type : MakePointer(base->GetDerefedType(), false);
+    inst = NewValue<AccessSSA>(acc_type, nullptr, nullptr);
+    // parse pointer & index
+    ValRef ref;
+    if (!ParseValue(ref) || !ExpectChar(',')) return nullptr;
+    inst->Resize(2);
+    SetOperand(inst.get(), 0, ref);
+    if (!ParseValue(ref)) return nullptr;
+    SetOperand(inst.get(), 1, ref);
+  }
+  else if (auto op = GetIndex(kBinOps, opcode); op >= 0) {
+    if (!(type = ParseType())) return nullptr;
+    inst = NewValue<BinarySSA>(static_cast<BinarySSA::Operator>(op),
+                               nullptr, nullptr);
+    if (!ParseOperands(inst.get(), 2, false)) return nullptr;
+  }
+  else if (auto op = GetIndex(kUnaOps, opcode); op >= 0) {
+    if (!(type = ParseType())) return nullptr;
+    inst = NewValue<UnarySSA>(static_cast<UnarySSA::Operator>(op),
+                              nullptr);
+    if (!ParseOperands(inst.get(), 1, false)) return nullptr;
+  }
+  else if (opcode == "cast") {
+    if (!(type = ParseType())) return nullptr;
+    inst = NewValue<CastSSA>(nullptr);
+    if (!ParseOperands(inst.get(), 1, false)) return nullptr;
+  }
+  else if (opcode == "call") {
+    // get type of callee
+    auto callee_type = ParseType();
+    if (!callee_type) return nullptr;
+    if (!callee_type->IsFunction()) {
+      LogError("expected function type");
+      return nullptr;
+    }
+    auto args = *callee_type->GetArgsType();
+    type = callee_type->GetReturnType(args);
+    // parse callee & arguments
+    inst = NewValue<CallSSA>(nullptr, SSAPtrList());
+    if (!ParseOperands(inst.get(), args.size() + 1, false)) return nullptr;
+  }
+  else if (opcode == "phi") {
+    if (!(type = ParseType())) return nullptr;
+    inst = NewValue<PhiSSA>(SSAPtrList());
+    for (std::size_t i = 0;; ++i) {
+      ValRef opr;
+      if (!ParseValue(opr)) return nullptr;
+      if (!opr.value || !IsSSA<PhiOperandSSA>(opr.value)) {
+        LogError("expected phi operand");
+        return nullptr;
+      }
+      opr.value->set_type(type);
+      inst->Resize(i + 1);
+      SetOperand(inst.get(), i, opr);
+      if (!IsChar(',')) break;
+      NextToken();
+    }
+  }
+  else if (opcode == "select") {
+    inst = NewValue<SelectSSA>(nullptr, nullptr, nullptr);
+    inst->Resize(3);
+    for (std::size_t i = 0; i < 3; ++i) {
+      if (i && !ExpectChar(',')) return nullptr;
+      ValRef ref;
+      if (!ParseTypedValue(ref)) return nullptr;
+      if (i == 1) type = ref.type;
+      if (!SetOperand(inst.get(), i, ref)) return nullptr;
+    }
+  }
+  else {
+    LogError("invalid instruction");
+    return nullptr;
+  }
+  inst->set_type(type);
+  return inst;
+}
+
+const char *IRParser::CheckConst(const SSAPtr &val) {
+  if (!val) return nullptr;
+  if (val->kind() == SSAKind::ConstArray) {
+    // elements of constant array
+    const auto &type = val->type();
+    auto user = static_cast<User *>(val.get());
+    if (user->size() != type->GetLength()) {
+      return "invalid length of constant array";
+    }
+    for (std::size_t i = 0; i < user->size(); ++i) {
+      auto elem = GetOprType(user, i);
+      if (!elem || !elem->IsIdentical(type->GetDerefedType())) {
+        return "type mismatch in constant array";
+      }
+      if (auto msg = CheckConst((*user)[i].value())) return msg;
+    }
+  }
+  else if (val->kind() == SSAKind::Cast && !val->parent_block()) {
+    // constant casting
+    auto opr = GetOprType(static_cast<User *>(val.get()), 0);
+    if (!opr || !(opr->IsIdentical(val->type()) ||
+                  opr->CanCastTo(val->type()))) {
+      return "invalid type casting";
+    }
+    return CheckConst((*static_cast<User *>(val.get()))[0].value());
+  }
+  return nullptr;
+}
+
+const char *IRParser::CheckInst(const SSAPtr &inst,
+                                const TypePtr &ret_type) {
+  using AccType = AccessSSA::AccessType;
+  using UnaryOp = UnarySSA::Operator;
+  const auto &type = inst->type();
+  if (inst->kind() == SSAKind::Alloca) {
+    if (!type->IsPointer() || type->GetDerefedType()->IsVoid()) {
+      return "invalid type of allocation";
+    }
+    return nullptr;
+  }
+  // check constant operands
+  auto user = static_cast<User *>(inst.get());
+  for (const auto &i : *user) {
+    if (auto msg = CheckConst(i.value())) return msg;
+  }
+  // check operands & result by opcode
+  auto opr = [user](std::size_t i) { return GetOprType(user, i); };
+  switch (inst->kind()) {
+    case SSAKind::Load: {
+      auto ptr = opr(0);
+      if (!ptr || !ptr->IsPointer() ||
+          !type->IsIdentical(ptr->GetDerefedType())) {
+        return "type mismatch in load";
+      }
+      break;
+    }
+    case SSAKind::Store: {
+      auto val = opr(0), ptr = opr(1);
+      if (!val || !ptr || !ptr->IsPointer() ||
+          !val->IsIdentical(ptr->GetDerefedType())) {
+        return "type mismatch in store";
+      }
+      break;
+    }
+    case SSAKind::Access: {
+      auto ptr = opr(0), index = opr(1);
+      if (!ptr || !ptr->IsPointer() || !index || !index->IsInteger()) {
+        return "invalid operand of access";
+      }
+      auto base = ptr->GetDerefedType();
+      TypePtr result;
+      if (SSACast<AccessSSA>(inst.get())->acc_type() == AccType::Pointer) {
+        result = ptr;
+      }
+      else if (base->IsArray()) {
+        result = MakePointer(base->GetDerefedType(), false);
+      }
+      if (!result || !type->IsIdentical(result)) {
+        return "type mismatch in access";
+      }
+      break;
+    }
+    case SSAKind::Binary: {
+      auto lhs = opr(0), rhs = opr(1);
+      if (!lhs || !rhs || !lhs->IsIdentical(rhs)) {
+        return "operand type mismatch in binary operation";
+      }
+      if (SSACast<BinarySSA>(inst.get())->IsCmp()) {
+        if (!lhs->IsInteger() && !lhs->IsPointer() &&
+            !lhs->IsFunction()) {
+          return "invalid operand of comparison";
+        }
+        if (!type->IsInteger()) return "invalid type of comparison";
+      }
+      else if (!lhs->IsInteger() || !type->IsIdentical(lhs)) {
+        return "type mismatch in binary operation";
+      }
+      break;
+    }
+    case SSAKind::Unary: {
+      auto operand = opr(0);
+      if (!operand || !operand->IsInteger()) {
+        return "invalid operand of unary operation";
+      }
+      bool is_lnot =
+          SSACast<UnarySSA>(inst.get())->op() == UnaryOp::LogicNot;
+      if (is_lnot ? !type->IsInteger() : !type->IsIdentical(operand)) {
+        return "type mismatch in unary operation";
+      }
+      break;
+    }
+    case SSAKind::Cast: {
+      auto operand = opr(0);
+      if (!operand ||
+          !(operand->IsIdentical(type) || operand->CanCastTo(type))) {
+        return "invalid type casting";
+      }
+      break;
+    }
+    case SSAKind::Call: {
+      auto callee = opr(0);
+      if (!callee || !callee->IsFunction()) return "invalid callee";
+      auto args = *callee->GetArgsType();
+      if (args.size() != user->size() - 1) {
+        return "argument count mismatch";
+      }
+      for (std::size_t i = 0; i < args.size(); ++i) {
+        auto arg = opr(i + 1);
+        if (!arg || !arg->IsIdentical(args[i]->GetTrivialType())) {
+          return "argument type mismatch";
+        }
+      }
+      if (!type->IsIdentical(callee->GetReturnType(args))) {
+        return "return type mismatch in call";
+      }
+      break;
+    }
+    case SSAKind::Branch: {
+      auto cond = opr(0);
+      if (!cond || !cond->IsInteger()) return "invalid branch condition";
+      if (!IsBlock((*user)[1].value()) || !IsBlock((*user)[2].value())) {
+        return "expected basic block";
+      }
+      break;
+    }
+    case SSAKind::Jump: {
+      if (!IsBlock((*user)[0].value())) return "expected basic block";
+      break;
+    }
+    case SSAKind::Return: {
+      auto val = user->size() ? opr(0) : nullptr;
+      if (ret_type->IsVoid() ? val != nullptr
+                             : !val || !val->IsIdentical(ret_type)) {
+        return "return type mismatch";
+      }
+      break;
+    }
+    case SSAKind::Phi: {
+      for (const auto &i : *user) {
+        auto phi_opr = static_cast<User *>(i.value().get());
+        auto val = GetOprType(phi_opr, 0);
+        if (!val || !val->IsIdentical(type)) {
+          return "type mismatch in phi";
+        }
+        if (!IsBlock((*phi_opr)[1].value())) return "expected basic block";
+      }
+      break;
+    }
+    case SSAKind::Select: {
+      auto cond = opr(0), true_val = opr(1), false_val = opr(2);
+      if (!cond || !cond->IsInteger()) return "invalid select condition";
+      if (!true_val || !false_val || !type->IsIdentical(true_val) ||
+          !type->IsIdentical(false_val)) {
+        return "type mismatch in select";
+      }
+      break;
+    }
+    default: assert(false);
+  }
+  return nullptr;
+}
+
+bool IRParser::CheckTypes(const UserPtrList &vars,
+                          const UserPtrList &funcs) {
+  // check global variables
+  for (const auto &var : vars) {
+    const auto &type = var->type();
+    const char *msg = nullptr;
+    if (!type->IsPointer()) {
+      msg = "invalid type of global variable";
+    }
+    else if (const auto &init = (*var)[0].value()) {
+      if (!init->type() ||
+          !init->type()->IsIdentical(type->GetDerefedType()) ||
+          !init->IsConst()) {
+        msg = "invalid initializer";
+      }
+      else {
+        msg = CheckConst(init);
+      }
+    }
+    if (msg) {
+      var->logger()->LogError(msg);
+      return false;
+    }
+  }
+  // check instructions in functions
+  for (const auto &func : funcs) {
+    const auto &type = func->type();
+    auto ret_type = type->GetReturnType(*type->GetArgsType());
+    for (const auto &i : *func) {
+      auto block = SSACast<BlockSSA>(i.value().get());
+      for (const auto &pred : *block) {
+        if (!IsBlock(pred.value())) {
+          block->logger()->LogError("expected basic block");
+          return false;
+        }
+      }
+      for (const auto &inst : block->insts()) {
+        if (auto msg = CheckInst(inst, ret_type)) {
+          inst->logger()->LogError(msg);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool IRParser::Parse(UserPtrList &vars, UserPtrList &funcs) {
+  NextToken();
+  while (cur_token_ != Token::End) {
+    if (cur_token_ == Token::Global) {
+      if (!ParseGlobalVar(vars)) return false;
+    }
+    else if (IsId("declare") || IsId("define")) {
+      if (!ParseFunction(funcs)) return false;
+    }
+    else {
+      return LogError("expected global variable or function");
+    }
+  }
+  // resolve the remaining operands in global variables
+  if (!ResolveLocals() || !ResolveGlobals()) return false;
+  return CheckTypes(vars, funcs);
+}
+
+
+bool Module::Parse(std::string_view text) {
+  ClearContent();
+  // parse textual IR
+  IRParser parser(text, *value_ctx_);
+  if (!parser.Parse(vars_, funcs_)) {
+    vars_.clear();
+    funcs_.clear();
+    return false;
+  }
+  return true;
+}
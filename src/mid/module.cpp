@@ -1,5 +1,7 @@
 #include "mid/module.h"
 
+#include <cstdlib>
+
 #include "opt/helper/cast.h"
 
 using namespace mimic::mid;
@@ -7,6 +9,7 @@ using namespace mimic::define;
 using namespace mimic::front;
 using namespace mimic::opt;
 using namespace mimic::back;
+using namespace mimic::utils;
 
 #define CREATE_BINARY(op, lhs, rhs)                    \
   do {                                                 \
@@ -40,8 +43,57 @@ namespace {
 using BinaryOp = BinarySSA::Operator;
 using UnaryOp = UnarySSA::Operator;
 
+// value context of the module which is currently running passes
+ValueContextPtr active_value_ctx;
+
 }  // namespace
 
+const ValueContextPtr &mimic::mid::GetActiveValueContext() {
+  return active_value_ctx;
+}
+
+void mimic::mid::ReportNoActiveValueContext() {
+  Logger::LogRawError("creating SSA value without active value context");
+  std::abort();
+}
+
+ValueContext::ValueContext()
+    : owner_(std::this_thread::get_id()), next_id_(1) {
+  static std::atomic<std::size_t> next_serial(1);
+  serial_ = next_serial.fetch_add(1, std::memory_order_relaxed);
+  pools_.push_back(std::make_unique<ValuePool>());
+  owner_pool_ = pools_.back().get();
+}
+
+ValueContext::~ValueContext() {
+  // hold all alive values, and break reference cycles between them
+  std::vector<SSAPtr> values;
+  for (const auto &pool : pools_) {
+    for (const auto &ref : pool->values) {
+      if (auto val = ref.lock()) values.push_back(std::move(val));
+    }
+  }
+  // values that are still held outside the context will survive,
+  // but their references have been dropped, and they are detached
+  // from the id counter of current context
+  for (const auto &val : values) {
+    val->DropAllReferences();
+    val->set_context(serial_, nullptr);
+  }
+}
+
+ValueContext::ValuePool &ValueContext::GetThreadPool() {
+  thread_local std::size_t last_serial = 0;
+  thread_local ValuePool *pool = nullptr;
+  if (last_serial != serial_) {
+    std::lock_guard<std::mutex> lock(pools_mutex_);
+    pools_.push_back(std::make_unique<ValuePool>());
+    pool = pools_.back().get();
+    last_serial = serial_;
+  }
+  return *pool;
+}
+
 void Module::SealGlobalCtor() {
   if (global_ctor_ && !is_ctor_sealed_) {    
     SetInsertPoint(ctor_entry_);
@@ -50,7 +102,7 @@ void Module::SealGlobalCtor() {
   }
 }
 
-void Module::Reset() {
+void Module::ClearContent() {
   vars_.clear();
   funcs_.clear();
   global_ctor_ = nullptr;
@@ -58,7 +110,14 @@ void Module::Reset() {
   ctor_exit_ = nullptr;
   is_ctor_sealed_ = false;
   insert_block_ = nullptr;
-  insert_pos_ = SSAPtrList::iterator();
+  insert_pos_ = InstList::iterator();
+}
+
+void Module::Reset() {
+  ClearContent();
+  // temporary modules share the active value context
+  value_ctx_ = active_value_ctx ? active_value_ctx
+                                : std::make_shared<ValueContext>();
   // reset logger stack
   while (!loggers_.empty()) loggers_.pop();
 }
@@ -537,7 +596,7 @@ xstl::Guard Module::EnterGlobalCtor() {
   if (!global_ctor_) {
     // create function
     auto link = LinkageTypes::GlobalCtor;
-    auto ty = std::make_shared<FuncType>(TypePtrList(), MakeVoid(), true);
+    auto ty = MakeFunc(TypePtrList(), MakeVoid(), true);
     global_ctor_ = CreateFunction(link, "_$ctor", ty);
     // create basic blocks
     ctor_entry_ = CreateBlock(global_ctor_, "entry");
@@ -552,6 +611,12 @@ xstl::Guard Module::EnterGlobalCtor() {
   return xstl::Guard([this, cur_block] { SetInsertPoint(cur_block); });
 }
 
+xstl::Guard Module::EnterValueContext() {
+  auto last_ctx = active_value_ctx;
+  active_value_ctx = value_ctx_;
+  return xstl::Guard([last_ctx] { active_value_ctx = last_ctx; });
+}
+
 void Module::Dump(std::ostream &os) {
   IdManager idm;
   SealGlobalCtor();
@@ -569,6 +634,7 @@ void Module::Dump(std::ostream &os) {
 
 void Module::RunPasses(PassManager &pass_man) {
   SealGlobalCtor();
+  auto ctx = EnterValueContext();
   pass_man.set_vars(&vars_);
   pass_man.set_funcs(&funcs_);
   pass_man.RunPasses();
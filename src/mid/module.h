@@ -2,10 +2,17 @@
 #define MIMIC_MID_MODULE_H_
 
 #include <string>
+#include <string_view>
 #include <ostream>
 #include <utility>
 #include <stack>
 #include <type_traits>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <algorithm>
 
 #include "define/type.h"
 #include "mid/ssa.h"
@@ -16,6 +23,76 @@
 
 namespace mimic::mid {
 
+// context of SSA values, shared by a module and its temporary modules
+// values can be created concurrently by passes running in parallel,
+// each thread logs values it created in its own pool
+// reference cycles between alive values will be broken when the context
+// is destructed, so that they can be released
+class ValueContext {
+ public:
+  ValueContext();
+  ~ValueContext();
+  ValueContext(const ValueContext &) = delete;
+  ValueContext &operator=(const ValueContext &) = delete;
+
+  // create a new SSA value in current context
+  template <typename T, typename... Args>
+  std::shared_ptr<T> NewValue(Args &&... args) {
+    static_assert(std::is_base_of_v<Value, T>);
+    auto &pool = GetPool();
+    auto ssa = std::make_shared<T>(std::forward<Args>(args)...);
+    ssa->set_context(serial_, &next_id_);
+    pool.AddValue(ssa);
+    return ssa;
+  }
+
+ private:
+  // all values created by one thread
+  struct ValuePool {
+    std::vector<SSARef> values;
+
+    // log a new value, drop references of destructed values before
+    // the list grows, so that its size is bounded by alive values
+    void AddValue(const SSAPtr &value) {
+      if (values.size() == values.capacity()) {
+        values.erase(std::remove_if(values.begin(), values.end(),
+                                    [](const SSARef &ref) {
+                                      return ref.expired();
+                                    }),
+                     values.end());
+        // grow if most of the values are still alive
+        if (values.size() * 2 > values.capacity()) {
+          values.reserve(values.capacity() * 2);
+        }
+      }
+      values.push_back(value);
+    }
+  };
+
+  // get value pool of the current thread
+  ValuePool &GetPool() {
+    if (std::this_thread::get_id() == owner_) return *owner_pool_;
+    return GetThreadPool();
+  }
+  // get value pool of the current non-owner thread
+  ValuePool &GetThreadPool();
+
+  // owner thread and its value pool
+  std::thread::id owner_;
+  ValuePool *owner_pool_;
+  // unique serial number, for identifying contexts in thread local caches
+  // and tagging values created by current context
+  std::size_t serial_;
+  // next value id, ids are assigned lazily by values
+  std::atomic<std::size_t> next_id_;
+  // all value pools, the first one belongs to the owner thread
+  std::mutex pools_mutex_;
+  std::vector<std::unique_ptr<ValuePool>> pools_;
+};
+
+// pointer of value context
+using ValueContextPtr = std::shared_ptr<ValueContext>;
+
 class Module {
  public:
   Module() { Reset(); }
@@ -143,7 +220,7 @@ class Module {
   }
   // set insert point to a specific location of the basic block
   // IR should be inserted before the specific location
-  void SetInsertPoint(const BlockPtr &block, SSAPtrList::iterator pos) {
+  void SetInsertPoint(const BlockPtr &block, InstList::iterator pos) {
     insert_block_ = block;
     insert_pos_ = pos;
   }
@@ -156,8 +233,23 @@ class Module {
   // set insert point to global constructor
   xstl::Guard EnterGlobalCtor();
 
+  // set value context of current module as the active context
+  // all SSA values created by passes will be allocated from it
+  xstl::Guard EnterValueContext();
+
   // dump IRs in current module
   void Dump(std::ostream &os);
+  // serialize current module to binary IR
+  void Serialize(std::ostream &os);
+  // replace content of current module with the specific binary IR,
+  // source file name recorded in binary IR will be stored in 'file'
+  // returns false if binary IR is invalid
+  bool Deserialize(std::string_view data, std::string &file);
+  // check if the specific data is binary IR
+  static bool IsSerialized(std::string_view data);
+  // replace content of current module with the specific textual IR,
+  // which is in the format of 'Dump', returns false if failed
+  bool Parse(std::string_view text);
   // run passes on current module
   void RunPasses(opt::PassManager &pass_man);
   // generate current module
@@ -167,8 +259,7 @@ class Module {
   // create a new SSA with current context (logger)
   template <typename T, typename... Args>
   auto MakeSSA(Args &&... args) {
-    static_assert(std::is_base_of_v<Value, T>);
-    auto ssa = std::make_shared<T>(std::forward<Args>(args)...);
+    auto ssa = value_ctx_->NewValue<T>(std::forward<Args>(args)...);
     ssa->set_logger(loggers_.top());
     return ssa;
   }
@@ -183,7 +274,11 @@ class Module {
 
   // seal global constructor
   void SealGlobalCtor();
+  // clear all global variables, functions and insert point
+  void ClearContent();
 
+  // context for creating SSA values
+  ValueContextPtr value_ctx_;
   // context rerlated stuffs
   std::stack<front::LogPtr> loggers_;
   // all global variables and functions
@@ -194,9 +289,22 @@ class Module {
   bool is_ctor_sealed_;
   // current insert point
   BlockPtr insert_block_;
-  SSAPtrList::iterator insert_pos_;
+  InstList::iterator insert_pos_;
 };
 
+// get the active value context
+const ValueContextPtr &GetActiveValueContext();
+// report that there is no active value context and abort
+[[noreturn]] void ReportNoActiveValueContext();
+
+// create a new SSA value in the active value context
+template <typename T, typename... Args>
+inline std::shared_ptr<T> NewSSA(Args &&... args) {
+  const auto &ctx = GetActiveValueContext();
+  if (!ctx) ReportNoActiveValueContext();
+  return ctx->NewValue<T>(std::forward<Args>(args)...);
+}
+
 // make a temporary module to perform IR insertion
 // IR should be inserted before the end of the specific block
 inline Module MakeModule(const front::LogPtr &log, const BlockPtr &block) {
@@ -208,7 +316,7 @@ inline Module MakeModule(const front::LogPtr &log, const BlockPtr &block) {
 // make a temporary module to perform IR insertion
 // IR should be inserted before the specific position
 inline Module MakeModule(const front::LogPtr &log, const BlockPtr &block,
-                         SSAPtrList::iterator pos) {
+                         InstList::iterator pos) {
   Module mod(log);
   mod.SetInsertPoint(block, pos);
   return mod;
@@ -216,7 +324,7 @@ inline Module MakeModule(const front::LogPtr &log, const BlockPtr &block,
 
 // make a temporary module to create specific IR, for one-time use only
 inline Module MakeModule(const front::LogPtr &log) {
-  auto block = std::make_shared<BlockSSA>(nullptr, "");
+  auto block = NewSSA<BlockSSA>(nullptr, "");
   return MakeModule(log, block);
 }
 
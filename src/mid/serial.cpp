@@ -0,0 +1,890 @@
+#include "mid/module.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <cstdint>
+
+#include "opt/helper/cast.h"
+
+using namespace mimic::mid;
+using namespace mimic::define;
+using namespace mimic::front;
+using namespace mimic::opt;
+
+/*
+  layout of binary IR, all integers are encoded in unsigned LEB128
+
+  header:         magic, version
+  strings:        count, (length, bytes)...
+  source file:    string id
+  loggers:        count, (line, column)...
+  structures:     count, (id string, trivial structure id + 1)...
+  types:          count, (tag, fields)...
+  structure body: for each structure, count, (name string, type id)...
+  values:         count, (kind, type id, logger id, fields, operands)...
+  module:         count, (global variable id)..., count, (function id)...
+
+  types are stored in post order, so types only refer to the previous
+  types. type/logger/value ids are stored as 'id + 1', 0 means 'nullptr'.
+  strings are referenced from the input buffer directly when loading,
+  so binary IR can be loaded from a memory-mapped file without copying.
+*/
+
+namespace {
+
+// magic number & version of binary IR
+constexpr std::string_view kMagic = "\x7fMIR";
+constexpr std::uint64_t kVersion = 1;
+
+// tag of types
+enum class TypeTag : std::uint8_t {
+  Void, Int8, Int32, UInt8, UInt32,
+  Struct, Const, Func, Array, Pointer,
+};
+
+// check if the specific kind of SSA value is a user
+bool IsUser(SSAKind kind) {
+  switch (kind) {
+    case SSAKind::Alloca: case SSAKind::ArgRef: case SSAKind::ConstInt:
+    case SSAKind::ConstStr: case SSAKind::ConstZero: case SSAKind::Undef:
+      return false;
+    default: return true;
+  }
+}
+
+// check if operand count is valid for the specific kind of SSA value
+bool IsValidOprCount(SSAKind kind, std::size_t count) {
+  switch (kind) {
+    case SSAKind::Load: case SSAKind::Unary: case SSAKind::Cast:
+    case SSAKind::Jump: case SSAKind::Return: case SSAKind::GlobalVar:
+      return count == 1;
+    case SSAKind::Store: case SSAKind::Access: case SSAKind::Binary:
+    case SSAKind::PhiOperand:
+      return count == 2;
+    case SSAKind::Branch: case SSAKind::Select: return count == 3;
+    case SSAKind::Call: return count >= 1;
+    default: return true;
+  }
+}
+
+// check if the specific kind of SSA value can have no type
+bool IsUntyped(SSAKind kind) {
+  switch (kind) {
+    case SSAKind::Store: case SSAKind::Branch: case SSAKind::Jump:
+    case SSAKind::Return: case SSAKind::Block:
+      return true;
+    default: return false;
+  }
+}
+
+// check if kind of the specific operand is valid
+// for the specific kind of SSA value
+bool IsValidOpr(SSAKind kind, std::size_t index, const SSAPtr &opr) {
+  switch (kind) {
+    case SSAKind::Function: case SSAKind::Block: case SSAKind::Jump: {
+      return opr && opr->kind() == SSAKind::Block;
+    }
+    case SSAKind::Branch: case SSAKind::PhiOperand: {
+      if (index) return opr && opr->kind() == SSAKind::Block;
+      return opr && opr->type();
+    }
+    case SSAKind::Phi: return opr && opr->kind() == SSAKind::PhiOperand;
+    case SSAKind::Return: case SSAKind::GlobalVar: {
+      return !opr || opr->type();
+    }
+    default: return opr && opr->type();
+  }
+}
+
+// check if the specific value is an instruction
+bool IsInstruction(const SSAPtr &val) {
+  switch (val->kind()) {
+    case SSAKind::Alloca: case SSAKind::Load: case SSAKind::Store:
+    case SSAKind::Access: case SSAKind::Binary: case SSAKind::Unary:
+    case SSAKind::Cast: case SSAKind::Call: case SSAKind::Branch:
+    case SSAKind::Jump: case SSAKind::Return: case SSAKind::Phi:
+    case SSAKind::Select:
+      return true;
+    default: return false;
+  }
+}
+
+// check if the specific value is a terminator of block
+bool IsTerminator(const SSAPtr &val) {
+  switch (val->kind()) {
+    case SSAKind::Branch: case SSAKind::Jump: case SSAKind::Return:
+      return true;
+    default: return false;
+  }
+}
+
+// append an unsigned integer to buffer
+void PutUInt(std::string &buf, std::uint64_t value) {
+  do {
+    std::uint8_t byte = value & 0x7f;
+    value >>= 7;
+    if (value) byte |= 0x80;
+    buf.push_back(static_cast<char>(byte));
+  } while (value);
+}
+
+// writer of binary IR
+class IRWriter {
+ public:
+  IRWriter() : type_count_(0) {}
+
+  // write global variables & functions to stream
+  void Write(std::ostream &os, std::string_view file,
+             const UserPtrList &vars, const UserPtrList &funcs);
+
+ private:
+  // get ids, new items will be added to tables
+  std::uint64_t GetStrId(std::string_view str);
+  std::uint64_t GetLoggerId(const LogPtr &logger);
+  std::uint64_t GetStructId(const StructType::BodyPtr &body);
+  std::uint64_t GetTypeId(const TypePtr &type);
+  std::uint64_t GetValueId(Value *val);
+  std::uint64_t GetValueId(const SSAPtr &val) {
+    return GetValueId(val.get());
+  }
+  // write the specific value to value buffer
+  void WriteValue(Value *val);
+
+  // strings
+  std::unordered_map<std::string_view, std::uint64_t> str_ids_;
+  std::vector<std::string_view> strs_;
+  // loggers
+  std::unordered_map<const Logger *, std::uint64_t> logger_ids_;
+  std::vector<const Logger *> loggers_;
+  // bodies of structures
+  std::unordered_map<const StructType::Body *, std::uint64_t> struct_ids_;
+  std::vector<StructType::BodyPtr> structs_;
+  // types
+  std::unordered_map<const BaseType *, std::uint64_t> type_ids_;
+  std::uint64_t type_count_;
+  std::string types_buf_;
+  // values
+  std::unordered_map<const Value *, std::uint64_t> value_ids_;
+  std::vector<Value *> values_;
+  std::string values_buf_;
+};
+
+// reader of binary IR
+class IRReader {
+ public:
+  IRReader(std::string_view data)
+      : cur_(data.data()), end_(data.data() + data.size()),
+        failed_(false) {}
+
+  // read global variables & functions
+  bool Read(ValueContext &ctx, UserPtrList &vars, UserPtrList &funcs,
+            std::string &file);
+
+ private:
+  // information of value for resolving references
+  struct ValueInfo {
+    SSAKind kind;
+    // function of argument reference or parent of block
+    std::uint64_t ref;
+    // index of argument reference
+    std::size_t index;
+    // range of operands in 'ids_'
+    std::size_t opr_pos, opr_count;
+    // range of arguments of function or instructions of block
+    std::size_t list_pos, list_count;
+    // type & logger of argument reference
+    TypePtr type;
+    LogPtr logger;
+  };
+
+  // read an unsigned integer
+  std::uint64_t GetUInt();
+  // read an id, must be less than 'limit'
+  std::size_t GetId(std::size_t limit);
+  // read an enumeration, must be no greater than 'last'
+  template <typename T>
+  T GetEnum(T last) {
+    auto value = GetUInt();
+    if (value > static_cast<std::uint64_t>(last)) failed_ = true;
+    return failed_ ? T() : static_cast<T>(value);
+  }
+  // read references of tables
+  std::string_view GetStr() { return strs_[GetId(strs_.size())]; }
+  TypePtr GetType();
+  // read a list of value ids
+  std::size_t GetIdList();
+
+  // read sections
+  void ReadStrings();
+  void ReadType();
+  void ReadValue(ValueContext &ctx);
+  // resolve references of values
+  void ResolveValues(ValueContext &ctx);
+  // resolve a value id, 'nullptr' if id is invalid
+  SSAPtr ResolveValue(std::uint64_t id);
+
+  // input buffer
+  const char *cur_, *end_;
+  bool failed_;
+  // tables
+  std::vector<std::string_view> strs_;
+  std::vector<LogPtr> loggers_;
+  std::vector<std::shared_ptr<StructType>> structs_;
+  std::vector<TypePtr> types_;
+  std::vector<SSAPtr> values_;
+  std::vector<ValueInfo> infos_;
+  std::vector<std::uint64_t> ids_;
+};
+
+}  // namespace
+
+
+std::uint64_t IRWriter::GetStrId(std::string_view str) {
+  auto ret = str_ids_.insert({str, strs_.size()});
+  if (ret.second) strs_.push_back(str);
+  return ret.first->second;
+}
+
+std::uint64_t IRWriter::GetLoggerId(const LogPtr &logger) {
+  if (!logger) return 0;
+  auto ret = logger_ids_.insert({logger.get(), loggers_.size() + 1});
+  if (ret.second) loggers_.push_back(logger.get());
+  return ret.first->second;
+}
+
+std::uint64_t IRWriter::GetStructId(const StructType::BodyPtr &body) {
+  auto ret = struct_ids_.insert({body.get(), structs_.size()});
+  if (ret.second) structs_.push_back(body);
+  return ret.first->second;
+}
+
+std::uint64_t IRWriter::GetTypeId(const TypePtr &type) {
+  if (!type) return 0;
+  auto it = type_ids_.find(type.get());
+  if (it != type_ids_.end()) return it->second;
+  // get ids of the referenced types first
+  std::string buf;
+  auto is_right = type->IsRightValue();
+  if (type->IsConst()) {
+    auto base = GetTypeId(type->GetDeconstedType());
+    PutUInt(buf, static_cast<std::uint64_t>(TypeTag::Const));
+    PutUInt(buf, base);
+  }
+  else if (type->IsStruct()) {
+    auto body = static_cast<const StructType *>(type.get())->body();
+    PutUInt(buf, static_cast<std::uint64_t>(TypeTag::Struct));
+    PutUInt(buf, is_right);
+    PutUInt(buf, GetStructId(body));
+  }
+  else if (type->IsFunction()) {
+    auto args = *type->GetArgsType();
+    auto ret = type->GetReturnType(args);
+    assert(ret);
+    std::vector<std::uint64_t> ids;
+    for (const auto &i : args) ids.push_back(GetTypeId(i));
+    auto ret_id = GetTypeId(ret);
+    PutUInt(buf, static_cast<std::uint64_t>(TypeTag::Func));
+    PutUInt(buf, is_right);
+    PutUInt(buf, ids.size());
+    for (const auto &i : ids) PutUInt(buf, i);
+    PutUInt(buf, ret_id);
+  }
+  else if (type->IsArray()) {
+    auto base = GetTypeId(type->GetDerefedType());
+    PutUInt(buf, static_cast<std::uint64_t>(TypeTag::Array));
+    PutUInt(buf, is_right);
+    PutUInt(buf, base);
+    PutUInt(buf, type->GetLength());
+  }
+  else if (type->IsPointer()) {
+    auto base = GetTypeId(type->GetDerefedType());
+    PutUInt(buf, static_cast<std::uint64_t>(TypeTag::Pointer));
+    PutUInt(buf, is_right);
+    PutUInt(buf, base);
+  }
+  else {
+    auto tag = TypeTag::Void;
+    if (type->IsInteger()) {
+      auto is_8 = type->GetSize() == 1;
+      if (type->IsUnsigned()) {
+        tag = is_8 ? TypeTag::UInt8 : TypeTag::UInt32;
+      }
+      else {
+        tag = is_8 ? TypeTag::Int8 : TypeTag::Int32;
+      }
+    }
+    PutUInt(buf, static_cast<std::uint64_t>(tag));
+    PutUInt(buf, is_right);
+  }
+  // add to type table
+  auto id = ++type_count_;
+  type_ids_.insert({type.get(), id});
+  types_buf_ += buf;
+  return id;
+}
+
+std::uint64_t IRWriter::GetValueId(Value *val) {
+  if (!val) return 0;
+  auto ret = value_ids_.insert({val, values_.size() + 1});
+  if (ret.second) values_.push_back(val);
+  return ret.first->second;
+}
+
+void IRWriter::WriteValue(Value *val) {
+  auto &buf = values_buf_;
+  PutUInt(buf, static_cast<std::uint64_t>(val->kind()));
+  PutUInt(buf, GetTypeId(val->type()));
+  PutUInt(buf, GetLoggerId(val->logger()));
+  // write fields
+  switch (val->kind()) {
+    case SSAKind::Access: {
+      auto acc_type = SSACast<AccessSSA>(val)->acc_type();
+      PutUInt(buf, static_cast<std::uint64_t>(acc_type));
+      break;
+    }
+    case SSAKind::Binary: {
+      auto op = SSACast<BinarySSA>(val)->op();
+      PutUInt(buf, static_cast<std::uint64_t>(op));
+      break;
+    }
+    case SSAKind::Unary: {
+      auto op = SSACast<UnarySSA>(val)->op();
+      PutUInt(buf, static_cast<std::uint64_t>(op));
+      break;
+    }
+    case SSAKind::Function: {
+      auto func = SSACast<FunctionSSA>(val);
+      PutUInt(buf, static_cast<std::uint64_t>(func->link()));
+      PutUInt(buf, GetStrId(func->name()));
+      PutUInt(buf, func->args().size());
+      for (const auto &i : func->args()) PutUInt(buf, GetValueId(i));
+      break;
+    }
+    case SSAKind::GlobalVar: {
+      auto var = SSACast<GlobalVarSSA>(val);
+      PutUInt(buf, static_cast<std::uint64_t>(var->link()));
+      PutUInt(buf, var->is_var());
+      PutUInt(buf, GetStrId(var->name()));
+      break;
+    }
+    case SSAKind::Block: {
+      auto block = SSACast<BlockSSA>(val);
+      PutUInt(buf, GetStrId(block->name()));
+      PutUInt(buf, GetValueId(block->parent()));
+      PutUInt(buf, block->insts().size());
+      for (const auto &i : block->insts()) PutUInt(buf, GetValueId(i));
+      break;
+    }
+    case SSAKind::ArgRef: {
+      auto arg_ref = SSACast<ArgRefSSA>(val);
+      PutUInt(buf, GetValueId(arg_ref->func()));
+      PutUInt(buf, arg_ref->index());
+      break;
+    }
+    case SSAKind::ConstInt: {
+      PutUInt(buf, SSACast<ConstIntSSA>(val)->value());
+      break;
+    }
+    case SSAKind::ConstStr: {
+      PutUInt(buf, GetStrId(SSACast<ConstStrSSA>(val)->str()));
+      break;
+    }
+    default:;
+  }
+  // write operands
+  if (IsUser(val->kind())) {
+    auto user = static_cast<User *>(val);
+    PutUInt(buf, user->size());
+    for (const auto &i : *user) PutUInt(buf, GetValueId(i.value()));
+  }
+}
+
+void IRWriter::Write(std::ostream &os, std::string_view file,
+                     const UserPtrList &vars, const UserPtrList &funcs) {
+  // collect all values that reachable from module
+  for (const auto &i : vars) GetValueId(i);
+  for (const auto &i : funcs) GetValueId(i);
+  for (std::size_t i = 0; i < values_.size(); ++i) WriteValue(values_[i]);
+  // collect types & strings of structures
+  for (std::size_t i = 0; i < structs_.size(); ++i) {
+    auto body = structs_[i];
+    GetStrId(body->id);
+    if (auto trivial = body->trivial.lock()) {
+      GetStructId(static_cast<const StructType *>(trivial.get())->body());
+    }
+    for (const auto &[name, type] : body->elems) {
+      GetStrId(name);
+      GetTypeId(type);
+    }
+  }
+  auto file_id = GetStrId(file);
+  // write header & tables
+  std::string buf(kMagic);
+  PutUInt(buf, kVersion);
+  PutUInt(buf, strs_.size());
+  for (const auto &i : strs_) {
+    PutUInt(buf, i.size());
+    buf += i;
+  }
+  PutUInt(buf, file_id);
+  PutUInt(buf, loggers_.size());
+  for (const auto &i : loggers_) {
+    PutUInt(buf, i->line_pos());
+    PutUInt(buf, i->col_pos());
+  }
+  PutUInt(buf, structs_.size());
+  for (const auto &i : structs_) {
+    PutUInt(buf, str_ids_[i->id]);
+    auto trivial = i->trivial.lock();
+    PutUInt(buf, trivial ? struct_ids_[static_cast<const StructType *>(
+                               trivial.get())->body().get()] + 1
+                         : 0);
+  }
+  PutUInt(buf, type_count_);
+  buf += types_buf_;
+  for (const auto &i : structs_) {
+    PutUInt(buf, i->elems.size());
+    for (const auto &[name, type] : i->elems) {
+      PutUInt(buf, str_ids_[name]);
+      PutUInt(buf, type_ids_[type.get()]);
+    }
+  }
+  os.write(buf.data(), buf.size());
+  // write values & module
+  buf.clear();
+  PutUInt(buf, values_.size());
+  os.write(buf.data(), buf.size());
+  os.write(values_buf_.data(), values_buf_.size());
+  buf.clear();
+  PutUInt(buf, vars.size());
+  for (const auto &i : vars) PutUInt(buf, value_ids_[i.get()]);
+  PutUInt(buf, funcs.size());
+  for (const auto &i : funcs) PutUInt(buf, value_ids_[i.get()]);
+  os.write(buf.data(), buf.size());
+}
+
+std::uint64_t IRReader::GetUInt() {
+  std::uint64_t value = 0;
+  for (int shift = 0; !failed_; shift += 7) {
+    if (cur_ == end_ || shift >= 64) {
+      failed_ = true;
+      break;
+    }
+    auto byte = static_cast<std::uint8_t>(*cur_++);
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return value;
+  }
+  return 0;
+}
+
+std::size_t IRReader::GetId(std::size_t limit) {
+  auto id = GetUInt();
+  if (id < limit) return id;
+  // returns a dummy id, which is valid if table is not empty
+  failed_ = true;
+  return 0;
+}
+
+TypePtr IRReader::GetType() {
+  auto id = GetId(types_.size() + 1);
+  return id ? types_[id - 1] : nullptr;
+}
+
+std::size_t IRReader::GetIdList() {
+  auto count = GetUInt();
+  for (std::uint64_t i = 0; i < count && !failed_; ++i) {
+    ids_.push_back(GetUInt());
+  }
+  return count;
+}
+
+void IRReader::ReadStrings() {
+  auto count = GetUInt();
+  for (std::uint64_t i = 0; i < count && !failed_; ++i) {
+    auto len = GetUInt();
+    if (len > static_cast<std::uint64_t>(end_ - cur_)) {
+      failed_ = true;
+      break;
+    }
+    strs_.push_back({cur_, len});
+    cur_ += len;
+  }
+  // at least the source file name should be in the table
+  if (strs_.empty()) failed_ = true;
+}
+
+void IRReader::ReadType() {
+  auto tag = GetEnum(TypeTag::Pointer);
+  auto is_right = tag != TypeTag::Const && GetUInt();
+  TypePtr type;
+  switch (tag) {
+    case TypeTag::Void: {
+      type = MakePrimType(PrimType::Type::Void, is_right);
+      break;
+    }
+    case TypeTag::Int8: {
+      type = MakePrimType(PrimType::Type::Int8, is_right);
+      break;
+    }
+    case TypeTag::Int32: {
+      type = MakePrimType(PrimType::Type::Int32, is_right);
+      break;
+    }
+    case TypeTag::UInt8: {
+      type = MakePrimType(PrimType::Type::UInt8, is_right);
+      break;
+    }
+    case TypeTag::UInt32: {
+      type = MakePrimType(PrimType::Type::UInt32, is_right);
+      break;
+    }
+    case TypeTag::Struct: {
+      auto id = GetId(structs_.size());
+      if (!failed_) type = structs_[id]->GetValueType(is_right);
+      break;
+    }
+    case TypeTag::Const: {
+      auto base = GetType();
+      if (base) type = MakeConst(base);
+      break;
+    }
+    case TypeTag::Func: {
+      TypePtrList args;
+      auto count = GetUInt();
+      for (std::uint64_t i = 0; i < count && !failed_; ++i) {
+        args.push_back(GetType());
+        if (!args.back()) failed_ = true;
+      }
+      auto ret = GetType();
+      if (ret && !failed_) type = MakeFunc(args, ret, is_right);
+      break;
+    }
+    case TypeTag::Array: {
+      auto base = GetType();
+      auto len = GetUInt();
+      if (base) type = MakeArray(base, len, is_right);
+      break;
+    }
+    case TypeTag::Pointer: {
+      auto base = GetType();
+      if (base) type = MakePointer(base, is_right);
+      break;
+    }
+  }
+  if (!type) failed_ = true;
+  types_.push_back(type);
+}
+
+void IRReader::ReadValue(ValueContext &ctx) {
+  ValueInfo info = {GetEnum(SSAKind::Undef), 0, 0, 0, 0, 0, 0};
+  auto type = GetType();
+  auto logger_id = GetId(loggers_.size() + 1);
+  if (!type && !IsUntyped(info.kind)) failed_ = true;
+  if (failed_) return;
+  // check types of allocations and functions
+  if (((info.kind == SSAKind::Alloca || info.kind == SSAKind::GlobalVar) &&
+       !type->IsPointer()) ||
+      (info.kind == SSAKind::Function && !type->IsFunction())) {
+    failed_ = true;
+  }
+  if (failed_) return;
+  // read fields and create value
+  SSAPtr val;
+  switch (info.kind) {
+    case SSAKind::Load: val = ctx.NewValue<LoadSSA>(nullptr); break;
+    case SSAKind::Store: {
+      val = ctx.NewValue<StoreSSA>(nullptr, nullptr);
+      break;
+    }
+    case SSAKind::Access: {
+      auto acc_type = GetEnum(AccessSSA::AccessType::Element);
+      val = ctx.NewValue<AccessSSA>(acc_type, nullptr, nullptr);
+      break;
+    }
+    case SSAKind::Binary: {
+      auto op = GetEnum(BinarySSA::Operator::AShr);
+      val = ctx.NewValue<BinarySSA>(op, nullptr, nullptr);
+      break;
+    }
+    case SSAKind::Unary: {
+      auto op = GetEnum(UnarySSA::Operator::Not);
+      val = ctx.NewValue<UnarySSA>(op, nullptr);
+      break;
+    }
+    case SSAKind::Cast: val = ctx.NewValue<CastSSA>(nullptr); break;
+    case SSAKind::Call: {
+      val = ctx.NewValue<CallSSA>(nullptr, SSAPtrList());
+      break;
+    }
+    case SSAKind::Branch: {
+      val = ctx.NewValue<BranchSSA>(nullptr, nullptr, nullptr);
+      break;
+    }
+    case SSAKind::Jump: val = ctx.NewValue<JumpSSA>(nullptr); break;
+    case SSAKind::Return: val = ctx.NewValue<ReturnSSA>(nullptr); break;
+    case SSAKind::Function: {
+      auto link = GetEnum(LinkageTypes::GlobalDtor);
+      auto name = GetStr();
+      info.list_pos = ids_.size();
+      info.list_count = GetIdList();
+      val = ctx.NewValue<FunctionSSA>(link, std::string(name));
+      break;
+    }
+    case SSAKind::GlobalVar: {
+      auto link = GetEnum(LinkageTypes::GlobalDtor);
+      bool is_var = GetUInt();
+      auto name = GetStr();
+      val = ctx.NewValue<GlobalVarSSA>(link, is_var, std::string(name),
+                                       nullptr);
+      break;
+    }
+    case SSAKind::Alloca: val = ctx.NewValue<AllocaSSA>(); break;
+    case SSAKind::Block: {
+      auto name = GetStr();
+      info.ref = GetUInt();
+      info.list_pos = ids_.size();
+      info.list_count = GetIdList();
+      val = ctx.NewValue<BlockSSA>(nullptr, std::string(name));
+      break;
+    }
+    case SSAKind::ArgRef: {
+      // argument references will be created after all functions created
+      info.ref = GetUInt();
+      info.index = GetUInt();
+      info.type = type;
+      if (logger_id) info.logger = loggers_[logger_id - 1];
+      break;
+    }
+    case SSAKind::ConstInt: {
+      auto value = GetUInt();
+      if (value > UINT32_MAX) failed_ = true;
+      val = ctx.NewValue<ConstIntSSA>(value & UINT32_MAX);
+      break;
+    }
+    case SSAKind::ConstStr: {
+      val = ctx.NewValue<ConstStrSSA>(std::string(GetStr()));
+      break;
+    }
+    case SSAKind::ConstStruct: {
+      val = ctx.NewValue<ConstStructSSA>(SSAPtrList());
+      break;
+    }
+    case SSAKind::ConstArray: {
+      val = ctx.NewValue<ConstArraySSA>(SSAPtrList());
+      break;
+    }
+    case SSAKind::ConstZero: val = ctx.NewValue<ConstZeroSSA>(); break;
+    case SSAKind::PhiOperand: {
+      val = ctx.NewValue<PhiOperandSSA>(nullptr, nullptr);
+      break;
+    }
+    case SSAKind::Phi: val = ctx.NewValue<PhiSSA>(SSAPtrList()); break;
+    case SSAKind::Select: {
+      val = ctx.NewValue<SelectSSA>(nullptr, nullptr, nullptr);
+      break;
+    }
+    case SSAKind::Undef: val = ctx.NewValue<UndefSSA>(); break;
+  }
+  // read operands
+  if (IsUser(info.kind)) {
+    info.opr_pos = ids_.size();
+    info.opr_count = GetIdList();
+    if (!IsValidOprCount(info.kind, info.opr_count)) failed_ = true;
+  }
+  if (val) {
+    val->set_type(type);
+    val->set_logger(logger_id ? loggers_[logger_id - 1] : nullptr);
+  }
+  values_.push_back(val);
+  infos_.push_back(info);
+}
+
+SSAPtr IRReader::ResolveValue(std::uint64_t id) {
+  if (!id) return nullptr;
+  if (id > values_.size() || !values_[id - 1]) {
+    failed_ = true;
+    return nullptr;
+  }
+  return values_[id - 1];
+}
+
+void IRReader::ResolveValues(ValueContext &ctx) {
+  // create argument references
+  for (std::size_t i = 0; i < values_.size() && !failed_; ++i) {
+    const auto &info = infos_[i];
+    if (info.kind != SSAKind::ArgRef) continue;
+    auto func = ResolveValue(info.ref);
+    if (!func || !IsSSA<FunctionSSA>(func)) {
+      failed_ = true;
+      break;
+    }
+    auto val = ctx.NewValue<ArgRefSSA>(func, info.index);
+    val->set_type(info.type);
+    val->set_logger(info.logger);
+    values_[i] = val;
+  }
+  // resolve operands & references
+  for (std::size_t i = 0; i < values_.size() && !failed_; ++i) {
+    const auto &info = infos_[i];
+    const auto &val = values_[i];
+    if (IsUser(info.kind)) {
+      auto user = static_cast<User *>(val.get());
+      user->Resize(info.opr_count);
+      for (std::size_t j = 0; j < info.opr_count && !failed_; ++j) {
+        auto opr = ResolveValue(ids_[info.opr_pos + j]);
+        if (!IsValidOpr(info.kind, j, opr)) failed_ = true;
+        (*user)[j].set_value(opr);
+      }
+    }
+    if (failed_) break;
+    if (info.kind == SSAKind::Function) {
+      auto func = SSACast<FunctionSSA>(val.get());
+      for (std::size_t j = 0; j < info.list_count && !failed_; ++j) {
+        auto arg = ResolveValue(ids_[info.list_pos + j]);
+        if (!arg || !IsSSA<ArgRefSSA>(arg)) failed_ = true;
+        func->set_arg(j, arg);
+      }
+    }
+    else if (info.kind == SSAKind::Block) {
+      auto block = SSACast<BlockSSA>(val.get());
+      auto parent = ResolveValue(info.ref);
+      if (parent && !IsSSA<FunctionSSA>(parent)) failed_ = true;
+      block->set_parent(std::static_pointer_cast<User>(parent));
+      for (std::size_t j = 0; j < info.list_count && !failed_; ++j) {
+        auto inst = ResolveValue(ids_[info.list_pos + j]);
+        if (!inst || !IsInstruction(inst) || inst->parent_block()) {
+          failed_ = true;
+          break;
+        }
+        block->AddInst(inst);
+      }
+      // block in function must be terminated
+      const auto &insts = block->insts();
+      if (parent && !failed_ &&
+          (insts.empty() || !IsTerminator(insts.back()))) {
+        failed_ = true;
+      }
+    }
+  }
+  // check if all blocks and edges of functions are in the same function
+  std::unordered_set<Value *> blocks;
+  for (std::size_t i = 0; i < values_.size() && !failed_; ++i) {
+    if (infos_[i].kind != SSAKind::Function) continue;
+    auto func = SSACast<FunctionSSA>(values_[i].get());
+    blocks.clear();
+    for (const auto &use : *func) {
+      const auto &block = use.value();
+      if (SSACast<BlockSSA>(block.get())->parent().get() != func ||
+          !blocks.insert(block.get()).second) {
+        failed_ = true;
+        break;
+      }
+    }
+    for (const auto &use : *func) {
+      if (failed_) break;
+      auto block = SSACast<BlockSSA>(use.value().get());
+      for (const auto &pred : *block) {
+        if (!blocks.count(pred.value().get())) failed_ = true;
+      }
+      auto term = static_cast<User *>(block->insts().back().get());
+      for (const auto &opr : *term) {
+        const auto &val = opr.value();
+        if (val && val->kind() == SSAKind::Block &&
+            !blocks.count(val.get())) {
+          failed_ = true;
+        }
+      }
+    }
+  }
+}
+
+bool IRReader::Read(ValueContext &ctx, UserPtrList &vars,
+                    UserPtrList &funcs, std::string &file) {
+  // check header
+  std::string_view data(cur_, end_ - cur_);
+  if (!Module::IsSerialized(data)) return false;
+  cur_ += kMagic.size();
+  if (GetUInt() != kVersion) return false;
+  // read strings & source file name
+  ReadStrings();
+  if (failed_) return false;
+  file = GetStr();
+  // read loggers & structures
+  auto count = GetUInt();
+  for (std::uint64_t i = 0; i < count && !failed_; ++i) {
+    auto line = GetUInt(), col = GetUInt();
+    loggers_.push_back(std::make_shared<Logger>(line, col));
+  }
+  count = GetUInt();
+  std::vector<std::size_t> trivials;
+  for (std::uint64_t i = 0; i < count && !failed_; ++i) {
+    structs_.push_back(MakeStruct({}, std::string(GetStr())));
+    trivials.push_back(GetUInt());
+  }
+  for (std::size_t i = 0; i < trivials.size() && !failed_; ++i) {
+    if (!trivials[i]) continue;
+    if (trivials[i] > structs_.size()) {
+      failed_ = true;
+      break;
+    }
+    structs_[i]->body()->trivial = structs_[trivials[i] - 1];
+  }
+  // read types & bodies of structures
+  count = GetUInt();
+  for (std::uint64_t i = 0; i < count && !failed_; ++i) ReadType();
+  for (const auto &i : structs_) {
+    if (failed_) break;
+    TypePairList elems;
+    auto count = GetUInt();
+    for (std::uint64_t j = 0; j < count && !failed_; ++j) {
+      auto name = GetStr();
+      auto type = GetType();
+      if (!type) failed_ = true;
+      elems.push_back({std::string(name), type});
+    }
+    if (!failed_) i->set_elems(std::move(elems));
+  }
+  if (failed_) return false;
+  // read values
+  count = GetUInt();
+  for (std::uint64_t i = 0; i < count && !failed_; ++i) ReadValue(ctx);
+  ResolveValues(ctx);
+  // read module
+  count = GetUInt();
+  for (std::uint64_t i = 0; i < count && !failed_; ++i) {
+    auto var = ResolveValue(GetUInt());
+    if (!var || !IsSSA<GlobalVarSSA>(var)) failed_ = true;
+    vars.push_back(std::static_pointer_cast<User>(var));
+  }
+  count = GetUInt();
+  for (std::uint64_t i = 0; i < count && !failed_; ++i) {
+    auto func = ResolveValue(GetUInt());
+    if (!func || !IsSSA<FunctionSSA>(func)) failed_ = true;
+    funcs.push_back(std::static_pointer_cast<User>(func));
+  }
+  return !failed_ && cur_ == end_;
+}
+
+
+void Module::Serialize(std::ostream &os) {
+  SealGlobalCtor();
+  IRWriter writer;
+  writer.Write(os, Logger::file(), vars_, funcs_);
+}
+
+bool Module::Deserialize(std::string_view data, std::string &file) {
+  ClearContent();
+  // read binary IR
+  IRReader reader(data);
+  if (!reader.Read(*value_ctx_, vars_, funcs_, file)) {
+    vars_.clear();
+    funcs_.clear();
+    return false;
+  }
+  return true;
+}
+
+bool Module::IsSerialized(std::string_view data) {
+  return data.substr(0, kMagic.size()) == kMagic;
+}
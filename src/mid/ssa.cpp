@@ -379,7 +379,8 @@ void UndefSSA::Dump(std::ostream &os, IdManager &idm) const {
 namespace {
 
 // used in 'PhiOperandSSA::IsUndef' to prevent infinite loop
-std::unordered_set<const Value *> visited_vals;
+// thread local since passes may run on functions concurrently
+thread_local std::unordered_set<const Value *> visited_vals;
 
 }  // namespace
 
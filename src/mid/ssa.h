@@ -36,7 +36,7 @@ enum class LinkageTypes {
 // operands: pointer
 class LoadSSA : public User {
  public:
-  LoadSSA(const SSAPtr &ptr) : addr_(ptr) {
+  LoadSSA(const SSAPtr &ptr) : User(SSAKind::Load), addr_(ptr) {
     Reserve(1);
     AddValue(ptr);
   }
@@ -60,7 +60,7 @@ class LoadSSA : public User {
 // operands: value, pointer
 class StoreSSA : public User {
  public:
-  StoreSSA(const SSAPtr &value, const SSAPtr &ptr) {
+  StoreSSA(const SSAPtr &value, const SSAPtr &ptr) : User(SSAKind::Store) {
     Reserve(2);
     AddValue(value);
     AddValue(ptr);
@@ -85,7 +85,7 @@ class AccessSSA : public User {
   enum class AccessType { Pointer, Element };
 
   AccessSSA(AccessType acc_type, const SSAPtr &ptr, const SSAPtr &index)
-      : acc_type_(acc_type) {
+      : User(SSAKind::Access), acc_type_(acc_type) {
     Reserve(2);
     AddValue(ptr);
     AddValue(index);
@@ -121,7 +121,8 @@ class BinarySSA : public User {
     And, Or, Xor, Shl, LShr, AShr,
   };
 
-  BinarySSA(Operator op, const SSAPtr &lhs, const SSAPtr &rhs) : op_(op) {
+  BinarySSA(Operator op, const SSAPtr &lhs, const SSAPtr &rhs)
+      : User(SSAKind::Binary), op_(op) {
     Reserve(2);
     AddValue(lhs);
     AddValue(rhs);
@@ -164,7 +165,7 @@ class UnarySSA : public User {
     Neg, LogicNot, Not,
   };
 
-  UnarySSA(Operator op, const SSAPtr &opr) : op_(op) {
+  UnarySSA(Operator op, const SSAPtr &opr) : User(SSAKind::Unary), op_(op) {
     Reserve(1);
     AddValue(opr);
   }
@@ -190,7 +191,7 @@ class UnarySSA : public User {
 // operands: opr
 class CastSSA : public User {
  public:
-  CastSSA(const SSAPtr &opr) {
+  CastSSA(const SSAPtr &opr) : User(SSAKind::Cast) {
     Reserve(1);
     AddValue(opr);
   }
@@ -210,7 +211,8 @@ class CastSSA : public User {
 // operands: callee, arg1, arg2, ...
 class CallSSA : public User {
  public:
-  CallSSA(const SSAPtr &callee, const SSAPtrList &args) {
+  CallSSA(const SSAPtr &callee, const SSAPtrList &args)
+      : User(SSAKind::Call) {
     Reserve(args.size() + 1);
     AddValue(callee);
     for (const auto &i : args) AddValue(i);
@@ -232,7 +234,8 @@ class CallSSA : public User {
 class BranchSSA : public User {
  public:
   BranchSSA(const SSAPtr &cond, const SSAPtr &true_block,
-            const SSAPtr &false_block) {
+            const SSAPtr &false_block)
+      : User(SSAKind::Branch) {
     Reserve(3);
     AddValue(cond);
     AddValue(true_block);
@@ -256,7 +259,7 @@ class BranchSSA : public User {
 // operands: target
 class JumpSSA : public User {
  public:
-  JumpSSA(const SSAPtr &target) {
+  JumpSSA(const SSAPtr &target) : User(SSAKind::Jump) {
     Reserve(1);
     AddValue(target);
   }
@@ -277,7 +280,7 @@ class JumpSSA : public User {
 // NOTE: value can be 'nullptr'
 class ReturnSSA : public User {
  public:
-  ReturnSSA(const SSAPtr &value) {
+  ReturnSSA(const SSAPtr &value) : User(SSAKind::Return) {
     Reserve(1);
     AddValue(value);
   }
@@ -298,7 +301,7 @@ class ReturnSSA : public User {
 class FunctionSSA : public User {
  public:
   FunctionSSA(LinkageTypes link, const std::string &name)
-      : link_(link), name_(name) {}
+      : User(SSAKind::Function), link_(link), name_(name) {}
 
   void Dump(std::ostream &os, IdManager &idm) const override;
   bool IsConst() const override { return false; }
@@ -307,6 +310,12 @@ class FunctionSSA : public User {
   void RunPass(opt::PassBase &pass) override;
   void GenerateCode(back::CodeGen &gen) override;
 
+  // drop all references, including argument references
+  void DropAllReferences() override {
+    User::DropAllReferences();
+    args_.clear();
+  }
+
   // getter/setter
   DECL_GETTER_SETTER(entry, 0);
 
@@ -335,7 +344,8 @@ class GlobalVarSSA : public User {
  public:
   GlobalVarSSA(LinkageTypes link, bool is_var, const std::string &name,
                const SSAPtr &init)
-      : link_(link), is_var_(is_var), name_(name) {
+      : User(SSAKind::GlobalVar), link_(link), is_var_(is_var),
+        name_(name) {
     Reserve(1);
     AddValue(init);
   }
@@ -368,7 +378,7 @@ class GlobalVarSSA : public User {
 // memory allocation
 class AllocaSSA : public Value {
  public:
-  AllocaSSA() {}
+  AllocaSSA() : Value(SSAKind::Alloca) {}
 
   void Dump(std::ostream &os, IdManager &idm) const override;
   bool IsConst() const override { return false; }
@@ -383,7 +393,7 @@ class AllocaSSA : public Value {
 class BlockSSA : public User {
  public:
   BlockSSA(const UserPtr &parent, const std::string &name)
-      : name_(name), parent_(parent) {}
+      : User(SSAKind::Block), name_(name), parent_(parent), insts_(this) {}
 
   void Dump(std::ostream &os, IdManager &idm) const override;
   bool IsConst() const override { return false; }
@@ -396,6 +406,12 @@ class BlockSSA : public User {
   void AddInst(const SSAPtr &inst) { insts_.push_back(inst); }
   // clear all instructions
   void ClearInst();
+  // drop all references, including instructions and parent function
+  void DropAllReferences() override {
+    User::DropAllReferences();
+    insts_.clear();
+    parent_.reset();
+  }
 
   // setters
   void set_parent(const UserPtr &parent) { parent_ = parent; }
@@ -403,7 +419,7 @@ class BlockSSA : public User {
   // getters
   const std::string &name() const { return name_; }
   const UserPtr &parent() const { return parent_; }
-  SSAPtrList &insts() { return insts_; }
+  InstList &insts() { return insts_; }
 
  private:
   // block name
@@ -411,14 +427,14 @@ class BlockSSA : public User {
   // parent function
   UserPtr parent_;
   // instructions in current block
-  SSAPtrList insts_;
+  InstList insts_;
 };
 
 // argument reference
 class ArgRefSSA : public Value {
  public:
   ArgRefSSA(const SSAPtr &func, std::size_t index)
-      : func_(func), index_(index) {}
+      : Value(SSAKind::ArgRef), func_(func), index_(index) {}
 
   void Dump(std::ostream &os, IdManager &idm) const override;
   bool IsConst() const override { return false; }
@@ -426,6 +442,7 @@ class ArgRefSSA : public Value {
 
   void RunPass(opt::PassBase &pass) override;
   void GenerateCode(back::CodeGen &gen) override;
+  void DropAllReferences() override { func_.reset(); }
 
   // getters
   const SSAPtr &func() const { return func_; }
@@ -439,7 +456,8 @@ class ArgRefSSA : public Value {
 // constant integer
 class ConstIntSSA : public Value {
  public:
-  ConstIntSSA(std::uint32_t value) : value_(value) {}
+  ConstIntSSA(std::uint32_t value)
+      : Value(SSAKind::ConstInt), value_(value) {}
 
   void Dump(std::ostream &os, IdManager &idm) const override;
   bool IsConst() const override { return true; }
@@ -458,7 +476,8 @@ class ConstIntSSA : public Value {
 // constant string
 class ConstStrSSA : public Value {
  public:
-  ConstStrSSA(const std::string &str) : str_(str) {}
+  ConstStrSSA(const std::string &str)
+      : Value(SSAKind::ConstStr), str_(str) {}
 
   void Dump(std::ostream &os, IdManager &idm) const override;
   bool IsConst() const override { return true; }
@@ -478,7 +497,7 @@ class ConstStrSSA : public Value {
 // operands: elem1, elem2, ...
 class ConstStructSSA : public User {
  public:
-  ConstStructSSA(const SSAPtrList &elems) {
+  ConstStructSSA(const SSAPtrList &elems) : User(SSAKind::ConstStruct) {
     Reserve(elems.size());
     for (const auto &i : elems) AddValue(i);
   }
@@ -495,7 +514,7 @@ class ConstStructSSA : public User {
 // operands: elem1, elem2, ...
 class ConstArraySSA : public User {
  public:
-  ConstArraySSA(const SSAPtrList &elems) {
+  ConstArraySSA(const SSAPtrList &elems) : User(SSAKind::ConstArray) {
     Reserve(elems.size());
     for (const auto &i : elems) AddValue(i);
   }
@@ -511,7 +530,7 @@ class ConstArraySSA : public User {
 // constant zero
 class ConstZeroSSA : public Value {
  public:
-  ConstZeroSSA() {}
+  ConstZeroSSA() : Value(SSAKind::ConstZero) {}
 
   void Dump(std::ostream &os, IdManager &idm) const override;
   bool IsConst() const override { return true; }
@@ -525,7 +544,8 @@ class ConstZeroSSA : public Value {
 // operands: value, block (which value comes from)
 class PhiOperandSSA : public User {
  public:
-  PhiOperandSSA(const SSAPtr &val, const SSAPtr &block) {
+  PhiOperandSSA(const SSAPtr &val, const SSAPtr &block)
+      : User(SSAKind::PhiOperand) {
     Reserve(2);
     AddValue(val);
     AddValue(block);
@@ -548,7 +568,7 @@ class PhiOperandSSA : public User {
 // operands: phiopr1, phiopr2, ...
 class PhiSSA : public User {
  public:
-  PhiSSA(const SSAPtrList &oprs) {
+  PhiSSA(const SSAPtrList &oprs) : User(SSAKind::Phi) {
     Reserve(oprs.size());
     for (const auto &i : oprs) { AddValue(i); }
   }
@@ -571,7 +591,8 @@ class PhiSSA : public User {
 class SelectSSA : public User {
  public:
   SelectSSA(const SSAPtr &cond, const SSAPtr &true_val,
-            const SSAPtr &false_val) {
+            const SSAPtr &false_val)
+      : User(SSAKind::Select) {
     Reserve(3);
     AddValue(cond);
     AddValue(true_val);
@@ -597,7 +618,7 @@ class SelectSSA : public User {
 // undefined value
 class UndefSSA : public Value {
  public:
-  UndefSSA() {}
+  UndefSSA() : Value(SSAKind::Undef) {}
 
   void Dump(std::ostream &os, IdManager &idm) const override;
   bool IsConst() const override { return false; }
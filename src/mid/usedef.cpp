@@ -5,6 +5,9 @@
 
 using namespace mimic::mid;
 
+// definition of static member variables in value
+std::mutex Value::shared_use_mutexes_[kSharedUseMutexCount];
+
 void IdManager::ResetId() {
   cur_id_ = 0;
   ids_.clear();
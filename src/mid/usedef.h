@@ -7,11 +7,15 @@
 #include <vector>
 #include <ostream>
 #include <list>
-#include <any>
 #include <unordered_map>
 #include <string_view>
 #include <optional>
+#include <iterator>
+#include <mutex>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cassert>
 
 #include "front/logger.h"
 #include "define/type.h"
@@ -35,6 +39,8 @@ namespace mimic::mid {
 class Value;
 class User;
 class Use;
+class InstList;
+class BlockSSA;
 
 using SSAPtr = std::shared_ptr<Value>;
 using SSAPtrList = std::list<SSAPtr>;
@@ -42,6 +48,13 @@ using SSARef = std::weak_ptr<Value>;
 using UserPtr = std::shared_ptr<User>;
 using UserPtrList = std::list<UserPtr>;
 
+// kind of SSA values, used for runtime type checking
+enum class SSAKind : std::uint8_t {
+  Load, Store, Access, Binary, Unary, Cast, Call, Branch, Jump, Return,
+  Function, GlobalVar, Alloca, Block, ArgRef, ConstInt, ConstStr,
+  ConstStruct, ConstArray, ConstZero, PhiOperand, Phi, Select, Undef,
+};
+
 // utility class for dumping SSA IR
 class IdManager {
  public:
@@ -68,9 +81,74 @@ class IdManager {
   std::unordered_map<const Value *, std::string_view> names_;
 };
 
+// intrusive doubly linked list of 'Use'
+// all links are stored in 'Use', so add/remove takes O(1) time
+// and there is no extra node allocation
+class UseList {
+ public:
+  // iterator of use list
+  class Iter {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Use *;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Use *const *;
+    using reference = Use *const &;
+
+    Iter(Use *use) : use_(use) {}
+
+    // defined after the definition of 'Use'
+    Iter &operator++();
+    Iter operator++(int) {
+      auto it = *this;
+      ++*this;
+      return it;
+    }
+
+    bool operator==(const Iter &other) const { return use_ == other.use_; }
+    bool operator!=(const Iter &other) const { return use_ != other.use_; }
+    Use *const &operator*() const { return use_; }
+
+   private:
+    Use *use_;
+  };
+
+  UseList() : head_(nullptr), tail_(nullptr), size_(0) {}
+  // copying the list header would break links, make a snapshot instead
+  UseList(const UseList &) = delete;
+  UseList &operator=(const UseList &) = delete;
+
+  // append a use to the end of list
+  void PushBack(Use *use);
+  // remove the specific use from list
+  void Remove(Use *use);
+  // replace the specific use with another use in place
+  void Replace(Use *from, Use *to);
+
+  // iterator methods
+  Iter begin() const { return Iter(head_); }
+  Iter end() const { return Iter(nullptr); }
+
+  // getters
+  // count of uses in list
+  std::size_t size() const { return size_; }
+  // return true if list is empty
+  bool empty() const { return !size_; }
+  // get the first use
+  Use *front() const {
+    assert(head_);
+    return head_;
+  }
+
+ private:
+  Use *head_, *tail_;
+  std::size_t size_;
+};
+
 // SSA value
 class Value {
  public:
+  explicit Value(SSAKind kind) : kind_(kind) {}
   virtual ~Value() = default;
 
   // dump the content of SSA value to output stream
@@ -86,11 +164,25 @@ class Value {
   virtual void RunPass(opt::PassBase &pass) = 0;
   // run code generation
   virtual void GenerateCode(back::CodeGen &pass) = 0;
+  // drop all references to other values held by current value,
+  // so that values in reference cycles can be destructed
+  virtual void DropAllReferences() {}
 
   // add a use reference to current value
-  void AddUse(Use *use) { uses_.push_back(use); }
+  void AddUse(Use *use) {
+    auto lock = LockUses();
+    uses_.PushBack(use);
+  }
   // remove use reference from current value
-  void RemoveUse(Use *use) { uses_.remove(use); }
+  void RemoveUse(Use *use) {
+    auto lock = LockUses();
+    uses_.Remove(use);
+  }
+  // replace a use reference of current value with another one
+  void ReplaceUse(Use *from, Use *to) {
+    auto lock = LockUses();
+    uses_.Replace(from, to);
+  }
   // replace current value by another value
   void ReplaceBy(const SSAPtr &value);
   // remove current value from all users
@@ -103,43 +195,100 @@ class Value {
   void set_type(const define::TypePtr &type) {
     type_ = type ? type->GetTrivialType() : nullptr;
   }
-  void set_metadata(const std::any &metadata) { metadata_ = metadata; }
+  void set_context(std::size_t context_id,
+                   std::atomic<std::size_t> *id_counter) {
+    context_id_ = context_id;
+    id_counter_ = id_counter;
+  }
 
   // getters
   const front::LogPtr &logger() const { return logger_; }
   const define::TypePtr &type() const { return type_; }
-  const std::any &metadata() const { return metadata_; }
-  const std::list<Use *> &uses() const { return uses_; }
+  // id is assigned when it is queried for the first time, so that ids
+  // only depend on the order of queries, not the order of creation
+  // NOTE: must not be queried concurrently
+  std::size_t id() const {
+    if (!id_) {
+      assert(id_counter_);
+      id_ = id_counter_->fetch_add(1, std::memory_order_relaxed);
+    }
+    return id_;
+  }
+  std::size_t context_id() const { return context_id_; }
+  SSAKind kind() const { return kind_; }
+  // return true if current value can be used by multiple functions
+  bool is_shared() const {
+    switch (kind_) {
+      case SSAKind::Function: case SSAKind::GlobalVar:
+      case SSAKind::ConstInt: case SSAKind::ConstStr:
+      case SSAKind::ConstStruct: case SSAKind::ConstArray:
+      case SSAKind::ConstZero: case SSAKind::Undef: return true;
+      // constant casts that are not in any block (e.g. initializers)
+      case SSAKind::Cast: return !inst_list_;
+      default: return false;
+    }
+  }
+  const UseList &uses() const { return uses_; }
+  // block which current value belongs to, 'nullptr' if not in block
+  inline BlockSSA *parent_block() const;
 
  private:
+  friend class InstList;
+
+  // lock use list if current value is shared
+  // since function passes may update it concurrently
+  std::unique_lock<std::mutex> LockUses() const {
+    if (!is_shared()) return {};
+    auto addr = reinterpret_cast<std::uintptr_t>(this);
+    auto &mutex = shared_use_mutexes_[(addr >> 4) % kSharedUseMutexCount];
+    return std::unique_lock<std::mutex>(mutex);
+  }
+
+  // count of mutexes of shared values
+  static constexpr std::size_t kSharedUseMutexCount = 64;
+  // mutexes of use lists of all shared values, selected by address
+  static std::mutex shared_use_mutexes_[kSharedUseMutexCount];
+
   // pointer to logger
   front::LogPtr logger_;
   // trivial/orginal type of current value
   define::TypePtr type_;
-  // metadata
-  std::any metadata_;
+  // serial number of value context which current value belongs to
+  std::size_t context_id_ = 0;
+  // id counter of value context
+  std::atomic<std::size_t> *id_counter_ = nullptr;
+  // dense id in value context, used as index of side tables
+  // zero if not assigned
+  mutable std::size_t id_ = 0;
+  // kind of current value
+  SSAKind kind_;
   // linked list of 'Use'
-  std::list<Use *> uses_;
+  UseList uses_;
+  // links of instruction list
+  InstList *inst_list_ = nullptr;
+  Value *inst_prev_ = nullptr, *inst_next_ = nullptr;
+  // reference to current value, held while current value is in list
+  SSAPtr inst_self_;
 };
 
 // bidirectional reference between SSA users and values
 class Use {
  public:
   explicit Use(const SSAPtr &value, User *user)
-      : value_(value), user_(user) {
+      : value_(value), user_(user), prev_(nullptr), next_(nullptr) {
     if (value_) value_->AddUse(this);
   }
   // copy constructor
-  Use(const Use &use) : value_(use.value_), user_(use.user_) {
+  Use(const Use &use)
+      : value_(use.value_), user_(use.user_),
+        prev_(nullptr), next_(nullptr) {
     if (value_) value_->AddUse(this);
   }
   // move constructor
   Use(Use &&use) noexcept
-      : value_(std::move(use.value_)), user_(use.user_) {
-    if (value_) {
-      value_->RemoveUse(&use);
-      value_->AddUse(this);
-    }
+      : value_(std::move(use.value_)), user_(use.user_),
+        prev_(nullptr), next_(nullptr) {
+    if (value_) value_->ReplaceUse(&use, this);
   }
   // destructor
   ~Use() {
@@ -159,9 +308,10 @@ class Use {
   // move assignment operator
   Use &operator=(Use &&use) noexcept {
     if (this != &use) {
-      // update reference
-      if (use.value_) use.value_->RemoveUse(&use);
-      set_value(std::move(use.value_));
+      // update reference, take the place of 'use' in the use list
+      if (value_) value_->RemoveUse(this);
+      value_ = std::move(use.value_);
+      if (value_) value_->ReplaceUse(&use, this);
       user_ = use.user_;
     }
     return *this;
@@ -181,13 +331,309 @@ class Use {
   User *user() const { return user_; }
 
  private:
+  friend class UseList;
+
   SSAPtr value_;
   User *user_;
+  // links of use list
+  Use *prev_, *next_;
 };
 
+inline UseList::Iter &UseList::Iter::operator++() {
+  use_ = use_->next_;
+  return *this;
+}
+
+inline void UseList::PushBack(Use *use) {
+  use->prev_ = tail_;
+  use->next_ = nullptr;
+  if (tail_) {
+    tail_->next_ = use;
+  }
+  else {
+    head_ = use;
+  }
+  tail_ = use;
+  ++size_;
+}
+
+inline void UseList::Remove(Use *use) {
+  assert(size_);
+  if (use->prev_) {
+    use->prev_->next_ = use->next_;
+  }
+  else {
+    assert(head_ == use);
+    head_ = use->next_;
+  }
+  if (use->next_) {
+    use->next_->prev_ = use->prev_;
+  }
+  else {
+    assert(tail_ == use);
+    tail_ = use->prev_;
+  }
+  use->prev_ = use->next_ = nullptr;
+  --size_;
+}
+
+inline void UseList::Replace(Use *from, Use *to) {
+  to->prev_ = from->prev_;
+  to->next_ = from->next_;
+  if (to->prev_) {
+    to->prev_->next_ = to;
+  }
+  else {
+    head_ = to;
+  }
+  if (to->next_) {
+    to->next_->prev_ = to;
+  }
+  else {
+    tail_ = to;
+  }
+  from->prev_ = from->next_ = nullptr;
+}
+
+// intrusive doubly linked list of instructions
+// all links are stored in 'Value', so insertion/removal takes O(1) time,
+// and iterators stay valid until the element is removed
+// interfaces are compatible with 'std::list<SSAPtr>'
+// NOTE: a value can only be in one list, inserting a value which is
+//       already in a list will move it from that list
+class InstList {
+ public:
+  // iterator of instruction list
+  class Iter {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = SSAPtr;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const SSAPtr *;
+    using reference = const SSAPtr &;
+
+    Iter() : list_(nullptr), inst_(nullptr) {}
+    Iter(const InstList *list, Value *inst) : list_(list), inst_(inst) {}
+
+    Iter &operator++() {
+      inst_ = inst_->inst_next_;
+      return *this;
+    }
+    Iter operator++(int) {
+      auto it = *this;
+      ++*this;
+      return it;
+    }
+    Iter &operator--() {
+      inst_ = inst_ ? inst_->inst_prev_ : list_->tail_;
+      return *this;
+    }
+    Iter operator--(int) {
+      auto it = *this;
+      --*this;
+      return it;
+    }
+
+    bool operator==(const Iter &other) const {
+      return inst_ == other.inst_;
+    }
+    bool operator!=(const Iter &other) const {
+      return inst_ != other.inst_;
+    }
+    const SSAPtr &operator*() const { return inst_->inst_self_; }
+    const SSAPtr *operator->() const { return &inst_->inst_self_; }
+
+   private:
+    friend class InstList;
+
+    const InstList *list_;
+    Value *inst_;
+  };
+
+  using iterator = Iter;
+  using const_iterator = Iter;
+  using value_type = SSAPtr;
+
+  InstList(BlockSSA *parent)
+      : parent_(parent), head_(nullptr), tail_(nullptr), size_(0) {}
+  // links are stored in values, so list can not be copied
+  InstList(const InstList &) = delete;
+  InstList &operator=(const InstList &) = delete;
+  ~InstList() { clear(); }
+
+  // insert a value before 'pos', return iterator of the inserted value
+  Iter insert(Iter pos, const SSAPtr &inst);
+  // insert values in range ['first', 'last') before 'pos'
+  template <typename It>
+  Iter insert(Iter pos, It first, It last) {
+    auto ret = pos;
+    bool is_first = true;
+    while (first != last) {
+      // hold the value, since it may be moved from another list
+      SSAPtr inst = *first++;
+      auto it = insert(pos, inst);
+      if (is_first) {
+        ret = it;
+        is_first = false;
+      }
+    }
+    return ret;
+  }
+  // move values in range ['first', 'last') of 'other' before 'pos'
+  void splice(Iter pos, InstList &other, Iter first, Iter last);
+  // remove value at 'pos', return iterator of the next value
+  Iter erase(Iter pos);
+  // remove values in range ['first', 'last')
+  Iter erase(Iter first, Iter last) {
+    while (first != last) first = erase(first);
+    return last;
+  }
+  // remove the specific value if it's in current list
+  void remove(const Value *inst) {
+    if (inst && inst->inst_list_ == this) Unlink(const_cast<Value *>(inst));
+  }
+  void remove(const SSAPtr &inst) { remove(inst.get()); }
+  // remove all values that satisfy the predicate
+  template <typename Pred>
+  void remove_if(Pred pred) {
+    for (auto it = begin(); it != end();) {
+      it = pred(*it) ? erase(it) : std::next(it);
+    }
+  }
+  // replace value at 'pos' with 'inst', return iterator of 'inst'
+  // 'inst' must not be linked into any list
+  Iter replace(Iter pos, const SSAPtr &inst) {
+    if (pos.inst_ == inst.get()) return pos;
+    assert(inst && !inst->inst_list_);
+    auto it = insert(pos, inst);
+    erase(pos);
+    return it;
+  }
+  // get iterator of the specific value, 'end()' if not in current list
+  Iter find(const Value *inst) const {
+    return Iter(this, inst && inst->inst_list_ == this
+                          ? const_cast<Value *>(inst) : nullptr);
+  }
+  Iter find(const SSAPtr &inst) const { return find(inst.get()); }
+  // remove all values
+  void clear() {
+    while (head_) Unlink(head_);
+  }
+
+  // push/pop methods
+  void push_back(const SSAPtr &inst) { insert(end(), inst); }
+  void push_front(const SSAPtr &inst) { insert(begin(), inst); }
+  void pop_back() { Unlink(tail_); }
+  void pop_front() { Unlink(head_); }
+
+  // iterator methods
+  Iter begin() const { return Iter(this, head_); }
+  Iter end() const { return Iter(this, nullptr); }
+
+  // getters
+  // block which current list belongs to
+  BlockSSA *parent() const { return parent_; }
+  // count of values in list
+  std::size_t size() const { return size_; }
+  // return true if list is empty
+  bool empty() const { return !size_; }
+  // get the first value
+  const SSAPtr &front() const {
+    assert(head_);
+    return head_->inst_self_;
+  }
+  // get the last value
+  const SSAPtr &back() const {
+    assert(tail_);
+    return tail_->inst_self_;
+  }
+
+ private:
+  // link the specific value before 'pos'
+  void Link(Value *pos, Value *inst);
+  // unlink the specific value, return the reference held by list
+  // NOTE: value may be destructed after the returned pointer released
+  SSAPtr Unlink(Value *inst);
+
+  BlockSSA *parent_;
+  Value *head_, *tail_;
+  std::size_t size_;
+};
+
+inline BlockSSA *Value::parent_block() const {
+  return inst_list_ ? inst_list_->parent() : nullptr;
+}
+
+inline void InstList::Link(Value *pos, Value *inst) {
+  inst->inst_list_ = this;
+  inst->inst_next_ = pos;
+  inst->inst_prev_ = pos ? pos->inst_prev_ : tail_;
+  if (inst->inst_prev_) {
+    inst->inst_prev_->inst_next_ = inst;
+  }
+  else {
+    head_ = inst;
+  }
+  if (pos) {
+    pos->inst_prev_ = inst;
+  }
+  else {
+    tail_ = inst;
+  }
+  ++size_;
+}
+
+inline SSAPtr InstList::Unlink(Value *inst) {
+  assert(inst && inst->inst_list_ == this && size_);
+  if (inst->inst_prev_) {
+    inst->inst_prev_->inst_next_ = inst->inst_next_;
+  }
+  else {
+    head_ = inst->inst_next_;
+  }
+  if (inst->inst_next_) {
+    inst->inst_next_->inst_prev_ = inst->inst_prev_;
+  }
+  else {
+    tail_ = inst->inst_prev_;
+  }
+  inst->inst_list_ = nullptr;
+  inst->inst_prev_ = inst->inst_next_ = nullptr;
+  --size_;
+  return std::move(inst->inst_self_);
+}
+
+inline InstList::Iter InstList::insert(Iter pos, const SSAPtr &inst) {
+  assert(inst && (!pos.list_ || pos.list_ == this));
+  auto val = inst.get();
+  if (val == pos.inst_) return pos;
+  // move from another list if necessary
+  val->inst_self_ = val->inst_list_ ? val->inst_list_->Unlink(val) : inst;
+  Link(pos.inst_, val);
+  return Iter(this, val);
+}
+
+inline void InstList::splice(Iter pos, InstList &other, Iter first,
+                             Iter last) {
+  while (first != last) {
+    auto val = first.inst_;
+    ++first;
+    val->inst_self_ = other.Unlink(val);
+    Link(pos.inst_, val);
+  }
+}
+
+inline InstList::Iter InstList::erase(Iter pos) {
+  auto next = pos.inst_->inst_next_;
+  Unlink(pos.inst_);
+  return Iter(this, next);
+}
+
 // SSA user which can use other values
 class User : public Value {
  public:
+  explicit User(SSAKind kind) : Value(kind) {}
+
   // preallocate some space for values
   void Reserve(std::size_t size) { uses_.reserve(size); }
   // resize use list
@@ -198,6 +644,8 @@ class User : public Value {
   void RemoveValue(Value *value);
   // clear all uses
   void Clear() { uses_.clear(); }
+  // drop all references, clear all uses
+  void DropAllReferences() override { Clear(); }
   // add new value to current user
   void AddValue(const SSAPtr &value) {
     uses_.push_back(Use(value, this));
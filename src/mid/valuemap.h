@@ -0,0 +1,74 @@
+#ifndef MIMIC_MID_VALUEMAP_H_
+#define MIMIC_MID_VALUEMAP_H_
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+#include "mid/usedef.h"
+
+namespace mimic::mid {
+
+// side table that stores data of type 'T' for SSA values
+// indexed by value id, so lookup is just an array access
+// data are stored in fixed-size chunks, references of stored data
+// will not be invalidated by further insertions
+// NOTE: ids are only unique in a value context, so a map is bound to
+//       the context of the first value stored in it, and all values
+//       must be created in that context until the map is cleared
+template <typename T>
+class ValueMap {
+ public:
+  ValueMap() : context_id_(0) {}
+
+  // get data of the specific value, returns 'nullptr' if not found
+  T *Find(const Value &val) const {
+    assert(!context_id_ || val.context_id() == context_id_);
+    auto id = val.id(), index = id / kChunkSize;
+    if (index >= chunks_.size()) return nullptr;
+    auto &data = chunks_[index][id % kChunkSize];
+    return data ? &*data : nullptr;
+  }
+  // return true if data of the specific value exists
+  bool Has(const Value &val) const { return Find(val); }
+  // set data of the specific value, returns reference of stored data
+  T &Set(const Value &val, T data) {
+    if (!context_id_) context_id_ = val.context_id();
+    assert(val.context_id() == context_id_);
+    auto id = val.id(), index = id / kChunkSize;
+    while (index >= chunks_.size()) {
+      chunks_.push_back(std::make_unique<Chunk>(kChunkSize));
+    }
+    auto &slot = chunks_[index][id % kChunkSize];
+    slot = std::move(data);
+    return *slot;
+  }
+  // set data of the specific value if not found
+  // returns reference of stored data
+  T &TrySet(const Value &val, T data) {
+    if (auto ptr = Find(val)) return *ptr;
+    return Set(val, std::move(data));
+  }
+  // remove all data
+  void Clear() {
+    chunks_.clear();
+    context_id_ = 0;
+  }
+
+ private:
+  using Chunk = std::optional<T>[];
+
+  // count of slots in a chunk
+  static constexpr std::size_t kChunkSize = 256;
+
+  // serial number of the value context that current map is bound to
+  std::size_t context_id_;
+  std::vector<std::unique_ptr<Chunk>> chunks_;
+};
+
+}  // namespace mimic::mid
+
+#endif  // MIMIC_MID_VALUEMAP_H_
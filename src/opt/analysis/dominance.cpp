@@ -1,18 +1,63 @@
 #include "opt/analysis/dominance.h"
 
+#include <utility>
+#include <limits>
+
 #include "opt/passman.h"
 #include "opt/helper/cast.h"
-#include "opt/helper/blkiter.h"
+#include "opt/helper/cfg.h"
 
 using namespace mimic::mid;
 using namespace mimic::opt;
-using namespace mimic::utils;
 
 // register current pass
 REGISTER_PASS(DominanceInfoPass, dom_info)
     .set_is_analysis(true);
 
 
+namespace {
+
+// undefined node id
+constexpr std::size_t kUndefNode = std::numeric_limits<std::size_t>::max();
+
+// get reverse post order of all nodes that reachable from root
+std::vector<std::size_t> GetRPO(
+    const std::vector<std::vector<std::size_t>> &succs, std::size_t root) {
+  std::vector<std::size_t> po;
+  std::vector<char> visited(succs.size());
+  // stack of nodes and indices of the next successor to be visited
+  std::vector<std::pair<std::size_t, std::size_t>> nodes = {{root, 0}};
+  visited[root] = true;
+  while (!nodes.empty()) {
+    auto &[node, index] = nodes.back();
+    if (index < succs[node].size()) {
+      auto succ = succs[node][index++];
+      if (!visited[succ]) {
+        visited[succ] = true;
+        nodes.push_back({succ, 0});
+      }
+    }
+    else {
+      po.push_back(node);
+      nodes.pop_back();
+    }
+  }
+  return {po.rbegin(), po.rend()};
+}
+
+// get the nearest common dominator of two nodes
+std::size_t Intersect(const std::vector<std::size_t> &idom,
+                      std::size_t n1, std::size_t n2) {
+  while (n1 != n2) {
+    while (n1 > n2) n1 = idom[n1];
+    while (n2 > n1) n2 = idom[n2];
+  }
+  return n1;
+}
+
+}  // namespace
+
+
 const DominanceInfoPass::DominanceInfo &DominanceInfoPass::GetDominanceInfo(
     BlockSSA *block) const {
   auto parent = block->parent().get();
@@ -22,60 +67,189 @@ const DominanceInfoPass::DominanceInfo &DominanceInfoPass::GetDominanceInfo(
 }
 
 bool DominanceInfoPass::IsDeadBlock(BlockSSA *block) const {
-  return !GetDominanceInfo(block).block_id.count(block);
+  return !GetDominanceInfo(block).dom.block_id.count(block);
 }
 
 bool DominanceInfoPass::IsDominate(BlockSSA *b1, BlockSSA *b2) const {
   assert(b1->parent() == b2->parent());
-  const auto &info = GetDominanceInfo(b1);
-  auto dom_it = info.dom.find(b2);
-  auto id_it = info.block_id.find(b1);
-  assert(dom_it != info.dom.end() && id_it != info.block_id.end());
-  return dom_it->second.Get(id_it->second);
+  const auto &tree = GetDominanceInfo(b1).dom;
+  auto it1 = tree.block_id.find(b1), it2 = tree.block_id.find(b2);
+  assert(it1 != tree.block_id.end() && it2 != tree.block_id.end());
+  auto n1 = it1->second, n2 = it2->second;
+  return tree.dfs_in[n1] <= tree.dfs_in[n2] &&
+         tree.dfs_out[n2] <= tree.dfs_out[n1];
 }
 
-void DominanceInfoPass::SolveDominance(const FuncPtr &func) {
-  auto &info = dom_info_[func.get()];
-  auto entry = SSACast<BlockSSA>(func->entry().get());
-  auto rpo = RPOTraverse(entry);
-  // number all of the blocks in current function
-  std::size_t cur_id = 0;
-  for (const auto &i : rpo) info.block_id[i] = cur_id++;
-  // get range of iteration, skip entry block
-  auto begin = ++rpo.begin(), end = rpo.end();
-  // initialize dominance set
-  info.dom[entry].Resize(cur_id);
-  info.dom[entry].Set(0);
-  for (auto it = begin; it != end; ++it) {
-    info.dom[*it].Resize(cur_id);
-    info.dom[*it].Fill(1);
+BlockSSA *DominanceInfoPass::GetIDom(BlockSSA *block) const {
+  const auto &tree = GetDominanceInfo(block).dom;
+  auto it = tree.block_id.find(block);
+  assert(it != tree.block_id.end());
+  return it->second ? tree.blocks[tree.idom[it->second]] : nullptr;
+}
+
+const DominanceInfoPass::BlockList &DominanceInfoPass::GetDomChildren(
+    BlockSSA *block) const {
+  const auto &tree = GetDominanceInfo(block).dom;
+  auto it = tree.block_id.find(block);
+  assert(it != tree.block_id.end());
+  return tree.children[it->second];
+}
+
+const DominanceInfoPass::BlockList &DominanceInfoPass::GetDomFrontier(
+    BlockSSA *block) const {
+  const auto &tree = GetDominanceInfo(block).dom;
+  auto it = tree.block_id.find(block);
+  assert(it != tree.block_id.end());
+  return tree.frontier[it->second];
+}
+
+bool DominanceInfoPass::IsPostDominate(BlockSSA *b1, BlockSSA *b2) const {
+  assert(b1->parent() == b2->parent());
+  const auto &tree = GetDominanceInfo(b1).post_dom;
+  auto it1 = tree.block_id.find(b1), it2 = tree.block_id.find(b2);
+  if (it1 == tree.block_id.end() || it2 == tree.block_id.end()) {
+    return false;
+  }
+  auto n1 = it1->second, n2 = it2->second;
+  return tree.dfs_in[n1] <= tree.dfs_in[n2] &&
+         tree.dfs_out[n2] <= tree.dfs_out[n1];
+}
+
+BlockSSA *DominanceInfoPass::GetIPostDom(BlockSSA *block) const {
+  const auto &tree = GetDominanceInfo(block).post_dom;
+  auto it = tree.block_id.find(block);
+  if (it == tree.block_id.end()) return nullptr;
+  return tree.blocks[tree.idom[it->second]];
+}
+
+const DominanceInfoPass::BlockList &DominanceInfoPass::GetPostDomFrontier(
+    BlockSSA *block) const {
+  static const BlockList kEmptyList;
+  const auto &tree = GetDominanceInfo(block).post_dom;
+  auto it = tree.block_id.find(block);
+  if (it == tree.block_id.end()) return kEmptyList;
+  return tree.frontier[it->second];
+}
+
+void DominanceInfoPass::SolveDomTree(DomTree &tree, const BlockList &blocks,
+                                     const std::vector<std::size_t> &rpo,
+                                     const Graph &preds) {
+  auto count = rpo.size();
+  for (std::size_t i = 0; i < count; ++i) {
+    tree.block_id.insert({blocks[rpo[i]], i});
+    tree.blocks.push_back(blocks[rpo[i]]);
   }
-  // run solver
+  // get predecessors in RPO numbering
+  Graph rpo_preds(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    for (const auto &pred : preds[rpo[i]]) {
+      auto it = tree.block_id.find(blocks[pred]);
+      if (it != tree.block_id.end()) rpo_preds[i].push_back(it->second);
+    }
+  }
+  // run solver (Cooper, Harvey & Kennedy)
+  auto &idom = tree.idom;
+  idom.assign(count, kUndefNode);
+  idom[0] = 0;
   bool changed = true;
   while (changed) {
     changed = false;
-    for (auto it = begin; it != end; ++it) {
-      BitVec temp(cur_id);
-      temp.Fill(1);
-      for (const auto &pred : **it) {
-        auto pred_ptr = SSACast<BlockSSA>(pred.value().get());
-        if (IsDeadBlock(pred_ptr)) continue;
-        temp &= info.dom[pred_ptr];
+    for (std::size_t i = 1; i < count; ++i) {
+      auto new_idom = kUndefNode;
+      for (const auto &pred : rpo_preds[i]) {
+        if (idom[pred] == kUndefNode) continue;
+        new_idom = new_idom == kUndefNode
+                       ? pred
+                       : Intersect(idom, pred, new_idom);
       }
-      BitVec self_set(cur_id);
-      self_set.Set(info.block_id[*it]);
-      temp |= self_set;
-      // update dominance
-      if (temp != info.dom[*it]) {
-        info.dom[*it] = temp;
+      if (idom[i] != new_idom) {
+        idom[i] = new_idom;
         changed = true;
       }
     }
   }
+  // get children & frontiers
+  Graph children(count);
+  tree.children.resize(count);
+  tree.frontier.resize(count);
+  for (std::size_t i = 1; i < count; ++i) {
+    children[idom[i]].push_back(i);
+    tree.children[idom[i]].push_back(tree.blocks[i]);
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    if (rpo_preds[i].size() < 2) continue;
+    for (const auto &pred : rpo_preds[i]) {
+      for (auto n = pred; n != idom[i]; n = idom[n]) {
+        auto &frontier = tree.frontier[n];
+        if (!frontier.empty() && frontier.back() == tree.blocks[i]) break;
+        frontier.push_back(tree.blocks[i]);
+      }
+    }
+  }
+  // number nodes in DFS order of dominator tree
+  tree.dfs_in.resize(count);
+  tree.dfs_out.resize(count);
+  std::size_t cur_num = 0;
+  std::vector<std::pair<std::size_t, std::size_t>> nodes = {{0, 0}};
+  tree.dfs_in[0] = cur_num++;
+  while (!nodes.empty()) {
+    auto &[node, index] = nodes.back();
+    if (index < children[node].size()) {
+      auto child = children[node][index++];
+      tree.dfs_in[child] = cur_num++;
+      nodes.push_back({child, 0});
+    }
+    else {
+      tree.dfs_out[node] = cur_num++;
+      nodes.pop_back();
+    }
+  }
+}
+
+void DominanceInfoPass::SolveDominance(const FuncPtr &func) {
+  auto &info = dom_info_[func.get()];
+  // get CFG of current function
+  CFG cfg(func);
+  BlockList blocks;
+  Graph preds, succs;
+  for (std::size_t i = 0; i < cfg.size(); ++i) {
+    blocks.push_back(cfg.block(i));
+    preds.push_back(cfg.preds(i));
+    succs.push_back(cfg.succs(i));
+  }
+  // connect all exit blocks to the virtual exit node
+  // only blocks that reachable from entry should be considered
+  auto exit = blocks.size();
+  blocks.push_back(nullptr);
+  preds.emplace_back();
+  succs.emplace_back();
+  for (const auto &i : cfg.rpo()) {
+    if (succs[i].empty()) {
+      succs[i].push_back(exit);
+      preds[exit].push_back(i);
+    }
+  }
+  // solve dominator tree on CFG
+  SolveDomTree(info.dom, blocks, cfg.rpo(), preds);
+  // solve post-dominator tree on reverse CFG
+  // blocks that can not reach the exit will be ignored
+  if (!preds[exit].empty()) {
+    // ignore dead blocks
+    Graph rev_succs(blocks.size());
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+      if (i != exit && !cfg.IsReachable(i)) continue;
+      for (const auto &pred : preds[i]) {
+        if (cfg.IsReachable(pred)) rev_succs[i].push_back(pred);
+      }
+    }
+    SolveDomTree(info.post_dom, blocks, GetRPO(rev_succs, exit), succs);
+  }
 }
 
 bool DominanceInfoPass::RunOnFunction(const FuncPtr &func) {
   if (func->is_decl()) return false;
+  // discard the previous result
+  dom_info_[func.get()] = DominanceInfo();
   SolveDominance(func);
   return false;
 }
@@ -2,19 +2,22 @@
 #define MIMIC_OPT_ANALYSIS_DOMINANCE_H_
 
 #include <unordered_map>
+#include <vector>
 #include <cstddef>
 #include <cassert>
 
 #include "opt/pass.h"
-#include "utils/bitvec.h"
 
 namespace mimic::opt {
 
 /*
   this pass will analysis dominance information
+  including dominator tree, dominance frontiers and post-dominator tree
 */
 class DominanceInfoPass : public FunctionPass {
  public:
+  using BlockList = std::vector<mid::BlockSSA *>;
+
   DominanceInfoPass() {}
 
   bool RunOnFunction(const mid::FuncPtr &func) override;
@@ -25,17 +28,51 @@ class DominanceInfoPass : public FunctionPass {
 
   // check if block 'b1' dominates block 'b2'
   bool IsDominate(mid::BlockSSA *b1, mid::BlockSSA *b2) const;
+  // get immediate dominator of block, 'nullptr' if block is entry
+  mid::BlockSSA *GetIDom(mid::BlockSSA *block) const;
+  // get children of block in dominator tree
+  const BlockList &GetDomChildren(mid::BlockSSA *block) const;
+  // get dominance frontier of block
+  const BlockList &GetDomFrontier(mid::BlockSSA *block) const;
+
+  // check if block 'b1' post-dominates block 'b2'
+  // blocks that can not reach any exit are not post-dominated
+  bool IsPostDominate(mid::BlockSSA *b1, mid::BlockSSA *b2) const;
+  // get immediate post-dominator of block
+  // 'nullptr' if block is an exit or can not reach any exit
+  mid::BlockSSA *GetIPostDom(mid::BlockSSA *block) const;
+  // get post-dominance frontier of block
+  const BlockList &GetPostDomFrontier(mid::BlockSSA *block) const;
 
  private:
+  // dominator tree (or post-dominator tree)
+  // nodes are numbered in reverse post order, node 0 is the root
+  struct DomTree {
+    // id of all basic blocks in tree
+    std::unordered_map<mid::BlockSSA *, std::size_t> block_id;
+    // blocks of nodes, 'nullptr' if the node is virtual
+    BlockList blocks;
+    // immediate dominator of nodes, root's is itself
+    std::vector<std::size_t> idom;
+    // DFS entry/exit numbering of nodes in tree
+    std::vector<std::size_t> dfs_in, dfs_out;
+    // children & frontier of nodes
+    std::vector<BlockList> children, frontier;
+  };
+
   // dominance information (per function)
   struct DominanceInfo {
-    // id of all basic blocks
-    std::unordered_map<mid::BlockSSA *, std::size_t> block_id;
-    // dominance set of basic blocks
-    std::unordered_map<mid::BlockSSA *, utils::BitVec> dom;
+    DomTree dom, post_dom;
   };
 
+  using Graph = std::vector<std::vector<std::size_t>>;
+
   const DominanceInfo &GetDominanceInfo(mid::BlockSSA *block) const;
+  // solve dominator tree on graph using the algorithm of
+  // Cooper, Harvey and Kennedy, nodes in 'rpo' are in reverse post order
+  static void SolveDomTree(DomTree &tree, const BlockList &blocks,
+                           const std::vector<std::size_t> &rpo,
+                           const Graph &preds);
   void SolveDominance(const mid::FuncPtr &func);
 
   std::unordered_map<mid::User *, DominanceInfo> dom_info_;
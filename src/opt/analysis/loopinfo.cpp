@@ -20,6 +20,7 @@ REGISTER_PASS(LoopInfoPass, loop_info)
 void LoopInfoPass::ScanOn(const FuncPtr &func) {
   // scan for back edges
   auto &loops = loops_[func.get()];
+  loops.clear();
   for (const auto &i : *func) {
     auto block = SSACast<BlockSSA>(i.value().get());
     // skip dead blocks
@@ -5,13 +5,13 @@
 #include <memory>
 #include <cassert>
 
-#include "opt/pass.h"
+#include "mid/ssa.h"
 
 /*
   Runtime type checking of SSA values
 
-  This utility is implemented by using visitor pattern and template,
-  although it's deviated from the original intention of visitor pattern.
+  Each SSA value stores its kind in 'Value', so type checking
+  is just a comparison of kinds.
 */
 
 namespace mimic::opt {
@@ -24,50 +24,29 @@ namespace __impl {
   e(Alloca) e(Block) e(ArgRef) e(ConstInt) e(ConstStr) \
   e(ConstStruct) e(ConstArray) e(ConstZero) \
   e(PhiOperand) e(Phi) e(Select) e(Undef)
-// expand to enum definition
-#define EXPAND_ENUM(ssa) ssa,
-// expand to method declaration
-#define EXPAND_METHOD(ssa) void RunOn(mid::ssa##SSA &) override;
 // expand to static type checking
 #define EXPAND_TYPE_CHECKING(ssa)                        \
   else if constexpr (std::is_same_v<mid::ssa##SSA, T>) { \
-    return type_ == SSAType::ssa;                        \
+    return mid::SSAKind::ssa;                            \
   }
 
 // helper for static type checking
 template <typename ...>
 constexpr std::false_type always_false;
 
-// helper for checking type of SSA
-// NOTE: thread unsafe!
-class IsSSAHelperPass : public HelperPass {
- public:
-  template <typename T>
-  static bool Check(mid::Value *ssa) {
-    static_assert(std::is_base_of_v<mid::Value, T> &&
-                      !std::is_same_v<mid::Value, T> &&
-                      !std::is_same_v<mid::User, T>,
-                  "SSA type required");
-    type_ = SSAType::None;
-    ssa->RunPass(GetInstance());
-    if constexpr (always_false<T>) {}
-    ALL_SSA(EXPAND_TYPE_CHECKING)
-    else static_assert(always_false<T>);
-  }
-
-  ALL_SSA(EXPAND_METHOD);
-
- private:
-  // type specifier of all SSAs
-  enum class SSAType { None, ALL_SSA(EXPAND_ENUM) };
-
-  static IsSSAHelperPass &GetInstance();
-  static SSAType type_;
-};
+// get kind of the specific SSA type
+template <typename T>
+constexpr mid::SSAKind GetSSAKind() {
+  static_assert(std::is_base_of_v<mid::Value, T> &&
+                    !std::is_same_v<mid::Value, T> &&
+                    !std::is_same_v<mid::User, T>,
+                "SSA type required");
+  if constexpr (always_false<T>) {}
+  ALL_SSA(EXPAND_TYPE_CHECKING)
+  else static_assert(always_false<T>);
+}
 
 #undef ALL_SSA
-#undef EXPAND_ENUM
-#undef EXPAND_METHOD
 #undef EXPAND_TYPE_CHECKING
 
 }  // namespace __impl
@@ -75,7 +54,7 @@ class IsSSAHelperPass : public HelperPass {
 // check if value is specific type
 template <typename T>
 inline bool IsSSA(const mid::Value *ssa) {
-  return __impl::IsSSAHelperPass::Check<T>(const_cast<mid::Value *>(ssa));
+  return ssa->kind() == __impl::GetSSAKind<T>();
 }
 template <typename T>
 inline bool IsSSA(const mid::Value &ssa) {
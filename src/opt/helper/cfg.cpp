@@ -0,0 +1,96 @@
+#include "opt/helper/cfg.h"
+
+#include <utility>
+
+#include "opt/helper/cast.h"
+
+using namespace mimic::mid;
+using namespace mimic::opt;
+
+CFG::CFG(FunctionSSA *func)
+    : is_order_valid_(false), is_layout_valid_(false) {
+  if (func->empty()) return;
+  // number all blocks, the entry block first
+  auto entry = SSACast<BlockSSA>(func->entry().get());
+  AddBlock(entry);
+  for (const auto &i : *func) {
+    auto block = SSACast<BlockSSA>(i.value().get());
+    if (block != entry) AddBlock(block);
+  }
+  // scan terminators for edges
+  for (cur_id_ = 0; cur_id_ < blocks_.size(); ++cur_id_) {
+    const auto &insts = blocks_[cur_id_]->insts();
+    if (!insts.empty()) insts.back()->RunPass(*this);
+  }
+}
+
+void CFG::RunOn(BranchSSA &ssa) {
+  AddSucc(ssa.true_block());
+  AddSucc(ssa.false_block());
+}
+
+void CFG::RunOn(JumpSSA &ssa) {
+  AddSucc(ssa.target());
+}
+
+void CFG::AddSucc(const SSAPtr &block) {
+  auto id = GetId(SSACast<BlockSSA>(block.get()));
+  assert(id != kNoBlock);
+  succs_[cur_id_].push_back(id);
+  preds_[id].push_back(cur_id_);
+}
+
+void CFG::UpdateOrders() const {
+  if (is_order_valid_) return;
+  is_order_valid_ = true;
+  // get post order by DFS, visit successors in order
+  GetPostOrder(po_, false);
+  rpo_.assign(po_.rbegin(), po_.rend());
+  // mark reachable blocks
+  is_reachable_.assign(blocks_.size(), false);
+  for (const auto &i : po_) is_reachable_[i] = true;
+}
+
+void CFG::UpdateLayout() const {
+  if (is_layout_valid_) return;
+  is_layout_valid_ = true;
+  // visit successors in reverse order, so that the first successor
+  // (e.g. true block of branch) will be placed right after its
+  // predecessor in reverse post order if possible
+  IdList po;
+  GetPostOrder(po, true);
+  layout_.assign(po.rbegin(), po.rend());
+}
+
+void CFG::GetPostOrder(IdList &po, bool is_reversed) const {
+  po.clear();
+  if (blocks_.empty()) return;
+  std::vector<char> visited(blocks_.size(), false);
+  std::vector<std::pair<std::size_t, std::size_t>> nodes = {{0, 0}};
+  visited[0] = true;
+  while (!nodes.empty()) {
+    auto &[id, index] = nodes.back();
+    const auto &succs = succs_[id];
+    if (index < succs.size()) {
+      auto i = index++;
+      auto succ = succs[is_reversed ? succs.size() - 1 - i : i];
+      if (!visited[succ]) {
+        visited[succ] = true;
+        nodes.push_back({succ, 0});
+      }
+    }
+    else {
+      po.push_back(id);
+      nodes.pop_back();
+    }
+  }
+}
+
+void CFG::AddBlock(BlockSSA *block) {
+  auto ret = ids_.insert({block, blocks_.size()});
+  assert(ret.second);
+  static_cast<void>(ret);
+  blocks_.push_back(block);
+  succs_.emplace_back();
+  preds_.emplace_back();
+}
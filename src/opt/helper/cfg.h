@@ -0,0 +1,99 @@
+#ifndef MIMIC_OPT_HELPER_CFG_H_
+#define MIMIC_OPT_HELPER_CFG_H_
+
+#include <unordered_map>
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <cassert>
+
+#include "opt/pass.h"
+
+namespace mimic::opt {
+
+/*
+  snapshot of control flow graph of function
+
+  all blocks are numbered densely, and the entry block is always
+  numbered 0. successors/predecessors and orders of traversal are
+  stored in flat arrays, so traversing on CFG is much cheaper than
+  visiting terminators and using hash sets of blocks.
+*/
+class CFG : public HelperPass {
+ public:
+  using IdList = std::vector<std::size_t>;
+
+  // id of non-existent block
+  static constexpr std::size_t kNoBlock =
+      std::numeric_limits<std::size_t>::max();
+
+  CFG(const mid::FuncPtr &func) : CFG(func.get()) {}
+  CFG(mid::FunctionSSA *func);
+
+  void RunOn(mid::BranchSSA &ssa) override;
+  void RunOn(mid::JumpSSA &ssa) override;
+
+  // get id of the specific block, 'kNoBlock' if not found
+  std::size_t GetId(mid::BlockSSA *block) const {
+    auto it = ids_.find(block);
+    return it != ids_.end() ? it->second : kNoBlock;
+  }
+  // check if the specific block is reachable from entry
+  bool IsReachable(std::size_t id) const {
+    UpdateOrders();
+    return is_reachable_[id];
+  }
+
+  // getters
+  // count of blocks
+  std::size_t size() const { return blocks_.size(); }
+  mid::BlockSSA *block(std::size_t id) const { return blocks_[id]; }
+  const IdList &succs(std::size_t id) const { return succs_[id]; }
+  const IdList &preds(std::size_t id) const { return preds_[id]; }
+  // reverse post order of all reachable blocks
+  const IdList &rpo() const {
+    UpdateOrders();
+    return rpo_;
+  }
+  // post order of all reachable blocks
+  const IdList &po() const {
+    UpdateOrders();
+    return po_;
+  }
+  // layout order of all reachable blocks for code generation
+  // fall-through successors are placed after their predecessors
+  // if possible
+  const IdList &layout() const {
+    UpdateLayout();
+    return layout_;
+  }
+
+ private:
+  // add a new block without any edges
+  void AddBlock(mid::BlockSSA *block);
+  // add an edge to current block when scanning
+  void AddSucc(const mid::SSAPtr &block);
+  // calculate orders of traversal if they have not been calculated
+  void UpdateOrders() const;
+  // calculate layout order if it has not been calculated
+  void UpdateLayout() const;
+  // get post order of all reachable blocks by DFS
+  void GetPostOrder(IdList &po, bool is_reversed) const;
+
+  std::unordered_map<mid::BlockSSA *, std::size_t> ids_;
+  std::vector<mid::BlockSSA *> blocks_;
+  std::vector<IdList> succs_, preds_;
+  // current block when scanning
+  std::size_t cur_id_;
+  // orders of traversal
+  mutable bool is_order_valid_;
+  mutable IdList rpo_, po_;
+  mutable std::vector<char> is_reachable_;
+  // layout order
+  mutable bool is_layout_valid_;
+  mutable IdList layout_;
+};
+
+}  // namespace mimic::opt
+
+#endif  // MIMIC_OPT_HELPER_CFG_H_
@@ -6,6 +6,7 @@
 #include <unordered_map>
 
 #include "opt/pass.h"
+#include "mid/module.h"
 
 namespace mimic::opt {
 
@@ -107,7 +108,7 @@ class IRCopier : public HelperPass {
   // returns the pointer of newly created value
   template <typename T, typename... Args>
   inline std::shared_ptr<T> CopyFromValue(T &ssa, Args &&... args) {
-    auto val = std::make_shared<T>(std::forward<Args>(args)...);
+    auto val = mid::NewSSA<T>(std::forward<Args>(args)...);
     val->set_logger(ssa.logger());
     val->set_type(ssa.type());
     copied_vals_[&ssa] = val;
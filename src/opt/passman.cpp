@@ -1,12 +1,14 @@
 #include "opt/passman.h"
 
 #include <iomanip>
+#include <algorithm>
 #include <cassert>
 
 #include "opt/helper/cast.h"
 
 using namespace mimic::mid;
 using namespace mimic::opt;
+using namespace mimic::utils;
 
 namespace {
 
@@ -21,14 +23,7 @@ std::ostream &operator<<(std::ostream &os, PassStage stage) {
       else {
         is_first = false;
       }
-      switch (cur) {
-        case PassStage::PreOpt: os << "PreOpt"; break;
-        case PassStage::Promote: os << "Promote"; break;
-        case PassStage::Opt: os << "Opt"; break;
-        case PassStage::Demote: os << "Demote"; break;
-        case PassStage::PostOpt: os << "PostOpt"; break;
-        default:;
-      }
+      os << GetStageName(cur);
     }
   }
   return os;
@@ -47,6 +42,11 @@ PassInfo &PassInfo::Invalidates(std::string_view pass_name) {
   return *this;
 }
 
+PassInfo &PassInfo::Preserves(std::string_view pass_name) {
+  preserved_passes_.push_back(pass_name);
+  return *this;
+}
+
 PassManager::PassInfoMap &PassManager::GetPasses() {
   static PassInfoMap passes;
   return passes;
@@ -69,46 +69,154 @@ PassManager::PassPtrList PassManager::GetPasses(PassStage stage) const {
   return passes;
 }
 
-bool PassManager::RunPass(const PassPtr &pass) const {
-  bool changed = false;
-  // initialize
-  pass->Initialize();
-  // handle by pass type
+void PassManager::set_thread_count(std::size_t thread_count) {
+  if (thread_count == this->thread_count()) return;
+  workers_.clear();
+  pool_ = thread_count > 1 ? std::make_unique<ThreadPool>(thread_count)
+                           : nullptr;
+}
+
+std::size_t PassManager::GetFuncVersion(const Value *func) const {
+  auto it = func_versions_.find(func->id());
+  auto version = it != func_versions_.end() ? it->second : 0;
+  return std::max(version, module_version_);
+}
+
+std::vector<FuncPtr> PassManager::GetDirtyFuncs(
+    const PassInfo *info) const {
+  std::vector<FuncPtr> funcs;
+  auto &stamps = func_stamps_[info];
+  for (const auto &i : *funcs_) {
+    auto it = stamps.find(i->id());
+    if (it != stamps.end()) {
+      // results of analysis passes are cached until the module changes
+      // or they are discarded by transform passes
+      auto version = info->is_analysis() ? module_version_
+                                         : GetFuncVersion(i.get());
+      if (it->second >= version) continue;
+    }
+    stamps[i->id()] = version_;
+    funcs.push_back(SSACast<FunctionSSA>(i));
+  }
+  return funcs;
+}
+
+void PassManager::InvalidateAnalyses(const PassInfo *info,
+                                     const Value *func) const {
+  const auto &preserved = info->preserved_passes();
+  for (auto &&[pass, stamps] : func_stamps_) {
+    if (pass->is_analysis() &&
+        std::find(preserved.begin(), preserved.end(), pass->name()) ==
+            preserved.end()) {
+      stamps.erase(func->id());
+    }
+  }
+}
+
+bool PassManager::RunPass(const PassInfo *info) const {
+  const auto &pass = info->pass();
   if (pass->IsModulePass()) {
+    // skip if nothing changed since last run
+    auto it = module_stamps_.find(info);
+    if (it != module_stamps_.end() && it->second >= version_) return false;
+    module_stamps_[info] = version_;
     // run on global values
+    pass->Initialize();
+    bool changed = false;
     if (pass->RunOnModule(*vars_)) changed = true;
     if (pass->RunOnModule(*funcs_)) changed = true;
     pass->CleanUp();
+    // all functions may be changed
+    if (changed) module_version_ = ++version_;
+    return changed;
   }
-  else if (pass->IsFunctionPass()) {
-    // traverse all functions
-    for (const auto &i : *funcs_) {
-      auto func = SSACast<FunctionSSA>(i);
-      if (pass->RunOnFunction(func)) changed = true;
-      pass->CleanUp();
+  // get functions that need to be run on
+  auto funcs = GetDirtyFuncs(info);
+  if (funcs.empty()) return false;
+  std::vector<char> changed(funcs.size());
+  if (pool_ && info->is_func_local() && funcs.size() > 1) {
+    // run on functions concurrently
+    RunPassParallel(info, funcs, changed);
+  }
+  else {
+    // keep cached results if analysis pass only runs on some functions
+    if (!info->is_analysis() || funcs.size() == funcs_->size()) {
+      pass->Initialize();
+    }
+    for (std::size_t i = 0; i < funcs.size(); ++i) {
+      changed[i] = RunOnFunction(pass, funcs[i]);
     }
   }
+  // update versions of changed functions
+  bool ret = false;
+  for (std::size_t i = 0; i < funcs.size(); ++i) {
+    if (changed[i]) {
+      func_versions_[funcs[i]->id()] = ++version_;
+      InvalidateAnalyses(info, funcs[i].get());
+      ret = true;
+    }
+  }
+  return ret;
+}
+
+bool PassManager::RunOnFunction(const PassPtr &pass,
+                                const FuncPtr &func) const {
+  bool changed = false;
+  if (pass->IsFunctionPass()) {
+    changed = pass->RunOnFunction(func);
+    pass->CleanUp();
+  }
   else {
     assert(pass->IsBlockPass());
     // traverse all basic blocks
-    for (const auto &func : *funcs_) {
-      for (const auto &i : *func) {
-        auto blk = SSACast<BlockSSA>(i.value());
-        if (pass->RunOnBlock(blk)) changed = true;
-        pass->CleanUp();
-      }
+    for (const auto &i : *func) {
+      auto blk = SSACast<BlockSSA>(i.value());
+      if (pass->RunOnBlock(blk)) changed = true;
+      pass->CleanUp();
     }
   }
   return changed;
 }
 
+void PassManager::RunPassParallel(const PassInfo *info,
+                                  const std::vector<FuncPtr> &funcs,
+                                  std::vector<char> &changed) const {
+  // get pass instances of all workers
+  auto &workers = workers_[info];
+  while (workers.size() + 1 < pool_->thread_count()) {
+    workers.push_back(info->NewInstance());
+  }
+  // run on all functions
+  std::vector<char> inited(pool_->thread_count());
+  pool_->ParallelFor(funcs.size(), [&](std::size_t id, std::size_t i) {
+    const auto &pass = id ? workers[id - 1] : info->pass();
+    if (!inited[id]) {
+      pass->Initialize();
+      inited[id] = true;
+    }
+    changed[i] = RunOnFunction(pass, funcs[i]);
+  });
+}
+
 bool PassManager::RunPass(PassNameSet &valid, const PassInfo *info) const {
   bool changed = false;
   if (!valid.insert(info->name()).second) return changed;
   // check dependencies, run required passes first
   if (RunRequiredPasses(valid, info)) changed = true;
   // run current pass
-  if (RunPass(info->pass())) {
+  bool pass_changed;
+  if (time_report_) {
+    Timer timer;
+    timer.Start();
+    pass_changed = RunPass(info);
+    timer.Stop();
+    time_report_->AddTime(report_group_, info->name(), timer.elapsed(),
+                          pass_changed);
+  }
+  else {
+    pass_changed = RunPass(info);
+  }
+  if (pass_changed) {
     changed = true;
     // invalidate passes
     for (const auto &name : info->invalidated_passes()) {
@@ -155,22 +263,34 @@ void PassManager::InvalidatePass(PassNameSet &valid,
 void PassManager::RunPasses(const PassPtrList &passes) const {
   bool changed = true;
   PassNameSet valid;
+  std::size_t iterations = 0;
   // run until nothing changes
   while (changed) {
     changed = false;
+    ++iterations;
     valid.clear();
     // traverse all passes
     for (const auto &info : passes) {
       changed |= RunPass(valid, info);
     }
   }
+  if (time_report_) time_report_->AddIterations(report_group_, iterations);
 }
 
 void PassManager::RunPasses() const {
+  // reset versions, all functions are dirty at first
+  version_ = 0;
+  module_version_ = 0;
+  func_versions_.clear();
+  func_stamps_.clear();
+  module_stamps_.clear();
   // traverse all stages
   for (auto i = kFirstPassStage; i <= stage_; ++i) {
     // get passes in current stage
     auto passes = GetPasses(i);
+    report_group_ = "passes (";
+    report_group_ += GetStageName(i);
+    report_group_ += ')';
     // run on current stage
     RunPasses(passes);
   }
@@ -7,6 +7,7 @@
 #include <memory>
 #include <ostream>
 #include <map>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <cstddef>
@@ -14,6 +15,8 @@
 #include "opt/pass.h"
 #include "opt/stage.h"
 #include "mid/usedef.h"
+#include "utils/threadpool.h"
+#include "utils/timereport.h"
 
 namespace mimic::opt {
 
@@ -21,10 +24,15 @@ namespace mimic::opt {
 class PassInfo {
  public:
   using PassNameList = std::vector<std::string_view>;
+  using PassFactory = PassPtr (*)();
 
-  PassInfo(PassPtr pass, std::string_view name)
-      : pass_(std::move(pass)), name_(name), is_analysis_(false),
-        min_opt_level_(0), stages_(PassStage::None) {}
+  PassInfo(PassFactory factory, std::string_view name)
+      : pass_(factory()), factory_(factory), name_(name),
+        is_analysis_(false), is_func_local_(false), min_opt_level_(0),
+        stages_(PassStage::None) {}
+
+  // create a new instance of current pass
+  PassPtr NewInstance() const { return factory_(); }
 
   // add required pass by name for current pass
   // all required passes should be run before running current pass
@@ -34,12 +42,25 @@ class PassInfo {
   // all invalidated passes should be run again after running current pass
   PassInfo &Invalidates(std::string_view pass_name);
 
+  // add preserved analysis pass by name for current pass
+  // results of preserved analysis passes on functions modified by
+  // current pass will not be discarded
+  PassInfo &Preserves(std::string_view pass_name);
+
   // setters
   // set if current pass is an analysis pass
   PassInfo &set_is_analysis(bool is_analysis) {
     is_analysis_ = is_analysis;
     return *this;
   }
+  // set if current pass is function-local
+  // function-local passes only modify the function/block they are
+  // running on, and never inspect use lists of global values
+  // so they can run on multiple functions concurrently
+  PassInfo &set_is_func_local(bool is_func_local) {
+    is_func_local_ = is_func_local;
+    return *this;
+  }
   // set minimum optimization level of current pass required
   PassInfo &set_min_opt_level(std::size_t min_opt_level) {
     min_opt_level_ = min_opt_level;
@@ -55,26 +76,33 @@ class PassInfo {
   const PassPtr &pass() const { return pass_; }
   std::string_view name() const { return name_; }
   bool is_analysis() const { return is_analysis_; }
+  bool is_func_local() const { return is_func_local_; }
   std::size_t min_opt_level() const { return min_opt_level_; }
   PassStage stages() const { return stages_; }
   const PassNameList &required_passes() const { return required_passes_; }
   const PassNameList &invalidated_passes() const {
     return invalidated_passes_;
   }
+  const PassNameList &preserved_passes() const { return preserved_passes_; }
 
  private:
   PassPtr pass_;
+  PassFactory factory_;
   std::string_view name_;
-  bool is_analysis_;
+  bool is_analysis_, is_func_local_;
   std::size_t min_opt_level_;
   PassStage stages_;
-  PassNameList required_passes_, invalidated_passes_;
+  PassNameList required_passes_, invalidated_passes_, preserved_passes_;
 };
 
 // pass manager for all SSA IR passes
 class PassManager {
  public:
-  PassManager() : opt_level_(0), stage_(kLastPassStage) {}
+  PassManager()
+      : opt_level_(0), stage_(kLastPassStage), version_(0),
+        module_version_(0), time_report_(nullptr) {}
+  PassManager(const PassManager &) = delete;
+  PassManager &operator=(const PassManager &) = delete;
 
   // register a new pass
   template <typename T>
@@ -83,8 +111,8 @@ class PassManager {
                   "helper pass is unregisterable");
     auto &passes = GetPasses();
     assert(!passes.count(name) && "pass has already been registered");
-    return passes.insert({name, PassInfo(std::make_unique<T>(), name)})
-        .first->second;
+    auto factory = []() -> PassPtr { return std::make_unique<T>(); };
+    return passes.insert({name, PassInfo(factory, name)}).first->second;
   }
 
   // update 'required by' relationship
@@ -111,10 +139,19 @@ class PassManager {
   void set_stage(PassStage stage) { stage_ = stage; }
   void set_vars(mid::UserPtrList *vars) { vars_ = vars; }
   void set_funcs(mid::UserPtrList *funcs) { funcs_ = funcs; }
+  // set count of threads for running function-local passes
+  void set_thread_count(std::size_t thread_count);
+  // set time report for recording time of passes, 'nullptr' to disable
+  void set_time_report(utils::TimeReport *time_report) {
+    time_report_ = time_report;
+  }
 
   // getters
   std::size_t opt_level() const { return opt_level_; }
   bool is_stage_last() const { return stage_ == kLastPassStage; }
+  std::size_t thread_count() const {
+    return pool_ ? pool_->thread_count() : 1;
+  }
 
  private:
   using PassInfoMap = std::map<std::string_view, PassInfo>;
@@ -128,8 +165,24 @@ class PassManager {
   static RequirementMap &GetRequiredBy();
   // get passes in specific stage
   PassPtrList GetPasses(PassStage stage) const;
+  // get modification version of the specific function
+  std::size_t GetFuncVersion(const mid::Value *func) const;
+  // get functions that have been changed since the specific pass
+  // last ran on them, and mark them as visited by the pass
+  std::vector<mid::FuncPtr> GetDirtyFuncs(const PassInfo *info) const;
+  // discard cached results of analysis passes on the specific function
+  // except the analysis passes preserved by the specific pass
+  void InvalidateAnalyses(const PassInfo *info,
+                          const mid::Value *func) const;
   // run a specific pass, returns true if changed
-  bool RunPass(const PassPtr &pass) const;
+  bool RunPass(const PassInfo *info) const;
+  // run a function/block pass on a function, returns true if changed
+  bool RunOnFunction(const PassPtr &pass, const mid::FuncPtr &func) const;
+  // run a specific function-local pass on functions concurrently
+  // changed flag of each function will be stored in 'changed'
+  void RunPassParallel(const PassInfo *info,
+                       const std::vector<mid::FuncPtr> &funcs,
+                       std::vector<char> &changed) const;
   // run a specific pass if it's not valid
   // returns true if changed
   bool RunPass(PassNameSet &valid, const PassInfo *info) const;
@@ -143,6 +196,26 @@ class PassManager {
   std::size_t opt_level_;
   PassStage stage_;
   mid::UserPtrList *vars_, *funcs_;
+  // current modification version, increased when anything changes
+  mutable std::size_t version_;
+  // version of the last module pass that changed the module
+  mutable std::size_t module_version_;
+  // versions of changed functions, keyed by value id
+  mutable std::unordered_map<std::size_t, std::size_t> func_versions_;
+  // versions when passes last ran on functions/module
+  // for analysis passes, these are also versions of cached results
+  mutable std::unordered_map<const PassInfo *,
+                             std::unordered_map<std::size_t, std::size_t>>
+      func_stamps_;
+  mutable std::unordered_map<const PassInfo *, std::size_t> module_stamps_;
+  // time report, and report group of current stage
+  utils::TimeReport *time_report_;
+  mutable std::string report_group_;
+  // thread pool for running function-local passes
+  std::unique_ptr<utils::ThreadPool> pool_;
+  // pass instances of worker threads, except the first worker
+  mutable std::unordered_map<const PassInfo *, std::vector<PassPtr>>
+      workers_;
 };
 
 // register a pass
@@ -5,7 +5,7 @@
 #include "opt/pass.h"
 #include "opt/passman.h"
 #include "opt/helper/cast.h"
-#include "opt/helper/blkiter.h"
+#include "opt/helper/cfg.h"
 #include "opt/helper/inst.h"
 
 using namespace mimic::mid;
@@ -53,14 +53,15 @@ class AggressiveDeadCodeElimPass : public FunctionPass {
 // register current pass
 REGISTER_PASS(AggressiveDeadCodeElimPass, adce)
     .set_min_opt_level(1)
+    .set_is_func_local(true)
     .set_stages(PassStage::Opt);
 
 
 void AggressiveDeadCodeElimPass::Mark(FunctionSSA *func) {
   // traverse all blocks to find critical instructions
-  auto entry = SSACast<BlockSSA>(func->entry().get());
-  for (const auto &block : BFSTraverse(entry)) {
-    for (const auto &i : block->insts()) {
+  CFG cfg(func);
+  for (const auto &id : cfg.rpo()) {
+    for (const auto &i : cfg.block(id)->insts()) {
       if (IsInstCritical(i)) {
         // mark as undead
         auto inst = InstCast(i.get());
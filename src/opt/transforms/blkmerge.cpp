@@ -69,9 +69,9 @@ class BlockMergePass : public FunctionPass {
     if (merge_flag_) {
       // remove the last jump
       ssa.insts().pop_back();
-      // insert instructions from target block
-      ssa.insts().insert(ssa.insts().end(), target_->insts().begin(),
-                         target_->insts().end());
+      // move instructions from target block
+      ssa.insts().splice(ssa.insts().end(), target_->insts(),
+                         target_->insts().begin(), target_->insts().end());
     }
   }
 
@@ -92,5 +92,6 @@ class BlockMergePass : public FunctionPass {
 // register current passs
 REGISTER_PASS(BlockMergePass, blk_merge)
     .set_min_opt_level(1)
+    .set_is_func_local(true)
     .set_stages(PassStage::PreOpt | PassStage::Opt | PassStage::PostOpt)
     .Invalidates("dom_info");
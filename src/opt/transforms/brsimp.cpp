@@ -3,6 +3,7 @@
 #include "opt/pass.h"
 #include "opt/passman.h"
 #include "opt/helper/cast.h"
+#include "mid/module.h"
 
 using namespace mimic::mid;
 using namespace mimic::opt;
@@ -28,10 +29,10 @@ class BranchSimplifyPass : public BlockPass {
     // if can be replaced
     if (replace_) {
       // create jump instruction
-      auto jump = std::make_shared<JumpSSA>(target_);
+      auto jump = NewSSA<JumpSSA>(target_);
       jump->set_logger(block->insts().back()->logger());
       // replace last instruction with jump
-      block->insts().back() = jump;
+      block->insts().replace(--block->insts().end(), jump);
     }
     return replace_;
   }
@@ -125,4 +126,5 @@ class BranchSimplifyPass : public BlockPass {
 // register current pass
 REGISTER_PASS(BranchSimplifyPass, branch_simp)
     .set_min_opt_level(1)
+    .set_is_func_local(true)
     .set_stages(PassStage::PreOpt | PassStage::Opt | PassStage::PostOpt);
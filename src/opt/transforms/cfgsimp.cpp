@@ -1,4 +1,5 @@
 #include <unordered_set>
+#include <vector>
 
 #include "opt/pass.h"
 #include "opt/passman.h"
@@ -21,13 +22,16 @@ class BlockMergeHelperPass : public HelperPass {
       i->RunPass(*this);
       if (is_phi_) return false;
     }
-    // get new predecessor set
-    std::unordered_set<SSAPtr> preds;
+    // get new predecessor list, without duplicates
+    std::unordered_set<SSAPtr> pred_set;
+    std::vector<SSAPtr> preds;
     for (const auto &i : *target) {
-      if (i.value().get() != cur) preds.insert(i.value());
+      if (i.value().get() != cur && pred_set.insert(i.value()).second) {
+        preds.push_back(i.value());
+      }
     }
     for (const auto &i : *cur) {
-      preds.insert(i.value());
+      if (pred_set.insert(i.value()).second) preds.push_back(i.value());
     }
     // apply new predecessors to target block
     target->Clear();
@@ -128,7 +132,7 @@ class CFGSimplifyPass : public FunctionPass {
       }
       // remove current block from all users except parent function
       BlockElimHelperPass helper(&ssa);
-      auto uses = ssa.uses();
+      std::vector<Use *> uses(ssa.uses().begin(), ssa.uses().end());
       for (const auto &i : uses) i->user()->RunPass(helper);
       // mark current block as removed
       ssa.ClearInst();
@@ -171,5 +175,6 @@ class CFGSimplifyPass : public FunctionPass {
 // register current passs
 REGISTER_PASS(CFGSimplifyPass, cfg_simplify)
     .set_min_opt_level(1)
+    .set_is_func_local(true)
     .set_stages(PassStage::PreOpt | PassStage::Opt | PassStage::PostOpt)
     .Invalidates("dom_info");
@@ -77,4 +77,6 @@ class DeadCodeEliminationPass : public BlockPass {
 // register current pass
 REGISTER_PASS(DeadCodeEliminationPass, dead_code_elim)
     .set_min_opt_level(0)
-    .set_stages(PassStage::PreOpt | PassStage::Opt | PassStage::PostOpt);
+    .set_is_func_local(true)
+    .set_stages(PassStage::PreOpt | PassStage::Opt | PassStage::PostOpt)
+    .Preserves("dom_info");
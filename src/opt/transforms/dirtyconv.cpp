@@ -53,8 +53,7 @@ class DirtyConversionPass : public ModulePass {
       auto name = "_sysy_"s + std::string(name_);
       TypePtrList args = {MakePrimType(PrimType::Type::Int32, false)};
       auto ret = MakePrimType(PrimType::Type::Void, false);
-      auto type = std::make_shared<FuncType>(std::move(args),
-                                             std::move(ret), false);
+      auto type = MakeFunc(args, ret, false);
       decl = mod.CreateFunction(LinkageTypes::External, name,
                                 std::move(type));
     }
@@ -27,8 +27,7 @@ class DeadStoreEliminationPass : public BlockPass {
     }
     // remove all dead stores
     for (const auto &store : dead_stores_) {
-      block->insts().remove_if(
-          [store](const SSAPtr &i) { return i.get() == store; });
+      block->insts().remove(store);
     }
     return !dead_stores_.empty();
   }
@@ -106,4 +105,5 @@ class DeadStoreEliminationPass : public BlockPass {
 REGISTER_PASS(DeadStoreEliminationPass, dse)
     .set_min_opt_level(2)
     .set_stages(PassStage::Opt)
-    .Requires("store_comb");
+    .Requires("store_comb")
+    .Preserves("dom_info");
@@ -11,7 +11,7 @@
 #include "opt/pass.h"
 #include "opt/passman.h"
 #include "opt/helper/cast.h"
-#include "opt/helper/blkiter.h"
+#include "opt/helper/cfg.h"
 #include "mid/module.h"
 #include "utils/hashing.h"
 
@@ -49,7 +49,7 @@ class Expression {
 
   std::size_t GetHash() const {
     using namespace mimic::utils;
-    return HashCombine(opcode_, type_->GetTypeId(),
+    return HashCombine(opcode_, type_->hash(),
                        HashCombineRange(oprs_.begin(), oprs_.end()));
   }
 
@@ -142,9 +142,9 @@ class GlobalValueNumberingPass : public FunctionPass {
     if (func->is_decl()) return false;
     changed_ = false;
     // traverse all blocks in RPO
-    auto entry = SSACast<BlockSSA>(func->entry().get());
-    for (const auto &i : RPOTraverse(entry)) {
-      i->RunPass(*this);
+    CFG cfg(func);
+    for (const auto &i : cfg.rpo()) {
+      cfg.block(i)->RunPass(*this);
     }
     // process created phi nodes
     ProcessPhi();
@@ -238,11 +238,13 @@ class GlobalValueNumberingPass : public FunctionPass {
 // register current pass
 REGISTER_PASS(GlobalValueNumberingPass, gvn)
     .set_min_opt_level(2)
+    .set_is_func_local(true)
     .set_stages(PassStage::Opt)
     .Requires("adce")
     .Requires("inliner")
     .Requires("naive_unroll")
-    .Invalidates("loop_info");
+    .Invalidates("loop_info")
+    .Preserves("dom_info");
 
 
 /*
@@ -549,8 +551,7 @@ void GlobalValueNumberingPass::ProcessPhi() {
   // place all remaining phi nodes into the block where they are
   for (const auto &pi : phis) {
     pi.inst.val->ReplaceBy(pi.phi);
-    pi.inst.parent->insts().remove_if(
-        [&pi](const SSAPtr &i) { return i.get() == pi.inst.val; });
+    pi.inst.parent->insts().remove(pi.inst.val);
     pi.block->insts().push_front(pi.phi);
     if (!changed_) changed_ = true;
   }
@@ -587,7 +588,7 @@ SSAPtr GlobalValueNumberingPass::ReadValueRecursive(LocalDefs &defs,
   }
   else {
     // create an empty phi node
-    auto phi = std::make_shared<PhiSSA>(SSAPtrList());
+    auto phi = NewSSA<PhiSSA>(SSAPtrList());
     phi->set_type(inst.val->type());
     phi->set_logger(inst.val->logger());
     // remember it
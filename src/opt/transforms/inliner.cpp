@@ -39,19 +39,20 @@ class BlockSplitterHelperPass : public HelperPass {
  public:
   // divide the block into two from pos, instruction on pos will be removed
   // NOTE: this method will not add terminator to current block
-  void SplitBlock(BlockSSA *block, SSAPtrList::iterator pos) {
+  void SplitBlock(BlockSSA *block, InstList::iterator pos) {
     cur_ = block;
     auto &insts = block->insts();
     assert(pos != insts.end() && *pos != insts.back());
     // create new block
     auto mod = MakeModule(block->logger());
     blk_ = mod.CreateBlock(block->parent(), block->name() + ".split");
-    // copy instructions after pos to new block
-    blk_->insts().insert(blk_->insts().end(), ++pos, insts.end());
+    // move instructions after pos to new block
+    blk_->insts().splice(blk_->insts().end(), insts, std::next(pos),
+                         insts.end());
     // handle terminator, update successor's predecessor
-    insts.back()->RunPass(*this);
-    // remove instructions from pos to then end
-    insts.erase(--pos, insts.end());
+    blk_->insts().back()->RunPass(*this);
+    // remove instruction on pos
+    insts.erase(pos);
   }
 
   void RunOn(BranchSSA &ssa) override {
@@ -60,8 +60,7 @@ class InstCombinePass : public FunctionPass {
     auto it = parent_.find(inst.get());
     // TODO: is this safe? fixme
     if (it == parent_.end()) return;
-    it->second->insts().remove_if(
-        [&inst](const SSAPtr &i) { return i == inst; });
+    it->second->insts().remove(inst);
     parent_.erase(it);
   }
 
@@ -86,8 +85,7 @@ class InstCombinePass : public FunctionPass {
   void InsertNewInstBefore(const UserPtr &new_inst, const UserPtr &old) {
     assert(new_inst);
     auto &insts = parent_[old.get()]->insts();
-    auto it = std::find(insts.begin(), insts.end(), old);
-    insts.insert(it, new_inst);
+    insts.insert(insts.find(old), new_inst);
     parent_[new_inst.get()] = parent_[old.get()];
     worklist_.push_back(new_inst);
   }
@@ -152,9 +150,7 @@ class InstCombinePass : public FunctionPass {
             temp_bin = SSACast<BinarySSA>(temp_bin->lhs());
           }
           // get the position of 'last_use'
-          auto it = std::find_if(
-              insts.begin(), insts.end(),
-              [last_use](const SSAPtr &v) { return v.get() == last_use; });
+          auto it = insts.find(last_use);
           // Loop over all of the instructions in other blocks, moving
           // them into the current one.
           auto temp_bin2 = temp_bin;
@@ -180,8 +176,8 @@ class InstCombinePass : public FunctionPass {
         root.ReplaceBy(temp_bin);     // Users now use temp_bin
         temp_bin->set_rhs(root_ptr);  // temp_bin now uses the root
         insts.remove(root_ptr);       // Remove root from the BB
-        auto it = std::find(insts.begin(), insts.end(), temp_bin);
-        insts.insert(it, root_ptr);   // Insert root before temp_bin
+        // Insert root before temp_bin
+        insts.insert(insts.find(temp_bin), root_ptr);
         // Now propagate the 'extra_operand' down the chain of instructions
         // until we get to 'bin'.
         while (temp_bin.get() != bin) {
@@ -551,8 +547,10 @@ struct FoldCmpLogical {
 // register current pass
 REGISTER_PASS(InstCombinePass, inst_comb)
     .set_min_opt_level(1)
+    .set_is_func_local(true)
     .set_stages(PassStage::Opt)
-    .Invalidates("loop_info");
+    .Invalidates("loop_info")
+    .Preserves("dom_info");
 
 // This performs a few simplifications for commutative
 // operators:
@@ -1520,8 +1518,7 @@ bool InstCombinePass::RunOnFunction(const FuncPtr &func) {
         RemoveFromWorklist(inst);
         // insert new instruction into block
         auto &insts = parent_[inst.get()]->insts();
-        auto it = std::find(insts.begin(), insts.end(), inst);
-        *it = result_;
+        insts.replace(insts.find(inst), result_);
         parent_[result_.get()] = parent_[inst.get()];
         // replace with new instruction
         inst->ReplaceBy(result_);
@@ -86,11 +86,13 @@ class LoopInvariantCodeMotionPass : public FunctionPass {
 // register current pass
 REGISTER_PASS(LoopInvariantCodeMotionPass, licm)
     .set_min_opt_level(2)
+    .set_is_func_local(true)
     .set_stages(PassStage::Opt)
     .Requires("dom_info")
     .Requires("loop_info")
     .Requires("loop_norm")
-    .Requires("loop_reduce");
+    .Requires("loop_reduce")
+    .Preserves("dom_info");
 
 
 // check if value is an invariant
@@ -181,10 +183,15 @@ bool LoopInvariantCodeMotionPass::ProcessLoop() {
   // scan all invariants
   marked_invs_.clear();
   invs_.clear();
+  auto func = SSACast<FunctionSSA>(cur_loop_->entry->parent().get());
   std::size_t last_size = 1;
   while (marked_invs_.size() != last_size) {
     last_size = marked_invs_.size();
-    for (const auto &block : cur_loop_->body) {
+    // traverse blocks of loop in order of function, so that the order of
+    // invariants does not depend on addresses of blocks
+    for (const auto &i : *func) {
+      auto block = SSACast<BlockSSA>(i.value().get());
+      if (!cur_loop_->body.count(block)) continue;
       cur_block_ = block;
       for (const auto &i : block->insts()) {
         if (!marked_invs_.count(i.get())) i->RunPass(*this);
@@ -192,15 +199,10 @@ bool LoopInvariantCodeMotionPass::ProcessLoop() {
     }
   }
   if (invs_.empty()) return false;
-  // insert invariant instructions to preheader
+  // move invariant instructions to preheader
   auto block = cur_loop_->preheader;
   assert(block);
   auto pos = --block->insts().end();
   block->insts().insert(pos, invs_.begin(), invs_.end());
-  // remove invariant instructions from their parent
-  for (const auto &i : invs_) {
-    auto parent = parent_->GetParent(i.get());
-    parent->insts().remove(i);
-  }
   return true;
 }
@@ -30,7 +30,7 @@ class ConstArrayCopyier : public IRCopier {
   }
 
   void RunOn(ConstIntSSA &ssa) override {
-    auto cint = std::make_shared<ConstIntSSA>(ssa.value());
+    auto cint = NewSSA<ConstIntSSA>(ssa.value());
     cint->set_logger(ssa.logger());
     cint->set_type(ssa.type());
     AddCopiedValue(&ssa, cint);
@@ -72,8 +72,7 @@ class LocalArrayPromotionPass : public ModulePass {
       // handle removed stores
       if (!removed_stores_.empty()) {
         for (const auto &store : removed_stores_) {
-          entry->insts().remove_if(
-              [store](const SSAPtr &i) { return i.get() == store; });
+          entry->insts().remove(store);
         }
         removed_stores_.clear();
         // updated 'changed' flag
@@ -33,8 +33,7 @@ class CreateMemSetPass : public ModulePass {
     auto ptr_ty = MakePointer(MakeVoid(), false);
     auto int_ty = MakePrimType(PrimType::Type::Int32, false);
     TypePtrList args = {ptr_ty, int_ty, int_ty};
-    auto func_ty = std::make_shared<FuncType>(std::move(args),
-                                              std::move(ptr_ty), false);
+    auto func_ty = MakeFunc(args, ptr_ty, false);
     auto decl = mod.CreateFunction(LinkageTypes::External,
                                    "memset", func_ty);
     // insert into global values
@@ -45,10 +44,11 @@ class CreateMemSetPass : public ModulePass {
   }
 
   // getters
-  const FuncPtr &memset_decl() const { return memset_decl_; }
+  FuncPtr memset_decl() const { return memset_decl_.lock(); }
 
  private:
-  FuncPtr memset_decl_;
+  // declaration is owned by module, do not keep it alive
+  std::weak_ptr<FunctionSSA> memset_decl_;
 };
 
 // register helper pass
@@ -180,13 +180,13 @@ bool LoopConversionPass::RunOnLoop(const LoopInfo &loop) {
   auto entry = SSACast<BlockSSA>(loop.entry->GetPointer());
   auto mod = MakeModule(loop.entry->logger(), entry);
   const auto &cm = PassManager::GetPass<CreateMemSetPass>("create_memset");
-  const auto &callee = cm.memset_decl();
+  auto callee = cm.memset_decl();
   auto size_val = mod.GetInt(type_size, count->type());
   auto size_cal = mod.CreateMul(count, size_val);
   SSAPtrList args = {std::move(ptr), std::move(zero), std::move(size_cal)};
   mod.CreateCall(callee, std::move(args));
   // insert jump instruction
-  auto jump = std::make_shared<JumpSSA>(loop.exit_block->GetPointer());
+  auto jump = NewSSA<JumpSSA>(loop.exit_block->GetPointer());
   jump->set_logger(loop.entry->logger());
   loop.entry->insts().push_back(std::move(jump));
   return true;
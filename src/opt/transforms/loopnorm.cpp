@@ -81,7 +81,7 @@ void LoopNormalizePass::CreatePreheader(const LoopInfo &loop) {
   }
   // create jump to loop entry
   const auto &entry_ptr = loop.entry->GetPointer();
-  auto jump = std::make_shared<JumpSSA>(entry_ptr);
+  auto jump = NewSSA<JumpSSA>(entry_ptr);
   jump->set_logger(loop.entry->logger());
   preheader_->insts().push_back(std::move(jump));
   // reroute phi nodes in loop header
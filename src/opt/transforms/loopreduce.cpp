@@ -91,7 +91,8 @@ void LoopStrengthReductionPass::RunOnLoop(const LoopInfo &loop) {
   if (!CheckLoop(loop)) return;
   // traverse all users of induction variable
   cur_loop_ = &loop;
-  auto uses = loop.ind_var->uses();
+  const auto &ind_uses = loop.ind_var->uses();
+  std::vector<Use *> uses(ind_uses.begin(), ind_uses.end());
   for (const auto &i : uses) {
     auto block = parent_->GetParent(i->user());
     if (loop.body.count(block)) {
@@ -135,8 +136,7 @@ void LoopStrengthReductionPass::RunOn(AccessSSA &ssa) {
   phi->AddValue(mod.CreatePhiOperand(acc_mod, tail));
   // replace current access
   ssa.ReplaceBy(phi);
-  parent_->GetParent(&ssa)->insts().remove_if(
-      [&ssa](const SSAPtr &i) { return i.get() == &ssa; });
+  parent_->GetParent(&ssa)->insts().remove(&ssa);
   // mark as changed
   changed_ = true;
 }
@@ -7,7 +7,7 @@
 #include "opt/passman.h"
 #include "mid/module.h"
 #include "opt/helper/cast.h"
-#include "opt/helper/blkiter.h"
+#include "opt/helper/cfg.h"
 
 using namespace mimic::mid;
 using namespace mimic::opt;
@@ -71,8 +71,9 @@ class MemToRegPass : public FunctionPass {
     auto entry = SSACast<BlockSSA>(func->entry().get());
     if (!prom_helper_.ScanAlloca(entry)) return false;
     // traverse all blocks
-    for (const auto &i : RPOTraverse(entry)) {
-      i->RunPass(*this);
+    CFG cfg(func);
+    for (const auto &i : cfg.rpo()) {
+      cfg.block(i)->RunPass(*this);
     }
     // handle created phi nodes
     while (!created_phis_.empty()) {
@@ -176,13 +177,15 @@ class MemToRegPass : public FunctionPass {
 // register current pass
 REGISTER_PASS(MemToRegPass, mem2reg)
     .set_min_opt_level(1)
-    .set_stages(PassStage::Promote);
+    .set_is_func_local(true)
+    .set_stages(PassStage::Promote)
+    .Preserves("dom_info");
 
 
 // create an empty phi node, use alloca's type & logger
 UserPtr MemToRegPass::CreatePhi(const SSAPtr &alloca, BlockSSA *block) {
   // create phi node
-  auto phi = std::make_shared<PhiSSA>(SSAPtrList());
+  auto phi = NewSSA<PhiSSA>(SSAPtrList());
   phi->set_type(alloca->type()->GetDerefedType());
   phi->set_logger(alloca->logger());
   // remember it
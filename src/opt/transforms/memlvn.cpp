@@ -141,4 +141,5 @@ class MemLVNPass : public FunctionPass {
 // register current pass
 REGISTER_PASS(MemLVNPass, mem_lvn)
     .set_min_opt_level(1)
-    .set_stages(PassStage::PostOpt);
+    .set_stages(PassStage::PostOpt)
+    .Preserves("dom_info");
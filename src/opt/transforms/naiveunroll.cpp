@@ -208,11 +208,11 @@ class LoopUnrollerHelperPass : public IRCopier {
     // check if branch can be simplified
     if (auto cint = ConstantHelper::Fold(cond)) {
       // create a jump
-      inst = std::make_shared<JumpSSA>(GetCopy(cint->value() ? tb : fb));
+      inst = NewSSA<JumpSSA>(GetCopy(cint->value() ? tb : fb));
     }
     else {
       // create a branch
-      inst = std::make_shared<BranchSSA>(cond, GetCopy(tb), GetCopy(fb));
+      inst = NewSSA<BranchSSA>(cond, GetCopy(tb), GetCopy(fb));
     }
     inst->set_logger(ssa.logger());
     AddCopiedValue(&ssa, inst);
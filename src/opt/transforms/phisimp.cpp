@@ -74,4 +74,6 @@ class PhiSimplifyPass : public BlockPass {
 // register current pass
 REGISTER_PASS(PhiSimplifyPass, phi_simp)
     .set_min_opt_level(1)
-    .set_stages(PassStage::Promote);
+    .set_is_func_local(true)
+    .set_stages(PassStage::Promote)
+    .Preserves("dom_info");
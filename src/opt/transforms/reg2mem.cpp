@@ -1,6 +1,5 @@
 #include <list>
 #include <unordered_map>
-#include <algorithm>
 #include <cassert>
 
 #include "opt/pass.h"
@@ -44,13 +43,13 @@ class CriticalEdgeBreakerHelperPass : public HelperPass {
       terminator->RunPass(*this);
       if (has_serveral_succs_) {
         // create new target block
-        auto block = std::make_shared<BlockSSA>(nullptr, "");
+        auto block = NewSSA<BlockSSA>(nullptr, "");
         block->AddValue(pred);
         block->set_logger(ssa.logger());
         new_blocks_.push_back(block);
         target_ = block;
         // create jump instruction to current block
-        auto jump = std::make_shared<JumpSSA>(cur_block_);
+        auto jump = NewSSA<JumpSSA>(cur_block_);
         jump->set_logger(ssa.logger());
         block->AddInst(jump);
         // replace target of branch instruction to new target
@@ -208,7 +207,7 @@ class RegToMemPass : public FunctionPass {
  private:
   struct InsertPoint {
     BlockPtr block;
-    SSAPtrList::iterator pos;
+    InstList::iterator pos;
   };
 
   InsertPoint GetInsertPoint(Value *inst);
@@ -234,12 +233,9 @@ RegToMemPass::InsertPoint RegToMemPass::GetInsertPoint(Value *inst) {
   auto block = insts_->GetParent(inst);
   auto block_ptr = SSACast<BlockSSA>(block->GetPointer());
   // find current instruction
-  SSAPtrList::iterator it;
+  InstList::iterator it;
   for (;;) {
-    it = std::find_if(block->insts().begin(), block->insts().end(),
-                      [inst](const SSAPtr &ptr) {
-                        return ptr.get() == inst;
-                      });
+    it = block->insts().find(inst);
     if (it != block->insts().end()) break;
     // 'inst' is a sub-instruction if not found
     assert(inst->uses().size() == 1);
@@ -1,4 +1,5 @@
 #include <unordered_map>
+#include <vector>
 #include <cassert>
 
 #include "opt/pass.h"
@@ -37,8 +38,7 @@ class StoreCombiningPass : public BlockPass {
     CheckAndEmit(insts, --insts.end());
     // remove marked stores
     for (const auto &store : removed_stores_) {
-      block->insts().remove_if(
-          [store](const SSAPtr &i) { return i.get() == store; });
+      block->insts().remove(store);
     }
     return !removed_stores_.empty();
   }
@@ -46,18 +46,19 @@ class StoreCombiningPass : public BlockPass {
   void CleanUp() override {
     removed_stores_.clear();
     arrays_.clear();
+    array_ptrs_.clear();
   }
 
  private:
   using ArrayVal = std::unordered_map<std::size_t, SSAPtr>;
-  using SSAIt = SSAPtrList::iterator;
+  using SSAIt = InstList::iterator;
 
   struct ArrayInfo {
     ArrayVal elems;
     std::vector<StoreSSA *> stores;
   };
 
-  SSAIt HandleStores(SSAPtrList &insts, SSAIt pos, StoreSSA &store) {
+  SSAIt HandleStores(InstList &insts, SSAIt pos, StoreSSA &store) {
     // handle constant stores only
     if (!store.value()->IsConst()) return CheckAndEmit(insts, pos);
     // handle if pointer is an access instruction
@@ -80,7 +81,9 @@ class StoreCombiningPass : public BlockPass {
     assert(acc->index()->type()->IsInteger());
     auto index = ConstantHelper::Fold(acc->index())->value();
     // update array info
-    auto &info = arrays_[acc->ptr()];
+    auto [it, succ] = arrays_.insert({acc->ptr(), {}});
+    if (succ) array_ptrs_.push_back(acc->ptr());
+    auto &info = it->second;
     info.elems[index] = store.value();
     info.stores.push_back(&store);
     return ++pos;
@@ -102,8 +105,9 @@ class StoreCombiningPass : public BlockPass {
   }
 
   // check all tracked arrays, emit if possible
-  SSAIt CheckAndEmit(SSAPtrList &insts, SSAIt pos) {
-    for (const auto &[ptr, info] : arrays_) {
+  SSAIt CheckAndEmit(InstList &insts, SSAIt pos) {
+    for (const auto &ptr : array_ptrs_) {
+      const auto &info = arrays_[ptr];
       auto arr_ty = ptr->type()->GetDerefedType();
       auto arr_len = arr_ty->GetLength();
       if (info.elems.size() == arr_len) {
@@ -131,6 +135,7 @@ class StoreCombiningPass : public BlockPass {
       }
     }
     arrays_.clear();
+    array_ptrs_.clear();
     return ++pos;
   }
 
@@ -138,6 +143,8 @@ class StoreCombiningPass : public BlockPass {
   std::vector<StoreSSA *> removed_stores_;
   // value of tracked arrays
   std::unordered_map<SSAPtr, ArrayInfo> arrays_;
+  // pointers of tracked arrays, in order of tracking
+  std::vector<SSAPtr> array_ptrs_;
 };
 
 }  // namespace
@@ -147,4 +154,5 @@ class StoreCombiningPass : public BlockPass {
 REGISTER_PASS(StoreCombiningPass, store_comb)
     .set_min_opt_level(2)
     .set_stages(PassStage::Opt)
-    .Requires("gvn");
+    .Requires("gvn")
+    .Preserves("dom_info");
@@ -40,4 +40,6 @@ class UndefPropagationPass : public BlockPass {
 // register current pass
 REGISTER_PASS(UndefPropagationPass, undef_prop)
     .set_min_opt_level(1)
-    .set_stages(PassStage::Opt);
+    .set_is_func_local(true)
+    .set_stages(PassStage::Opt)
+    .Preserves("dom_info");
@@ -0,0 +1,70 @@
+#ifndef MIMIC_UTILS_ARENA_H_
+#define MIMIC_UTILS_ARENA_H_
+
+#include <memory>
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+namespace mimic::utils {
+
+// bump pointer memory arena
+// all memory allocated by arena will be freed in one shot
+// when the arena is destructed
+// NOTE: thread unsafe!
+class Arena {
+ public:
+  Arena() : cur_(0), end_(0), size_(0) {}
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  // allocate a memory block with specific size and alignment
+  void *Allocate(std::size_t size, std::size_t align) {
+    auto ptr = AlignUp(cur_, align);
+    if (!cur_ || ptr + size > end_) return AllocateSlow(size, align);
+    cur_ = ptr + size;
+    size_ += size;
+    return reinterpret_cast<void *>(ptr);
+  }
+
+  // getters
+  // total bytes allocated from current arena
+  std::size_t size() const { return size_; }
+  // count of chunks owned by current arena
+  std::size_t chunk_count() const { return chunks_.size(); }
+
+ private:
+  // default size of a chunk
+  static constexpr std::size_t kChunkSize = 64 * 1024;
+  // allocations larger than this will use a dedicated chunk
+  static constexpr std::size_t kLargeSize = kChunkSize / 4;
+
+  static std::uintptr_t AlignUp(std::uintptr_t ptr, std::size_t align) {
+    return (ptr + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+  }
+
+  // allocate a new chunk, and then allocate memory from it
+  void *AllocateSlow(std::size_t size, std::size_t align) {
+    auto chunk_size = size + align;
+    if (chunk_size <= kLargeSize) chunk_size = kChunkSize;
+    chunks_.push_back(std::make_unique<char[]>(chunk_size));
+    auto begin = reinterpret_cast<std::uintptr_t>(chunks_.back().get());
+    auto ptr = AlignUp(begin, align);
+    // do not switch to dedicated chunk
+    if (chunk_size == kChunkSize || !cur_) {
+      cur_ = ptr + size;
+      end_ = begin + chunk_size;
+    }
+    size_ += size;
+    return reinterpret_cast<void *>(ptr);
+  }
+
+  std::uintptr_t cur_, end_;
+  std::size_t size_;
+  std::vector<std::unique_ptr<char[]>> chunks_;
+};
+
+}  // namespace mimic::utils
+
+#endif  // MIMIC_UTILS_ARENA_H_
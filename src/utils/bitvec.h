@@ -40,6 +40,24 @@ class BitVec {
   // check if current bit vector is empty
   bool Empty() const { return !width_; }
 
+  // check if any bit is set
+  bool Any() const {
+    for (std::size_t i = 0; i < vec_.size(); ++i) {
+      if (GetWord(i)) return true;
+    }
+    return false;
+  }
+
+  // call 'func' with the index of each set bit in ascending order
+  template <typename Func>
+  void ForEach(Func func) const {
+    for (std::size_t i = 0; i < vec_.size(); ++i) {
+      for (auto word = GetWord(i); word; word &= word - 1) {
+        func(i * 64 + CountTrailingZeros(word));
+      }
+    }
+  }
+
   // set the bit width to a specific value
   void Resize(std::size_t width) {
     vec_.resize((width + 63) / 64);
@@ -151,6 +169,23 @@ class BitVec {
   std::size_t width() const { return width_; }
 
  private:
+  // get the specific word, bits beyond the width are masked
+  std::uint64_t GetWord(std::size_t i) const {
+    if (i + 1 < vec_.size() || !(width_ % 64)) return vec_[i];
+    return vec_[i] & ((static_cast<std::uint64_t>(1) << (width_ % 64)) - 1);
+  }
+
+  // count trailing zero bits of a non-zero word
+  static std::size_t CountTrailingZeros(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    std::size_t count = 0;
+    for (; !(word & 1); word >>= 1) ++count;
+    return count;
+#endif
+  }
+
   std::vector<std::uint64_t> vec_;
   std::size_t width_;
 };
@@ -0,0 +1,75 @@
+#ifndef MIMIC_UTILS_MMAP_H_
+#define MIMIC_UTILS_MMAP_H_
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace mimic::utils {
+
+// read-only memory-mapped file
+// the content will be unmapped when the object is destructed
+class MappedFile {
+ public:
+  MappedFile() : data_(nullptr), size_(0), valid_(false) {}
+  MappedFile(const std::string &file) : MappedFile() { Open(file); }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile() { Close(); }
+
+  // map the specific file into memory, returns false if failed
+  bool Open(const std::string &file) {
+    Close();
+    auto fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+      close(fd);
+      return false;
+    }
+    size_ = st.st_size;
+    // empty file can not be mapped
+    if (size_) {
+      auto ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (ptr == MAP_FAILED) {
+        close(fd);
+        size_ = 0;
+        return false;
+      }
+      data_ = static_cast<const char *>(ptr);
+      madvise(ptr, size_, MADV_SEQUENTIAL);
+    }
+    // mapping will be kept after closing file descriptor
+    close(fd);
+    valid_ = true;
+    return true;
+  }
+
+  // unmap current file
+  void Close() {
+    if (data_) munmap(const_cast<char *>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+    valid_ = false;
+  }
+
+  // getters
+  bool valid() const { return valid_; }
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  std::string_view content() const { return {data_, size_}; }
+
+ private:
+  const char *data_;
+  std::size_t size_;
+  bool valid_;
+};
+
+}  // namespace mimic::utils
+
+#endif  // MIMIC_UTILS_MMAP_H_
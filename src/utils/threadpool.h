@@ -0,0 +1,109 @@
+#ifndef MIMIC_UTILS_THREADPOOL_H_
+#define MIMIC_UTILS_THREADPOOL_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+
+namespace mimic::utils {
+
+// fixed-size thread pool for running parallel loops
+// the calling thread also works as a worker while running a loop
+class ThreadPool {
+ public:
+  // create a pool with 'thread_count' workers (including the caller)
+  explicit ThreadPool(std::size_t thread_count)
+      : stop_(false), generation_(0), running_(0) {
+    for (std::size_t i = 1; i < thread_count; ++i) {
+      threads_.emplace_back([this, i] { WorkerMain(i); });
+    }
+  }
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &i : threads_) i.join();
+  }
+
+  // call 'func(worker_id, index)' for all indices in [0, count)
+  // returns after all calls have finished
+  // NOTE: thread unsafe, only one loop can be running at the same time
+  void ParallelFor(std::size_t count,
+                   std::function<void(std::size_t, std::size_t)> func) {
+    if (threads_.empty() || count <= 1) {
+      for (std::size_t i = 0; i < count; ++i) func(0, i);
+      return;
+    }
+    // publish the loop
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      func_ = std::move(func);
+      count_ = count;
+      next_index_ = 0;
+      running_ = threads_.size();
+      ++generation_;
+    }
+    start_cv_.notify_all();
+    // run on the current thread
+    RunLoop(0);
+    // wait for other workers
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return !running_; });
+    func_ = nullptr;
+  }
+
+  // getters
+  // count of workers, including the caller
+  std::size_t thread_count() const { return threads_.size() + 1; }
+
+ private:
+  void WorkerMain(std::size_t worker_id) {
+    std::size_t last_gen = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_cv_.wait(lock, [&] {
+          return stop_ || generation_ != last_gen;
+        });
+        if (stop_) return;
+        last_gen = generation_;
+      }
+      RunLoop(worker_id);
+      // notify the caller
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!--running_) done_cv_.notify_one();
+    }
+  }
+
+  // fetch indices and run the loop body until all indices are taken
+  void RunLoop(std::size_t worker_id) {
+    for (;;) {
+      auto index = next_index_.fetch_add(1, std::memory_order_relaxed);
+      if (index >= count_) break;
+      func_(worker_id, index);
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_, done_cv_;
+  bool stop_;
+  std::size_t generation_, running_;
+  // current loop
+  std::function<void(std::size_t, std::size_t)> func_;
+  std::size_t count_;
+  std::atomic<std::size_t> next_index_;
+};
+
+}  // namespace mimic::utils
+
+#endif  // MIMIC_UTILS_THREADPOOL_H_
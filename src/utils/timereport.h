@@ -0,0 +1,173 @@
+#ifndef MIMIC_UTILS_TIMEREPORT_H_
+#define MIMIC_UTILS_TIMEREPORT_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstddef>
+
+#include "utils/strprint.h"
+
+namespace mimic::utils {
+
+// accumulative wall clock timer
+class Timer {
+ public:
+  Timer() : elapsed_(Clock::duration::zero()) {}
+
+  // start timing
+  void Start() { start_ = Clock::now(); }
+  // stop timing, and add the elapsed time to total time
+  void Stop() { elapsed_ += Clock::now() - start_; }
+  // clear total time
+  void Reset() { elapsed_ = Clock::duration::zero(); }
+
+  // getters
+  // total elapsed time in seconds
+  double elapsed() const {
+    return std::chrono::duration<double>(elapsed_).count();
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  Clock::time_point start_;
+  Clock::duration elapsed_;
+};
+
+// report of time and statistics of compiler phases/passes
+// items are grouped, groups and items are kept in insertion order
+class TimeReport {
+ public:
+  TimeReport() {}
+
+  // add a run of the specific item
+  void AddTime(std::string_view group, std::string_view name,
+               double time) {
+    auto &item = GetItem(group, name);
+    item.time += time;
+    ++item.count;
+  }
+  // add a run of the specific item with its 'changed' flag
+  void AddTime(std::string_view group, std::string_view name, double time,
+               bool changed) {
+    auto &item = GetItem(group, name);
+    item.time += time;
+    ++item.count;
+    item.track_changed = true;
+    if (changed) ++item.changed;
+  }
+  // add iterations to the specific group
+  void AddIterations(std::string_view group, std::size_t iterations) {
+    GetGroup(group).iterations += iterations;
+  }
+
+  // dump human-readable report
+  void Dump(std::ostream &os) const {
+    os << "time report:" << std::endl;
+    for (const auto &group : groups_) {
+      // get total time of group
+      double total = 0;
+      for (const auto &i : group.items) total += i.time;
+      os << std::endl << "  " << group.name << ": ";
+      DumpTime(os, total);
+      if (group.iterations) {
+        os << ", " << group.iterations << " iteration(s)";
+      }
+      os << std::endl;
+      // dump items, in descending order of time
+      std::vector<const Item *> items;
+      for (const auto &i : group.items) items.push_back(&i);
+      std::stable_sort(items.begin(), items.end(),
+                       [](const Item *l, const Item *r) {
+                         return l->time > r->time;
+                       });
+      for (const auto &i : items) {
+        os << "    " << std::setw(28) << std::left << i->name
+           << std::right << std::setw(10);
+        DumpTime(os, i->time);
+        os << std::setw(7) << std::fixed << std::setprecision(1)
+           << (total > 0 ? i->time / total * 100 : 0) << "%";
+        os.unsetf(std::ios_base::floatfield);
+        os << std::setw(8) << i->count << " run(s)";
+        if (i->track_changed) {
+          os << std::setw(8) << i->changed << " changed";
+        }
+        os << std::endl;
+      }
+    }
+  }
+
+  // dump report in JSON
+  void DumpJSON(std::ostream &os) const {
+    os << "{\"groups\":[";
+    for (std::size_t i = 0; i < groups_.size(); ++i) {
+      const auto &group = groups_[i];
+      if (i) os << ',';
+      os << "{\"name\":\"";
+      DumpStr(os, group.name);
+      os << "\",\"iterations\":" << group.iterations << ",\"items\":[";
+      for (std::size_t j = 0; j < group.items.size(); ++j) {
+        const auto &item = group.items[j];
+        if (j) os << ',';
+        os << "{\"name\":\"";
+        DumpStr(os, item.name);
+        os << "\",\"time\":" << std::setprecision(9) << item.time
+           << ",\"count\":" << item.count;
+        if (item.track_changed) os << ",\"changed\":" << item.changed;
+        os << '}';
+      }
+      os << "]}";
+    }
+    os << "]}" << std::endl;
+  }
+
+  // getters
+  bool empty() const { return groups_.empty(); }
+
+ private:
+  struct Item {
+    std::string name;
+    double time;
+    std::size_t count, changed;
+    bool track_changed;
+  };
+
+  struct Group {
+    std::string name;
+    std::size_t iterations;
+    std::vector<Item> items;
+  };
+
+  static void DumpTime(std::ostream &os, double time) {
+    os << std::fixed << std::setprecision(3) << time * 1000 << "ms";
+    os.unsetf(std::ios_base::floatfield);
+  }
+
+  Group &GetGroup(std::string_view name) {
+    for (auto &i : groups_) {
+      if (i.name == name) return i;
+    }
+    groups_.push_back({std::string(name), 0, {}});
+    return groups_.back();
+  }
+
+  Item &GetItem(std::string_view group, std::string_view name) {
+    auto &items = GetGroup(group).items;
+    for (auto &i : items) {
+      if (i.name == name) return i;
+    }
+    items.push_back({std::string(name), 0, 0, 0, false});
+    return items.back();
+  }
+
+  std::vector<Group> groups_;
+};
+
+}  // namespace mimic::utils
+
+#endif  // MIMIC_UTILS_TIMEREPORT_H_
@@ -0,0 +1,53 @@
+#!/bin/sh
+# usage: bad_ir.sh <mmcc> <source file>
+# dump textual IR of the source file, break it in several ways, and
+# check that the compiler rejects the malformed IR with an error
+# instead of accepting it or crashing in the later passes
+
+mmcc=$1
+src=$2
+tmp=$(mktemp -d) || exit 1
+trap 'rm -rf "$tmp"' EXIT
+
+# check if the IR is rejected when it is read by the compiler
+check_rejected() {
+  name=$1
+  if cmp -s "$tmp/ir.ir" "$tmp/bad.ir"; then
+    echo "$name: IR was not modified"
+    exit 1
+  fi
+  for args in "-di" "-O2 -S"; do
+    "$mmcc" -ir $args "$tmp/bad.ir" -o "$tmp/out" 2> "$tmp/err"
+    ret=$?
+    # exit codes greater than 128 mean killed by signals
+    if [ "$ret" -gt 128 ]; then
+      echo "$name: crashed (exit code $ret) with '$args'"
+      exit 1
+    fi
+    if [ "$ret" -eq 0 ] || [ ! -s "$tmp/err" ]; then
+      echo "$name: accepted with '$args'"
+      exit 1
+    fi
+  done
+}
+
+"$mmcc" -di "$src" -o "$tmp/ir.ir" || exit 1
+"$mmcc" -ir -O2 -S "$tmp/ir.ir" -o "$tmp/out" || exit 1
+
+# terminators in the middle of blocks
+sed -e '/^  jump /p' -e '/^  return /p' "$tmp/ir.ir" > "$tmp/bad.ir"
+check_rejected "duplicated terminator"
+sed -e '/^  jump /d' -e '/^  return /d' "$tmp/ir.ir" > "$tmp/bad.ir"
+check_rejected "missing terminator"
+
+# operands and results with mismatched types
+sed -e 's/\(= add i32 .*\)constant i32 /\1constant i8 /' \
+    "$tmp/ir.ir" > "$tmp/bad.ir"
+check_rejected "mismatched operand"
+sed -e 's/= sub i32 /= sub i8 /' "$tmp/ir.ir" > "$tmp/bad.ir"
+check_rejected "mismatched result"
+sed -e 's/^\(  %[0-9]* = load \)i32/\1i8/' "$tmp/ir.ir" > "$tmp/bad.ir"
+check_rejected "mismatched load"
+sed -e 's/^  return i32 \(.*\)/  return i8 \1/' -e 's/i32 arg 0/i8 arg 0/' \
+    "$tmp/ir.ir" > "$tmp/bad.ir"
+check_rejected "mismatched argument"
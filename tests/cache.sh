@@ -0,0 +1,36 @@
+#!/bin/sh
+# usage: cache.sh <mmcc> <source file>
+# compile the source file concurrently with a shared compilation cache,
+# and check that statistics of the cache count every compilation
+
+mmcc=$1
+src=$2
+tmp=$(mktemp -d) || exit 1
+trap 'rm -rf "$tmp"' EXIT
+
+count=16
+i=0
+while [ "$i" -lt "$count" ]; do
+  "$mmcc" -S -fcache-dir "$tmp/cache" "$src" -o "$tmp/out.$i" &
+  i=$((i + 1))
+done
+wait
+
+# the last compilation must hit the cache
+"$mmcc" -S -fcache-dir "$tmp/cache" -fcache-stats "$src" \
+    -o "$tmp/out" 2> "$tmp/stats" || exit 1
+cat "$tmp/stats"
+grep -q "^cache hit" "$tmp/stats" || exit 1
+hits=$(sed -n 's/^ *hits: \([0-9]*\),.*/\1/p' "$tmp/stats")
+misses=$(sed -n 's/.*misses: \([0-9]*\).*/\1/p' "$tmp/stats")
+if [ "$((hits + misses))" -ne "$((count + 1))" ]; then
+  echo "expected $((count + 1)) compilations in statistics"
+  exit 1
+fi
+
+# all outputs must be identical
+i=0
+while [ "$i" -lt "$count" ]; do
+  cmp -s "$tmp/out" "$tmp/out.$i" || exit 1
+  i=$((i + 1))
+done
@@ -0,0 +1,38 @@
+#!/bin/sh
+# usage: corrupt_ir.sh <mmcc> <source file>
+# dump binary IR of the source file, corrupt each byte of the IR,
+# and check that the compiler never crashes when reading the corrupted
+# IR, the IR reader only checks the structure of IR, so corrupted IR
+# is dumped instead of being passed to the backends
+
+mmcc=$1
+src=$2
+tmp=$(mktemp -d) || exit 1
+trap 'rm -rf "$tmp"' EXIT
+
+"$mmcc" -dib "$src" -o "$tmp/ir.dib" || exit 1
+size=$(wc -c < "$tmp/ir.dib")
+rejected=0
+pos=0
+while [ "$pos" -lt "$size" ]; do
+  byte=$(od -An -tu1 -j "$pos" -N1 "$tmp/ir.dib" | tr -d ' ')
+  for value in 0 1 2 $((byte ^ 1)); do
+    [ "$value" -eq "$byte" ] && continue
+    cp "$tmp/ir.dib" "$tmp/bad.dib"
+    printf "\\$(printf '%03o' "$value")" |
+        dd of="$tmp/bad.dib" bs=1 seek="$pos" conv=notrunc 2>/dev/null
+    "$mmcc" -di "$tmp/bad.dib" -o "$tmp/out.ir" 2>/dev/null
+    ret=$?
+    # exit codes greater than 128 mean killed by signals
+    if [ "$ret" -gt 128 ]; then
+      echo "crashed (exit code $ret) when byte $pos is $value"
+      exit 1
+    fi
+    [ "$ret" -ne 0 ] && rejected=$((rejected + 1))
+  done
+  pos=$((pos + 1))
+done
+
+# at least some of the corrupted files should be rejected
+echo "$rejected corrupted files rejected"
+[ "$rejected" -gt 0 ]
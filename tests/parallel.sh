@@ -0,0 +1,20 @@
+#!/bin/sh
+# usage: parallel.sh <mmcc> <source file>
+# compile the source file with optimizations several times, using one
+# thread and multiple threads, and check that all outputs are identical
+
+mmcc=$1
+src=$2
+tmp=$(mktemp -d) || exit 1
+trap 'rm -rf "$tmp"' EXIT
+
+for args in "-di" "-S" "-S -ta riscv32"; do
+  "$mmcc" -O2 -j 1 $args "$src" -o "$tmp/ref.out" || exit 1
+  for jobs in 1 2 4 4 4 4 8; do
+    "$mmcc" -O2 -j "$jobs" $args "$src" -o "$tmp/out" || exit 1
+    if ! cmp -s "$tmp/ref.out" "$tmp/out"; then
+      echo "output of '-j $jobs $args' differs from '-j 1 $args'"
+      exit 1
+    fi
+  done
+done